@@ -19,6 +19,14 @@
 
 #include "../Misc/Util.h"
 #include "AnalogFilter.h"
+#include "FastMath.h"
+#include "SIMD.h"
+
+#if defined(ZYN_SIMD_SSE2)
+#include <emmintrin.h>
+#elif defined(ZYN_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 
 const float MAX_FREQ = 20000.0f;
@@ -62,6 +70,7 @@ void AnalogFilter::cleanup()
         history[i].y1 = 0.0f;
         history[i].y2 = 0.0f;
         oldHistory[i] = history[i];
+        rhistory[i]   = history[i];
     }
 }
 
@@ -94,8 +103,8 @@ AnalogFilter::Coeff AnalogFilter::computeCoeff(int type, float cutoff, float q,
         tmpq    = q;
         tmpgain = gain;
     } else {
-        tmpq    = (q > 1.0f) ? powf(q, 1.0f / (stages + 1)) : q;
-        tmpgain = powf(gain, 1.0f / (stages + 1));
+        tmpq    = (q > 1.0f) ? fast_pow(q, 1.0f / (stages + 1)) : q;
+        tmpgain = fast_pow(gain, 1.0f / (stages + 1));
     }
 
     //Alias Terms
@@ -104,7 +113,7 @@ AnalogFilter::Coeff AnalogFilter::computeCoeff(int type, float cutoff, float q,
 
     //General Constants
     const float omega = 2 * PI * freq / samplerate_f;
-    const float sn    = sinf(omega), cs = cosf(omega);
+    const float sn    = fast_sin(omega), cs = fast_cos(omega);
     float       alpha, beta;
 
     //most of these are implementations of
@@ -117,7 +126,7 @@ AnalogFilter::Coeff AnalogFilter::computeCoeff(int type, float cutoff, float q,
     switch(type) {
         case 0: //LPF 1 pole
             if(!zerocoefs)
-                tmp = expf(-2.0f * PI * freq / samplerate_f);
+                tmp = fast_exp(-2.0f * PI * freq / samplerate_f);
             else
                 tmp = 0.0f;
             c[0]  = 1.0f - tmp;
@@ -129,7 +138,7 @@ AnalogFilter::Coeff AnalogFilter::computeCoeff(int type, float cutoff, float q,
             break;
         case 1: //HPF 1 pole
             if(!zerocoefs)
-                tmp = expf(-2.0f * PI * freq / samplerate_f);
+                tmp = fast_exp(-2.0f * PI * freq / samplerate_f);
             else
                 tmp = 0.0f;
             c[0]  = (1.0f + tmp) / 2.0f;
@@ -389,24 +398,13 @@ void AnalogFilter::singlefilterout(float *smp, fstage &hist)
 }
 
 void AnalogFilter::singlefilterout_freqbuf(float *smp, fstage &hist,
-                                   float *freqbuf)
+                                           const Coeff *steps)
 {
     assert((buffersize % 8) == 0);
 
-    float frequency = -1.0f;
-
     for ( int i = 0; i < buffersize; i += 8 )
     {
-        /* recompute coeffs for each 8 samples */
-
-        const float f = ceilf(freqbuf[i] * MAX_FREQ);
-
-        if ( fabsf( f - frequency ) >= 1.0f )
-        {
-            /* don't perform computation more often than necessary */
-            computefiltercoefs(f,q);
-            frequency = f;
-        }
+        const Coeff &coeff = steps[i / 8];
 
         if(order == 1) {  //First order filter
             for ( int j = 0; j < 8; j++ )
@@ -437,19 +435,40 @@ void AnalogFilter::singlefilterout_freqbuf(float *smp, fstage &hist,
             hist.y2 = work[3];
         }
     }
+}
+
+void AnalogFilter::computesteps(const float *freqbuf, Coeff *steps)
+{
+    const int n = buffersize / 8;
+    float f[n];
+    for(int k = 0; k < n; ++k)
+        f[k] = ceilf(freqbuf[k] * MAX_FREQ);
+
+    float frequency = -1.0f;
+    for(int k = 0; k < n; ++k) {
+        /* don't perform computation more often than necessary */
+        if(fabsf(f[k] - frequency) >= 1.0f) {
+            computefiltercoefs(f[k], q);
+            frequency = f[k];
+        }
+        steps[k] = coeff;
+    }
 
+    coeff     = steps[n - 1];
     recompute = true;
 }
 
 void AnalogFilter::filterout(float *smp)
 {
-    float freqbuf[buffersize];
+    float freqbuf[buffersize / 8];
 
-    if ( freq_smoothing.apply( freqbuf, buffersize, freq * MAX_FREQ_CO ) )
+    if ( freq_smoothing.apply_every8( freqbuf, buffersize, freq * MAX_FREQ_CO ) )
     {
         /* in transition, need to do fine grained interpolation */
+        Coeff steps[buffersize / 8];
+        computesteps(freqbuf, steps);
         for(int i = 0; i < stages + 1; ++i)
-            singlefilterout_freqbuf(smp, history[i], freqbuf);
+            singlefilterout_freqbuf(smp, history[i], steps);
     }
     else
     {
@@ -462,6 +481,239 @@ void AnalogFilter::filterout(float *smp)
         smp[i] *= outgain;
 }
 
+/*
+ * Stereo filtering
+ *
+ * Both channels are interleaved, so every sample pair fits into the lanes
+ * of one vector and all stages are applied to it before moving on to the
+ * next one. The sums are evaluated in the order of the mono code, so each
+ * channel gets the same result as a separate instance would produce.
+ */
+
+//History of one stage, left channel in lane 0 and right channel in lane 1
+struct StereoStage {
+    float x1[2], x2[2];
+    float y1[2], y2[2];
+};
+
+#if defined(ZYN_SIMD_SSE2)
+static inline __m128 loadPair(const float *p)
+{
+    return _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)p);
+}
+
+static inline void storePair(float *p, __m128 v)
+{
+    _mm_storel_pi((__m64 *)p, v);
+}
+
+static void stereoStages(const AnalogFilter::Coeff &coeff, int order,
+                         StereoStage *st, int nstages, float *lr, int n)
+{
+    const __m128 c0 = _mm_set1_ps(coeff.c[0]);
+    const __m128 c1 = _mm_set1_ps(coeff.c[1]);
+    const __m128 c2 = _mm_set1_ps(coeff.c[2]);
+    const __m128 d1 = _mm_set1_ps(coeff.d[1]);
+    const __m128 d2 = _mm_set1_ps(coeff.d[2]);
+    __m128 x1[MAX_FILTER_STAGES + 1], x2[MAX_FILTER_STAGES + 1];
+    __m128 y1[MAX_FILTER_STAGES + 1], y2[MAX_FILTER_STAGES + 1];
+    for(int s = 0; s < nstages; ++s) {
+        x1[s] = loadPair(st[s].x1);
+        x2[s] = loadPair(st[s].x2);
+        y1[s] = loadPair(st[s].y1);
+        y2[s] = loadPair(st[s].y2);
+    }
+
+    if(order == 1) {
+        for(int i = 0; i < n; ++i) {
+            __m128 x = loadPair(lr + 2 * i);
+            for(int s = 0; s < nstages; ++s) {
+                const __m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, c0),
+                                                       _mm_mul_ps(x1[s], c1)),
+                                            _mm_mul_ps(y1[s], d1));
+                x1[s] = x;
+                y1[s] = y;
+                x     = y;
+            }
+            storePair(lr + 2 * i, x);
+        }
+    } else if(order == 2) {
+        for(int i = 0; i < n; ++i) {
+            __m128 x = loadPair(lr + 2 * i);
+            for(int s = 0; s < nstages; ++s) {
+                __m128 y = _mm_add_ps(_mm_mul_ps(x, c0), _mm_mul_ps(x1[s], c1));
+                y = _mm_add_ps(y, _mm_mul_ps(x2[s], c2));
+                y = _mm_add_ps(y, _mm_mul_ps(y1[s], d1));
+                y = _mm_add_ps(y, _mm_mul_ps(y2[s], d2));
+                x2[s] = x1[s];
+                x1[s] = x;
+                y2[s] = y1[s];
+                y1[s] = y;
+                x     = y;
+            }
+            storePair(lr + 2 * i, x);
+        }
+    }
+
+    for(int s = 0; s < nstages; ++s) {
+        storePair(st[s].x1, x1[s]);
+        storePair(st[s].x2, x2[s]);
+        storePair(st[s].y1, y1[s]);
+        storePair(st[s].y2, y2[s]);
+    }
+}
+#elif defined(ZYN_SIMD_NEON)
+static void stereoStages(const AnalogFilter::Coeff &coeff, int order,
+                         StereoStage *st, int nstages, float *lr, int n)
+{
+    const float32x2_t c0 = vdup_n_f32(coeff.c[0]);
+    const float32x2_t c1 = vdup_n_f32(coeff.c[1]);
+    const float32x2_t c2 = vdup_n_f32(coeff.c[2]);
+    const float32x2_t d1 = vdup_n_f32(coeff.d[1]);
+    const float32x2_t d2 = vdup_n_f32(coeff.d[2]);
+    float32x2_t x1[MAX_FILTER_STAGES + 1], x2[MAX_FILTER_STAGES + 1];
+    float32x2_t y1[MAX_FILTER_STAGES + 1], y2[MAX_FILTER_STAGES + 1];
+    for(int s = 0; s < nstages; ++s) {
+        x1[s] = vld1_f32(st[s].x1);
+        x2[s] = vld1_f32(st[s].x2);
+        y1[s] = vld1_f32(st[s].y1);
+        y2[s] = vld1_f32(st[s].y2);
+    }
+
+    if(order == 1) {
+        for(int i = 0; i < n; ++i) {
+            float32x2_t x = vld1_f32(lr + 2 * i);
+            for(int s = 0; s < nstages; ++s) {
+                const float32x2_t y = vadd_f32(vadd_f32(vmul_f32(x, c0),
+                                                        vmul_f32(x1[s], c1)),
+                                               vmul_f32(y1[s], d1));
+                x1[s] = x;
+                y1[s] = y;
+                x     = y;
+            }
+            vst1_f32(lr + 2 * i, x);
+        }
+    } else if(order == 2) {
+        for(int i = 0; i < n; ++i) {
+            float32x2_t x = vld1_f32(lr + 2 * i);
+            for(int s = 0; s < nstages; ++s) {
+                float32x2_t y = vadd_f32(vmul_f32(x, c0), vmul_f32(x1[s], c1));
+                y = vadd_f32(y, vmul_f32(x2[s], c2));
+                y = vadd_f32(y, vmul_f32(y1[s], d1));
+                y = vadd_f32(y, vmul_f32(y2[s], d2));
+                x2[s] = x1[s];
+                x1[s] = x;
+                y2[s] = y1[s];
+                y1[s] = y;
+                x     = y;
+            }
+            vst1_f32(lr + 2 * i, x);
+        }
+    }
+
+    for(int s = 0; s < nstages; ++s) {
+        vst1_f32(st[s].x1, x1[s]);
+        vst1_f32(st[s].x2, x2[s]);
+        vst1_f32(st[s].y1, y1[s]);
+        vst1_f32(st[s].y2, y2[s]);
+    }
+}
+#else
+static void stereoStages(const AnalogFilter::Coeff &coeff, int order,
+                         StereoStage *st, int nstages, float *lr, int n)
+{
+    for(int i = 0; i < n; ++i)
+        for(int c = 0; c < 2; ++c) {
+            float x = lr[2 * i + c];
+            for(int s = 0; s < nstages; ++s) {
+                StereoStage &h = st[s];
+                float y;
+                if(order == 1)
+                    y = x * coeff.c[0] + h.x1[c] * coeff.c[1]
+                        + h.y1[c] * coeff.d[1];
+                else if(order == 2)
+                    y = x * coeff.c[0] + h.x1[c] * coeff.c[1]
+                        + h.x2[c] * coeff.c[2] + h.y1[c] * coeff.d[1]
+                        + h.y2[c] * coeff.d[2];
+                else
+                    break;
+                h.x2[c] = h.x1[c];
+                h.x1[c] = x;
+                h.y2[c] = h.y1[c];
+                h.y1[c] = y;
+                x       = y;
+            }
+            lr[2 * i + c] = x;
+        }
+}
+#endif
+
+void AnalogFilter::stereofilterout(float *lr, int n)
+{
+    StereoStage st[MAX_FILTER_STAGES + 1];
+    for(int s = 0; s < stages + 1; ++s) {
+        st[s].x1[0] = history[s].x1;
+        st[s].x2[0] = history[s].x2;
+        st[s].y1[0] = history[s].y1;
+        st[s].y2[0] = history[s].y2;
+        st[s].x1[1] = rhistory[s].x1;
+        st[s].x2[1] = rhistory[s].x2;
+        st[s].y1[1] = rhistory[s].y1;
+        st[s].y2[1] = rhistory[s].y2;
+    }
+
+    stereoStages(coeff, order, st, stages + 1, lr, n);
+
+    //first order filters leave x2/y2 untouched, as the mono version does
+    for(int s = 0; s < stages + 1; ++s) {
+        history[s].x1  = st[s].x1[0];
+        history[s].y1  = st[s].y1[0];
+        rhistory[s].x1 = st[s].x1[1];
+        rhistory[s].y1 = st[s].y1[1];
+        if(order == 2) {
+            history[s].x2  = st[s].x2[0];
+            history[s].y2  = st[s].y2[0];
+            rhistory[s].x2 = st[s].x2[1];
+            rhistory[s].y2 = st[s].y2[1];
+        }
+    }
+}
+
+void AnalogFilter::filterout(float *l, float *r)
+{
+    assert((buffersize % 8) == 0);
+
+    float freqbuf[buffersize / 8];
+    float lr[2 * buffersize];
+    for(int i = 0; i < buffersize; ++i) {
+        lr[2 * i]     = l[i];
+        lr[2 * i + 1] = r[i];
+    }
+
+    if ( freq_smoothing.apply_every8( freqbuf, buffersize, freq * MAX_FREQ_CO ) )
+    {
+        Coeff steps[buffersize / 8];
+        computesteps(freqbuf, steps);
+        for(int i = 0; i < buffersize; i += 8) {
+            coeff = steps[i / 8];
+            stereofilterout(lr + 2 * i, 8);
+        }
+    }
+    else
+    {
+        if(recompute) {
+            computefiltercoefs(freq, q);
+            recompute = false;
+        }
+        stereofilterout(lr, buffersize);
+    }
+
+    for(int i = 0; i < buffersize; ++i) {
+        l[i] = lr[2 * i] * outgain;
+        r[i] = lr[2 * i + 1] * outgain;
+    }
+}
+
 float AnalogFilter::H(float freq)
 {
     float fr = freq / samplerate_f * PI * 2.0f;
@@ -32,6 +32,10 @@ class AnalogFilter:public Filter
                      unsigned char Fstages, unsigned int srate, int bufsize);
         ~AnalogFilter();
         void filterout(float *smp);
+        //Filter both channels of a stereo signal with one set of
+        //coefficients; r keeps its own history, so an instance is used
+        //either for a mono or for a stereo signal
+        void filterout(float *l, float *r);
         void setfreq(float frequency);
         void setfreq_and_q(float frequency, float q_);
         void setq(float q_);
@@ -56,13 +60,19 @@ class AnalogFilter:public Filter
         struct fstage {
             float x1, x2; //Input History
             float y1, y2; //Output History
-        } history[MAX_FILTER_STAGES + 1], oldHistory[MAX_FILTER_STAGES + 1];
+        } history[MAX_FILTER_STAGES + 1], oldHistory[MAX_FILTER_STAGES + 1],
+          rhistory[MAX_FILTER_STAGES + 1]; //right channel of filterout(l, r)
 
         //old coeffs are used for interpolation when parameters change quickly
 
         //Apply IIR filter to Samples, with coefficients, and past history
     void singlefilterout(float *smp, fstage &hist);// const Coeff &coeff);
-        void singlefilterout_freqbuf(float *smp, fstage &hist, float *freqbuf);
+        void singlefilterout_freqbuf(float *smp, fstage &hist,
+                                     const Coeff *steps);
+        //Exact coefficients of every 8 samples of a transition
+        void computesteps(const float *freqbuf, Coeff *steps);
+        //Apply all stages to n interleaved stereo samples
+        void stereofilterout(float *lr, int n);
         //Update coeff and order
     void computefiltercoefs(float freq, float q);
 
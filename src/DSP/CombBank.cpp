@@ -0,0 +1,186 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  CombBank.cpp - Parallel comb filters of Reverb
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "CombBank.h"
+
+#ifdef ZYN_SIMD_SSE2
+#include <immintrin.h>
+#endif
+#ifdef ZYN_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace zyn {
+
+/*
+ * Every comb computes
+ *     fb = delayed * fb
+ *     fb = fb * (1 - damp) + lp * damp, lp = fb
+ *     written = in + fb
+ * like the former per comb loop of Reverb. The 8 lanes s0..s7 of a channel
+ * are summed up as ((s0 + s4) + (s2 + s6)) + ((s1 + s5) + (s3 + s7)), which
+ * is the natural order of a reduction of two 4 lane vectors.
+ */
+
+static inline float sumChannel(const float *s)
+{
+    return ((s[0] + s[4]) + (s[2] + s[6])) + ((s[1] + s[5]) + (s[3] + s[7]));
+}
+
+void combBankScalar(CombLanes &c, const float *in,
+                    const CombLaneBuffer delayed, CombLaneBuffer written,
+                    float *outl, float *outr, int n)
+{
+    const float a = 1.0f - c.damp, b = c.damp;
+    for(int i = 0; i < n; ++i) {
+        float fb[COMB_BANK_LANES];
+        for(int l = 0; l < COMB_BANK_LANES; ++l) {
+            float f = delayed[i][l] * c.fb[l];
+            f = f * a + c.lp[l] * b;
+            c.lp[l] = f;
+            written[i][l] = in[i] + f;
+            fb[l] = f;
+        }
+        outl[i] += sumChannel(fb);
+        outr[i] += sumChannel(fb + COMB_BANK_CHANNEL);
+    }
+}
+
+#ifdef ZYN_SIMD_SSE2
+//(s0 + s2) + (s1 + s3) of lo + hi
+static inline float sumChannel(__m128 lo, __m128 hi)
+{
+    const __m128 s = _mm_add_ps(lo, hi);
+    const __m128 t = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    return _mm_cvtss_f32(_mm_add_ss(t, _mm_shuffle_ps(t, t, 1)));
+}
+
+static void combBankSSE2(CombLanes &c, const float *in,
+                         const CombLaneBuffer delayed, CombLaneBuffer written,
+                         float *outl, float *outr, int n)
+{
+    const __m128 a = _mm_set1_ps(1.0f - c.damp), b = _mm_set1_ps(c.damp);
+    __m128 fb[4], lp[4];
+    for(int v = 0; v < 4; ++v) {
+        fb[v] = _mm_loadu_ps(c.fb + 4 * v);
+        lp[v] = _mm_loadu_ps(c.lp + 4 * v);
+    }
+    for(int i = 0; i < n; ++i) {
+        const __m128 x = _mm_set1_ps(in[i]);
+        for(int v = 0; v < 4; ++v) {
+            __m128 f = _mm_mul_ps(_mm_loadu_ps(delayed[i] + 4 * v), fb[v]);
+            f = _mm_add_ps(_mm_mul_ps(f, a), _mm_mul_ps(lp[v], b));
+            lp[v] = f;
+            _mm_storeu_ps(written[i] + 4 * v, _mm_add_ps(x, f));
+        }
+        outl[i] += sumChannel(lp[0], lp[1]);
+        outr[i] += sumChannel(lp[2], lp[3]);
+    }
+    for(int v = 0; v < 4; ++v)
+        _mm_storeu_ps(c.lp + 4 * v, lp[v]);
+}
+#endif
+
+#ifdef ZYN_SIMD_AVX2
+//One channel per vector
+ZYN_TARGET_AVX2
+static void combBankAVX2(CombLanes &c, const float *in,
+                         const CombLaneBuffer delayed, CombLaneBuffer written,
+                         float *outl, float *outr, int n)
+{
+    const __m256 a = _mm256_set1_ps(1.0f - c.damp), b = _mm256_set1_ps(c.damp);
+    const __m256 fbl = _mm256_loadu_ps(c.fb);
+    const __m256 fbr = _mm256_loadu_ps(c.fb + COMB_BANK_CHANNEL);
+    __m256 lpl = _mm256_loadu_ps(c.lp);
+    __m256 lpr = _mm256_loadu_ps(c.lp + COMB_BANK_CHANNEL);
+    for(int i = 0; i < n; ++i) {
+        const __m256 x = _mm256_set1_ps(in[i]);
+        __m256 fl = _mm256_mul_ps(_mm256_loadu_ps(delayed[i]), fbl);
+        __m256 fr = _mm256_mul_ps(
+                _mm256_loadu_ps(delayed[i] + COMB_BANK_CHANNEL), fbr);
+        lpl = _mm256_add_ps(_mm256_mul_ps(fl, a), _mm256_mul_ps(lpl, b));
+        lpr = _mm256_add_ps(_mm256_mul_ps(fr, a), _mm256_mul_ps(lpr, b));
+        _mm256_storeu_ps(written[i], _mm256_add_ps(x, lpl));
+        _mm256_storeu_ps(written[i] + COMB_BANK_CHANNEL, _mm256_add_ps(x, lpr));
+
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(lpl),
+                              _mm256_extractf128_ps(lpl, 1));
+        __m128 t = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        outl[i] += _mm_cvtss_f32(_mm_add_ss(t, _mm_shuffle_ps(t, t, 1)));
+        s = _mm_add_ps(_mm256_castps256_ps128(lpr),
+                       _mm256_extractf128_ps(lpr, 1));
+        t = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        outr[i] += _mm_cvtss_f32(_mm_add_ss(t, _mm_shuffle_ps(t, t, 1)));
+    }
+    _mm256_storeu_ps(c.lp, lpl);
+    _mm256_storeu_ps(c.lp + COMB_BANK_CHANNEL, lpr);
+}
+#endif
+
+#ifdef ZYN_SIMD_NEON
+static inline float sumChannel(float32x4_t lo, float32x4_t hi)
+{
+    const float32x4_t s = vaddq_f32(lo, hi);
+    const float32x2_t t = vadd_f32(vget_low_f32(s), vget_high_f32(s));
+    return vget_lane_f32(vpadd_f32(t, t), 0);
+}
+
+static void combBankNEON(CombLanes &c, const float *in,
+                         const CombLaneBuffer delayed, CombLaneBuffer written,
+                         float *outl, float *outr, int n)
+{
+    const float32x4_t a = vdupq_n_f32(1.0f - c.damp), b = vdupq_n_f32(c.damp);
+    float32x4_t fb[4], lp[4];
+    for(int v = 0; v < 4; ++v) {
+        fb[v] = vld1q_f32(c.fb + 4 * v);
+        lp[v] = vld1q_f32(c.lp + 4 * v);
+    }
+    for(int i = 0; i < n; ++i) {
+        const float32x4_t x = vdupq_n_f32(in[i]);
+        for(int v = 0; v < 4; ++v) {
+            float32x4_t f = vmulq_f32(vld1q_f32(delayed[i] + 4 * v), fb[v]);
+            f = vaddq_f32(vmulq_f32(f, a), vmulq_f32(lp[v], b));
+            lp[v] = f;
+            vst1q_f32(written[i] + 4 * v, vaddq_f32(x, f));
+        }
+        outl[i] += sumChannel(lp[0], lp[1]);
+        outr[i] += sumChannel(lp[2], lp[3]);
+    }
+    for(int v = 0; v < 4; ++v)
+        vst1q_f32(c.lp + 4 * v, lp[v]);
+}
+#endif
+
+CombBankKernel combBankKernel(SimdLevel level)
+{
+    if(!simdSupported(level))
+        return combBankScalar;
+    switch(level) {
+#ifdef ZYN_SIMD_SSE2
+        case SimdLevel::SSE2:
+            return combBankSSE2;
+#endif
+#ifdef ZYN_SIMD_AVX2
+        case SimdLevel::AVX2:
+            return combBankAVX2;
+#endif
+#ifdef ZYN_SIMD_NEON
+        case SimdLevel::NEON:
+            return combBankNEON;
+#endif
+        default:
+            return combBankScalar;
+    }
+}
+
+const CombBankKernel combBank = combBankKernel(simdLevel());
+
+}
@@ -0,0 +1,55 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  CombBank.h - Parallel comb filters of Reverb
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include "SIMD.h"
+
+namespace zyn {
+
+//Combs per channel, both channels are processed together
+#define COMB_BANK_CHANNEL 8
+#define COMB_BANK_LANES   (2 * COMB_BANK_CHANNEL)
+//Largest number of samples given to a kernel at once
+#define COMB_BANK_BLOCK   32
+
+typedef float CombLaneBuffer[COMB_BANK_BLOCK][COMB_BANK_LANES];
+
+/**Feedback and damping of all combs, one comb per lane.
+ * Lanes 0..7 are the left channel, 8..15 the right one.*/
+struct CombLanes {
+    float fb[COMB_BANK_LANES]; //feedback
+    float lp[COMB_BANK_LANES]; //state of the damping low pass
+    float damp;                //coefficient of the damping low pass
+};
+
+/**
+ * Runs n samples (at most COMB_BANK_BLOCK) of every comb.
+ * delayed holds what comes out of the delay lines, written gets what goes
+ * back into them (the input plus the damped feedback) and the feedback of
+ * the left and right lanes is summed into outl and outr.
+ */
+typedef void (*CombBankKernel)(CombLanes &c, const float *in,
+                               const CombLaneBuffer delayed,
+                               CombLaneBuffer written,
+                               float *outl, float *outr, int n);
+
+/**Reference implementation, all others match it within float rounding*/
+void combBankScalar(CombLanes &c, const float *in,
+                    const CombLaneBuffer delayed, CombLaneBuffer written,
+                    float *outl, float *outr, int n);
+
+/**Kernel for the given instruction set (scalar one if unsupported)*/
+CombBankKernel combBankKernel(SimdLevel level);
+
+/**Fastest kernel for the running CPU*/
+extern const CombBankKernel combBank;
+
+}
@@ -0,0 +1,222 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  DelayLine.cpp - Ring buffer of past samples
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cmath>
+#include <cstring>
+#include "DelayLine.h"
+#include "../Misc/Allocator.h"
+
+#ifdef ZYN_SIMD_SSE2
+#include <immintrin.h>
+#endif
+#ifdef ZYN_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace zyn {
+
+DelayLine::DelayLine(Allocator &memory_, int maxdelay)
+    :memory(memory_), head(0)
+{
+    //one more than maxdelay, as the sample being written takes a slot too
+    int len = 1;
+    while(len <= maxdelay)
+        len *= 2;
+    mask = len - 1;
+    buf  = memory.valloc<float>(len);
+    clear();
+}
+
+DelayLine::~DelayLine()
+{
+    memory.devalloc(buf);
+}
+
+void DelayLine::clear(void)
+{
+    memset(buf, 0, (mask + 1) * sizeof(float));
+}
+
+void DelayLine::read(int delay, float *smps, int n) const
+{
+    const Span s = span(delay, n);
+    memcpy(smps, s.first, s.nfirst * sizeof(float));
+    memcpy(smps + s.nfirst, s.second, s.nsecond * sizeof(float));
+}
+
+void DelayLine::read(float delay, float ddelay, float *smps, int n) const
+{
+    //the position of sample i is head + i - delay - i * ddelay, the whole
+    //samples of delay are kept out of the float part to keep it precise
+    const float whole = floorf(delay);
+    delayRead(buf, mask, head - (int)whole, whole - delay, 1.0f - ddelay,
+              smps, n);
+}
+
+void DelayLine::write(const float *smps, int n)
+{
+    const Span s = span(0, n);
+    memcpy(s.first, smps, s.nfirst * sizeof(float));
+    memcpy(s.second, smps + s.nfirst, s.nsecond * sizeof(float));
+    advance(n);
+}
+
+/*
+ * The integer part k of a position is found by truncation, which is one
+ * too large for negative positions with a fraction. Sample i is then
+ *     a + (x - k) * (b - a)
+ * with a and b the samples at base + k and base + k + 1.
+ */
+
+//Samples from, ..., n - 1 of delayReadScalar
+static inline void delayReadFrom(const float *buf, int mask, int base,
+                                 float x0, float step, float *out,
+                                 int from, int n)
+{
+    for(int i = from; i < n; ++i) {
+        const float x = x0 + (float)i * step;
+        int k = (int)x;
+        if((float)k > x)
+            --k;
+        const float f = x - (float)k;
+        const float a = buf[(base + k) & mask];
+        const float b = buf[(base + k + 1) & mask];
+        out[i] += a + f * (b - a);
+    }
+}
+
+void delayReadScalar(const float *buf, int mask, int base, float x0,
+                     float step, float *out, int n)
+{
+    delayReadFrom(buf, mask, base, x0, step, out, 0, n);
+}
+
+#ifdef ZYN_SIMD_SSE2
+static void delayReadSSE2(const float *buf, int mask, int base, float x0,
+                          float step, float *out, int n)
+{
+    const __m128  vx0   = _mm_set1_ps(x0), vstep = _mm_set1_ps(step);
+    const __m128i vbase = _mm_set1_epi32(base), vmask = _mm_set1_epi32(mask);
+    const __m128i one   = _mm_set1_epi32(1);
+    __m128 vi = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    int i = 0;
+    for(; i + 4 <= n; i += 4) {
+        const __m128 x = _mm_add_ps(vx0, _mm_mul_ps(vi, vstep));
+        __m128i k = _mm_cvttps_epi32(x);
+        k = _mm_add_epi32(k, _mm_castps_si128(
+                              _mm_cmpgt_ps(_mm_cvtepi32_ps(k), x)));
+        const __m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(k));
+
+        alignas(16) int ia[4], ib[4];
+        const __m128i p = _mm_add_epi32(vbase, k);
+        _mm_store_si128((__m128i *)ia, _mm_and_si128(p, vmask));
+        _mm_store_si128((__m128i *)ib,
+                        _mm_and_si128(_mm_add_epi32(p, one), vmask));
+        const __m128 a = _mm_setr_ps(buf[ia[0]], buf[ia[1]],
+                                     buf[ia[2]], buf[ia[3]]);
+        const __m128 b = _mm_setr_ps(buf[ib[0]], buf[ib[1]],
+                                     buf[ib[2]], buf[ib[3]]);
+        const __m128 y = _mm_add_ps(a, _mm_mul_ps(f, _mm_sub_ps(b, a)));
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), y));
+        vi = _mm_add_ps(vi, _mm_set1_ps(4.0f));
+    }
+    delayReadFrom(buf, mask, base, x0, step, out, i, n);
+}
+#endif
+
+#ifdef ZYN_SIMD_AVX2
+ZYN_TARGET_AVX2
+static void delayReadAVX2(const float *buf, int mask, int base, float x0,
+                          float step, float *out, int n)
+{
+    const __m256  vx0   = _mm256_set1_ps(x0), vstep = _mm256_set1_ps(step);
+    const __m256i vbase = _mm256_set1_epi32(base);
+    const __m256i vmask = _mm256_set1_epi32(mask);
+    const __m256i one   = _mm256_set1_epi32(1);
+    __m256 vi = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    int i = 0;
+    for(; i + 8 <= n; i += 8) {
+        const __m256  x  = _mm256_add_ps(vx0, _mm256_mul_ps(vi, vstep));
+        const __m256  kf = _mm256_floor_ps(x);
+        const __m256  f  = _mm256_sub_ps(x, kf);
+        const __m256i p  = _mm256_add_epi32(vbase, _mm256_cvttps_epi32(kf));
+        const __m256  a  = _mm256_i32gather_ps(
+            buf, _mm256_and_si256(p, vmask), 4);
+        const __m256  b  = _mm256_i32gather_ps(
+            buf, _mm256_and_si256(_mm256_add_epi32(p, one), vmask), 4);
+        const __m256 y = _mm256_add_ps(a, _mm256_mul_ps(f, _mm256_sub_ps(b, a)));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), y));
+        vi = _mm256_add_ps(vi, _mm256_set1_ps(8.0f));
+    }
+    delayReadFrom(buf, mask, base, x0, step, out, i, n);
+}
+#endif
+
+#ifdef ZYN_SIMD_NEON
+static void delayReadNEON(const float *buf, int mask, int base, float x0,
+                          float step, float *out, int n)
+{
+    const float32x4_t vx0   = vdupq_n_f32(x0), vstep = vdupq_n_f32(step);
+    const int32x4_t   vbase = vdupq_n_s32(base), vmask = vdupq_n_s32(mask);
+    const int32x4_t   one   = vdupq_n_s32(1);
+    const float       idx[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    float32x4_t vi = vld1q_f32(idx);
+    int i = 0;
+    for(; i + 4 <= n; i += 4) {
+        const float32x4_t x = vaddq_f32(vx0, vmulq_f32(vi, vstep));
+        int32x4_t k = vcvtq_s32_f32(x);
+        k = vaddq_s32(k, vreinterpretq_s32_u32(
+                             vcgtq_f32(vcvtq_f32_s32(k), x)));
+        const float32x4_t f = vsubq_f32(x, vcvtq_f32_s32(k));
+
+        int ia[4], ib[4];
+        const int32x4_t p = vaddq_s32(vbase, k);
+        vst1q_s32(ia, vandq_s32(p, vmask));
+        vst1q_s32(ib, vandq_s32(vaddq_s32(p, one), vmask));
+        float sa[4], sb[4];
+        for(int j = 0; j < 4; ++j) {
+            sa[j] = buf[ia[j]];
+            sb[j] = buf[ib[j]];
+        }
+        const float32x4_t a = vld1q_f32(sa), b = vld1q_f32(sb);
+        const float32x4_t y = vaddq_f32(a, vmulq_f32(f, vsubq_f32(b, a)));
+        vst1q_f32(out + i, vaddq_f32(vld1q_f32(out + i), y));
+        vi = vaddq_f32(vi, vdupq_n_f32(4.0f));
+    }
+    delayReadFrom(buf, mask, base, x0, step, out, i, n);
+}
+#endif
+
+DelayReadKernel delayReadKernel(SimdLevel level)
+{
+    if(!simdSupported(level))
+        return delayReadScalar;
+    switch(level) {
+#ifdef ZYN_SIMD_SSE2
+        case SimdLevel::SSE2:
+            return delayReadSSE2;
+#endif
+#ifdef ZYN_SIMD_AVX2
+        case SimdLevel::AVX2:
+            return delayReadAVX2;
+#endif
+#ifdef ZYN_SIMD_NEON
+        case SimdLevel::NEON:
+            return delayReadNEON;
+#endif
+        default:
+            return delayReadScalar;
+    }
+}
+
+const DelayReadKernel delayRead = delayReadKernel(simdLevel());
+
+}
@@ -0,0 +1,113 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  DelayLine.h - Ring buffer of past samples
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include "SIMD.h"
+
+namespace zyn {
+
+class Allocator;
+
+/**
+ * Adds n samples of the ring buffer buf (of length mask + 1) to out, read
+ * with linear interpolation at the positions base + x0 + i * step.
+ */
+typedef void (*DelayReadKernel)(const float *buf, int mask, int base,
+                                float x0, float step, float *out, int n);
+
+/**Reference implementation, all others match it within float rounding*/
+void delayReadScalar(const float *buf, int mask, int base, float x0,
+                     float step, float *out, int n);
+
+/**Kernel for the given instruction set (scalar one if unsupported)*/
+DelayReadKernel delayReadKernel(SimdLevel level);
+
+/**Fastest kernel for the running CPU*/
+extern const DelayReadKernel delayRead;
+
+/**
+ * Delay line with a power of two length, so positions wrap with a mask
+ * instead of a modulo or a branch.
+ *
+ * Besides one sample at a time it can be accessed in blocks: span() gives
+ * the (at most two) contiguous pieces of the buffer a run of samples is
+ * stored in, so the loops over them need no wrapping at all.
+ */
+class DelayLine
+{
+    public:
+        /**Contiguous pieces of a run of samples, the second one is empty
+         * unless the run wraps around the end of the buffer*/
+        struct Span {
+            float *first;
+            int    nfirst;
+            float *second;
+            int    nsecond;
+        };
+
+        /**Holds at least maxdelay past samples*/
+        DelayLine(Allocator &memory, int maxdelay);
+        ~DelayLine();
+
+        /**Fills the line with silence*/
+        void clear(void);
+
+        /**Sample written delay samples ago, 1 <= delay <= getmaxdelay()*/
+        float read(int delay) const
+        {
+            return buf[(head - delay) & mask];
+        }
+        /**Appends one sample*/
+        void write(float smp)
+        {
+            buf[head] = smp;
+            head      = (head + 1) & mask;
+        }
+
+        /**
+         * The n samples starting delay samples ago.
+         * With delay = 0 it is the room for the next n samples, which
+         * advance() appends once they are written.
+         */
+        Span span(int delay, int n) const
+        {
+            const int start = (head - delay) & mask;
+            const int first = mask + 1 - start < n ? mask + 1 - start : n;
+            return Span{buf + start, first, buf, n - first};
+        }
+        void advance(int n)
+        {
+            head = (head + n) & mask;
+        }
+
+        /**Copies n samples starting delay samples ago, n <= delay*/
+        void read(int delay, float *smps, int n) const;
+        /**
+         * Adds n samples to smps, read with linear interpolation at the
+         * delays delay + i * ddelay for the i-th of the next n samples,
+         * as if the ones before it were written already.
+         * The delays must not drop below n, else samples are read before
+         * they are written.
+         */
+        void read(float delay, float ddelay, float *smps, int n) const;
+        /**Appends n samples*/
+        void write(const float *smps, int n);
+
+        int getmaxdelay(void) const { return mask; }
+
+    private:
+        Allocator &memory;
+        float     *buf;
+        int        mask; //length - 1
+        int        head; //where the next sample goes
+};
+
+}
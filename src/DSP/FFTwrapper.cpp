@@ -86,6 +86,32 @@ void FFTwrapper::freqs2smps(const fft_t *freqs, float *smps)
         smps[i] = static_cast<float>(time[i]);
 }
 
+void FFTwrapper::smps2split(const float *smps, float *re, float *im)
+{
+    for(int i = 0; i < fftsize; ++i)
+        time[i] = static_cast<double>(smps[i]);
+
+    fftw_execute(planfftw);
+
+    for(int i = 0; i <= fftsize / 2; ++i) {
+        re[i] = static_cast<float>(fft[i][0]);
+        im[i] = static_cast<float>(fft[i][1]);
+    }
+}
+
+void FFTwrapper::split2smps(const float *re, const float *im, float *smps)
+{
+    for(int i = 0; i <= fftsize / 2; ++i) {
+        fft[i][0] = re[i];
+        fft[i][1] = im[i];
+    }
+
+    fftw_execute(planfftw_inv);
+
+    for(int i = 0; i < fftsize; ++i)
+        smps[i] = static_cast<float>(time[i]);
+}
+
 void FFT_cleanup()
 {
     fftw_cleanup();
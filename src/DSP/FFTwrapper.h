@@ -33,6 +33,11 @@ class FFTwrapper
          * @param freqs Structure FFTFREQS which stores the frequencies*/
         void smps2freqs(const float *smps, fft_t *freqs);
         void freqs2smps(const fft_t *freqs, float *smps);
+        /**Like smps2freqs, but keeps all fftsize/2+1 bins (the Nyquist one
+         * included) as separate real and imaginary parts*/
+        void smps2split(const float *smps, float *re, float *im);
+        /**Inverse of smps2split (unnormalized, like freqs2smps)*/
+        void split2smps(const float *re, const float *im, float *smps);
     private:
         int fftsize;
         fftw_real    *time;
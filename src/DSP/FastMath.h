@@ -0,0 +1,263 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  FastMath.h - Approximations of elementary functions for DSP code
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+
+//Accuracy tier of the fast_* functions, set by the MathTier build option
+#define ZYN_MATH_EXACT 0
+#define ZYN_MATH_HIGH  1
+#define ZYN_MATH_FAST  2
+#ifndef ZYN_MATH_TIER
+#define ZYN_MATH_TIER ZYN_MATH_EXACT
+#endif
+
+namespace zyn {
+
+/**
+ * Every function exists in three tiers:
+ *  - exact: the C library function
+ *  - high:  within a few float ulp (about 1e-7 relative/absolute)
+ *  - fast:  errors around 1e-5 to 1e-4, good enough for control signals
+ *
+ * The approximations are free of branches and table lookups, so loops
+ * calling them can be vectorised by the compiler.
+ * FastMathTest reports the measured accuracy of each tier.
+ */
+namespace fastmath {
+
+enum { exact = ZYN_MATH_EXACT, high = ZYN_MATH_HIGH, fast = ZYN_MATH_FAST };
+
+inline int32_t floatbits(float x)
+{
+    int32_t i;
+    memcpy(&i, &x, sizeof(i));
+    return i;
+}
+
+inline float bitsfloat(int32_t i)
+{
+    float x;
+    memcpy(&x, &i, sizeof(x));
+    return x;
+}
+
+//nearest integer of x (round half up), clamped to the range of int32_t
+//(NaN gives INT32_MIN), as the conversion of larger values is undefined
+inline int32_t nearest(float x)
+{
+    float y = x + 0.5f;
+    y = y >= -2147483648.0f ? (y <= 2147483520.0f ? y : 2147483520.0f)
+                            : -2147483648.0f;
+    const int32_t n = (int32_t)y;
+    return n - (y < (float)n);
+}
+
+/**2^x, results are clamped to the normal range [2^-126, 2^127]*/
+template<int tier>
+inline float exp2(float x)
+{
+    if(tier == exact)
+        return exp2f(x);
+
+    x = x < -126.0f ? -126.0f : (x > 127.4f ? 127.4f : x);
+    const int32_t n = nearest(x);
+    const float   f = x - (float)n; //[-0.5, 0.5]
+
+    //Taylor series of e^(f ln 2)
+    float p;
+    if(tier == high)
+        p = 1.0f + f * (0.693147181f + f * (0.240226507f + f * (0.0555041087f
+          + f * (0.00961812911f + f * (0.00133335581f + f * (0.000154035304f
+          + f * 0.0000152527338f))))));
+    else
+        p = 1.0f + f * (0.693147181f + f * (0.240226507f + f * (0.0555041087f
+          + f * 0.00961812911f)));
+    return p * bitsfloat((n + 127) << 23);
+}
+
+/**log2(x) for x > 0 (0 and denormals give about -127)*/
+template<int tier>
+inline float log2(float x)
+{
+    if(tier == exact)
+        return log2f(x);
+
+    const int32_t bits = floatbits(x);
+    float e = (float)(((bits >> 23) & 0xff) - 127);
+    float m = bitsfloat((bits & 0x7fffff) | 0x3f800000); //[1, 2)
+    //move m to [sqrt(1/2), sqrt(2)]
+    const bool big = m > 1.41421356f;
+    m = big ? 0.5f * m : m;
+    e = big ? e + 1.0f : e;
+
+    //log2(m) = 2/ln(2) atanh(t)
+    const float t  = (m - 1.0f) / (m + 1.0f);
+    const float t2 = t * t;
+    float p;
+    if(tier == high)
+        p = 2.88539008f + t2 * (0.961796694f + t2 * (0.577078016f
+          + t2 * (0.412198583f + t2 * 0.320598898f)));
+    else
+        p = 2.88539008f + t2 * 0.961796694f;
+    return e + t * p;
+}
+
+//x reduced to [-pi/4, pi/4] and the quadrant it came from
+template<int tier>
+inline float quadrant(float x, int32_t &q)
+{
+    q = nearest(x * 0.636619772f);
+    //in double, as -ffast-math would merge a split pi/2 again
+    if(tier == high)
+        return (float)((double)x - (double)q * 1.5707963267948966);
+    else
+        return x - (float)q * 1.57079633f;
+}
+
+//sin and cos of r in [-pi/4, pi/4]
+template<int tier>
+inline void sincospoly(float r, float &s, float &c)
+{
+    const float r2 = r * r;
+    if(tier == high) {
+        s = r + r * r2 * (-1.66666667e-1f + r2 * (8.33333333e-3f
+          + r2 * (-1.98412698e-4f + r2 * 2.75573192e-6f)));
+        c = 1.0f + r2 * (-0.5f + r2 * (4.16666667e-2f + r2 * (-1.38888889e-3f
+          + r2 * 2.48015873e-5f)));
+    } else {
+        s = r + r * r2 * (-1.66666667e-1f + r2 * 8.33333333e-3f);
+        c = 1.0f + r2 * (-0.5f + r2 * (4.16666667e-2f + r2 * -1.38888889e-3f));
+    }
+}
+
+template<int tier>
+inline float sin(float x)
+{
+    if(tier == exact)
+        return sinf(x);
+
+    int32_t q;
+    float s, c;
+    sincospoly<tier>(quadrant<tier>(x, q), s, c);
+    const float a = (q & 1) ? c : s;
+    return (q & 2) ? -a : a;
+}
+
+template<int tier>
+inline float cos(float x)
+{
+    if(tier == exact)
+        return cosf(x);
+
+    int32_t q;
+    float s, c;
+    sincospoly<tier>(quadrant<tier>(x, q), s, c);
+    const float a = (q & 1) ? s : c;
+    return ((q + 1) & 2) ? -a : a;
+}
+
+template<int tier>
+inline float tan(float x)
+{
+    if(tier == exact)
+        return tanf(x);
+
+    int32_t q;
+    float s, c;
+    sincospoly<tier>(quadrant<tier>(x, q), s, c);
+    return (q & 1) ? -c / s : s / c;
+}
+
+template<int tier>
+inline float atan(float x)
+{
+    if(tier == exact)
+        return atanf(x);
+
+    const float a = fabsf(x);
+    float y;
+    if(tier == high) {
+        //reduce to [-tan(pi/8), tan(pi/8)] (as Cephes atanf)
+        const bool big = a > 2.41421356f;
+        const bool mid = a > 0.414213562f;
+        const float num = big ? -1.0f : (mid ? a - 1.0f : a);
+        const float den = big ? a : (mid ? a + 1.0f : 1.0f);
+        const float t   = num / den;
+        const float z   = t * t;
+        y = (big ? 1.57079633f : (mid ? 0.785398163f : 0.0f))
+          + t + t * z * (-3.33329491539e-1f + z * (1.99777106478e-1f
+          + z * (-1.38776856032e-1f + z * 8.05374449538e-2f)));
+    } else {
+        //reduce to [-1, 1] (Abramowitz and Stegun 4.4.49)
+        const bool  big = a > 1.0f;
+        const float t   = big ? 1.0f / a : a;
+        const float z   = t * t;
+        const float p   = t * (0.9998660f + z * (-0.3302995f + z * (0.1801410f
+                        + z * (-0.0851330f + z * 0.0208351f))));
+        y = big ? 1.57079633f - p : p;
+    }
+    return x < 0.0f ? -y : y;
+}
+
+template<int tier>
+inline float exp(float x)
+{
+    if(tier == exact)
+        return expf(x);
+    return exp2<tier>(x * 1.44269504f);
+}
+
+/**x^y for x > 0. Approximations give 0 for x <= 0 (the limit at 0 for
+ * y > 0), negative bases are not supported*/
+template<int tier>
+inline float pow(float x, float y)
+{
+    if(tier == exact)
+        return powf(x, y);
+    const float p = exp2<tier>(y * log2<tier>(x));
+    return x > 0.0f ? p : 0.0f;
+}
+
+template<int tier>
+inline float log10(float x)
+{
+    if(tier == exact)
+        return log10f(x);
+    return log2<tier>(x) * 0.301029996f;
+}
+
+/**Same as the dB2rap() macro (which hides that name)*/
+template<int tier>
+inline float db2rap(float dB)
+{
+    if(tier == exact)
+        return expf(dB * 2.302585093f / 20.0f);
+    return exp2<tier>(dB * 0.166096405f);
+}
+
+}
+
+//Functions of the tier chosen at build time
+inline float fast_exp2(float x) { return fastmath::exp2<ZYN_MATH_TIER>(x); }
+inline float fast_log2(float x) { return fastmath::log2<ZYN_MATH_TIER>(x); }
+inline float fast_sin(float x) { return fastmath::sin<ZYN_MATH_TIER>(x); }
+inline float fast_cos(float x) { return fastmath::cos<ZYN_MATH_TIER>(x); }
+inline float fast_tan(float x) { return fastmath::tan<ZYN_MATH_TIER>(x); }
+inline float fast_atan(float x) { return fastmath::atan<ZYN_MATH_TIER>(x); }
+inline float fast_exp(float x) { return fastmath::exp<ZYN_MATH_TIER>(x); }
+inline float fast_pow(float x, float y) { return fastmath::pow<ZYN_MATH_TIER>(x, y); }
+inline float fast_log10(float x) { return fastmath::log10<ZYN_MATH_TIER>(x); }
+inline float fast_dB2rap(float dB) { return fastmath::db2rap<ZYN_MATH_TIER>(dB); }
+
+}
@@ -0,0 +1,269 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  FdnBank.cpp - Feedback delay network of Reverb
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "FdnBank.h"
+
+#ifdef ZYN_SIMD_SSE2
+#include <immintrin.h>
+#endif
+#ifdef ZYN_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace zyn {
+
+/*
+ * Every line computes
+ *     lp = lp + cross * (delayed - lp)
+ *     y  = ghigh * delayed + (glow - ghigh) * lp
+ * (glow below the crossover, ghigh above it) and the lines are mixed by the
+ * fast Walsh-Hadamard transform
+ *     for h = 1, 2, 4, 8: (x[j], x[j + h]) = (x[j] + x[j + h], x[j] - x[j + h])
+ * scaled by 1/4, which keeps the mix lossless. The vector kernels run the
+ * butterflies with h < lanes of a vector as shuffles, flipping the sign of
+ * x[j + h] before adding, which gives exactly the same results.
+ * Before the last butterfly x[0] and x[8] are the sums of the left and the
+ * right lines, which are the outputs.
+ */
+
+void fdnBankScalar(FdnLanes &f, const float *in,
+                   const FdnLaneBuffer delayed, FdnLaneBuffer written,
+                   float *outl, float *outr, int n)
+{
+    for(int i = 0; i < n; ++i) {
+        float y[FDN_LINES];
+        for(int l = 0; l < FDN_LINES; ++l) {
+            const float d = delayed[i][l];
+            f.lp[l] = f.lp[l] + f.cross * (d - f.lp[l]);
+            y[l]    = f.ghigh[l] * d + (f.glow[l] - f.ghigh[l]) * f.lp[l];
+        }
+
+        for(int h = 1; h < FDN_LINES; h *= 2) {
+            if(h == FDN_LINES / 2) {
+                outl[i] += y[0];
+                outr[i] += y[h];
+            }
+            for(int j = 0; j < FDN_LINES; ++j)
+                if(!(j & h)) {
+                    const float a = y[j], b = y[j + h];
+                    y[j]     = a + b;
+                    y[j + h] = a - b;
+                }
+        }
+        for(int l = 0; l < FDN_LINES; ++l)
+            written[i][l] = 0.25f * y[l] + in[i] * f.in[l];
+    }
+}
+
+#ifdef ZYN_SIMD_SSE2
+//Butterflies with h = 1 and h = 2 inside of a vector
+static inline __m128 hadamard4(__m128 x, __m128 odd, __m128 high)
+{
+    x = _mm_add_ps(_mm_xor_ps(x, odd),
+                   _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_ps(_mm_xor_ps(x, high),
+                      _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+static void fdnBankSSE2(FdnLanes &f, const float *in,
+                        const FdnLaneBuffer delayed, FdnLaneBuffer written,
+                        float *outl, float *outr, int n)
+{
+    const __m128 cross = _mm_set1_ps(f.cross), quarter = _mm_set1_ps(0.25f);
+    const __m128 odd   = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    const __m128 high  = _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f);
+    __m128 gdiff[4], ghigh[4], lp[4], gin[4];
+    for(int v = 0; v < 4; ++v) {
+        ghigh[v] = _mm_loadu_ps(f.ghigh + 4 * v);
+        gdiff[v] = _mm_sub_ps(_mm_loadu_ps(f.glow + 4 * v), ghigh[v]);
+        lp[v]    = _mm_loadu_ps(f.lp + 4 * v);
+        gin[v]   = _mm_loadu_ps(f.in + 4 * v);
+    }
+    for(int i = 0; i < n; ++i) {
+        __m128 y[4];
+        for(int v = 0; v < 4; ++v) {
+            const __m128 d = _mm_loadu_ps(delayed[i] + 4 * v);
+            lp[v] = _mm_add_ps(lp[v], _mm_mul_ps(cross, _mm_sub_ps(d, lp[v])));
+            y[v]  = _mm_add_ps(_mm_mul_ps(ghigh[v], d),
+                               _mm_mul_ps(gdiff[v], lp[v]));
+        }
+
+        for(int v = 0; v < 4; ++v)
+            y[v] = hadamard4(y[v], odd, high);
+        for(int v = 0; v < 4; v += 2) { //h = 4
+            const __m128 a = y[v], b = y[v + 1];
+            y[v]     = _mm_add_ps(a, b);
+            y[v + 1] = _mm_sub_ps(a, b);
+        }
+        outl[i] += _mm_cvtss_f32(y[0]);
+        outr[i] += _mm_cvtss_f32(y[2]);
+        for(int v = 0; v < 2; ++v) {    //h = 8
+            const __m128 a = y[v], b = y[v + 2];
+            y[v]     = _mm_add_ps(a, b);
+            y[v + 2] = _mm_sub_ps(a, b);
+        }
+
+        const __m128 x = _mm_set1_ps(in[i]);
+        for(int v = 0; v < 4; ++v)
+            _mm_storeu_ps(written[i] + 4 * v,
+                          _mm_add_ps(_mm_mul_ps(quarter, y[v]),
+                                     _mm_mul_ps(x, gin[v])));
+    }
+    for(int v = 0; v < 4; ++v)
+        _mm_storeu_ps(f.lp + 4 * v, lp[v]);
+}
+#endif
+
+#ifdef ZYN_SIMD_AVX2
+//Butterflies with h = 1, 2 and 4 inside of a vector
+ZYN_TARGET_AVX2
+static inline __m256 hadamard8(__m256 x)
+{
+    const __m256 odd  = _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f,
+                                       0.0f, -0.0f, 0.0f, -0.0f);
+    const __m256 pair = _mm256_setr_ps(0.0f, 0.0f, -0.0f, -0.0f,
+                                       0.0f, 0.0f, -0.0f, -0.0f);
+    const __m256 high = _mm256_setr_ps(0.0f, 0.0f, 0.0f, 0.0f,
+                                       -0.0f, -0.0f, -0.0f, -0.0f);
+    x = _mm256_add_ps(_mm256_xor_ps(x, odd),
+                      _mm256_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    x = _mm256_add_ps(_mm256_xor_ps(x, pair),
+                      _mm256_permute_ps(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm256_add_ps(_mm256_xor_ps(x, high),
+                         _mm256_permute2f128_ps(x, x, 1));
+}
+
+//One channel per vector
+ZYN_TARGET_AVX2
+static void fdnBankAVX2(FdnLanes &f, const float *in,
+                        const FdnLaneBuffer delayed, FdnLaneBuffer written,
+                        float *outl, float *outr, int n)
+{
+    const int    r       = FDN_LINES / 2;
+    const __m256 cross   = _mm256_set1_ps(f.cross);
+    const __m256 quarter = _mm256_set1_ps(0.25f);
+    const __m256 ghighl  = _mm256_loadu_ps(f.ghigh);
+    const __m256 ghighr  = _mm256_loadu_ps(f.ghigh + r);
+    const __m256 gdiffl  = _mm256_sub_ps(_mm256_loadu_ps(f.glow), ghighl);
+    const __m256 gdiffr  = _mm256_sub_ps(_mm256_loadu_ps(f.glow + r), ghighr);
+    const __m256 ginl    = _mm256_loadu_ps(f.in);
+    const __m256 ginr    = _mm256_loadu_ps(f.in + r);
+    __m256 lpl = _mm256_loadu_ps(f.lp);
+    __m256 lpr = _mm256_loadu_ps(f.lp + r);
+    for(int i = 0; i < n; ++i) {
+        const __m256 dl = _mm256_loadu_ps(delayed[i]);
+        const __m256 dr = _mm256_loadu_ps(delayed[i] + r);
+        lpl = _mm256_add_ps(lpl, _mm256_mul_ps(cross, _mm256_sub_ps(dl, lpl)));
+        lpr = _mm256_add_ps(lpr, _mm256_mul_ps(cross, _mm256_sub_ps(dr, lpr)));
+        const __m256 yl = _mm256_add_ps(_mm256_mul_ps(ghighl, dl),
+                                        _mm256_mul_ps(gdiffl, lpl));
+        const __m256 yr = _mm256_add_ps(_mm256_mul_ps(ghighr, dr),
+                                        _mm256_mul_ps(gdiffr, lpr));
+
+        const __m256 a = hadamard8(yl), b = hadamard8(yr); //h = 8 below
+        outl[i] += _mm256_cvtss_f32(a);
+        outr[i] += _mm256_cvtss_f32(b);
+        const __m256 x = _mm256_set1_ps(in[i]);
+        _mm256_storeu_ps(written[i],
+                         _mm256_add_ps(_mm256_mul_ps(quarter, _mm256_add_ps(a, b)),
+                                       _mm256_mul_ps(x, ginl)));
+        _mm256_storeu_ps(written[i] + r,
+                         _mm256_add_ps(_mm256_mul_ps(quarter, _mm256_sub_ps(a, b)),
+                                       _mm256_mul_ps(x, ginr)));
+    }
+    _mm256_storeu_ps(f.lp, lpl);
+    _mm256_storeu_ps(f.lp + r, lpr);
+}
+#endif
+
+#ifdef ZYN_SIMD_NEON
+//Butterflies with h = 1 and h = 2 inside of a vector
+static inline float32x4_t hadamard4(float32x4_t x, float32x4_t odd,
+                                    float32x4_t high)
+{
+    x = vaddq_f32(vmulq_f32(x, odd), vrev64q_f32(x));
+    return vaddq_f32(vmulq_f32(x, high), vextq_f32(x, x, 2));
+}
+
+static void fdnBankNEON(FdnLanes &f, const float *in,
+                        const FdnLaneBuffer delayed, FdnLaneBuffer written,
+                        float *outl, float *outr, int n)
+{
+    static const float oddv[4]  = {1.0f, -1.0f, 1.0f, -1.0f};
+    static const float highv[4] = {1.0f, 1.0f, -1.0f, -1.0f};
+    const float32x4_t odd   = vld1q_f32(oddv), high = vld1q_f32(highv);
+    const float32x4_t cross = vdupq_n_f32(f.cross), quarter = vdupq_n_f32(0.25f);
+    float32x4_t gdiff[4], ghigh[4], lp[4], gin[4];
+    for(int v = 0; v < 4; ++v) {
+        ghigh[v] = vld1q_f32(f.ghigh + 4 * v);
+        gdiff[v] = vsubq_f32(vld1q_f32(f.glow + 4 * v), ghigh[v]);
+        lp[v]    = vld1q_f32(f.lp + 4 * v);
+        gin[v]   = vld1q_f32(f.in + 4 * v);
+    }
+    for(int i = 0; i < n; ++i) {
+        float32x4_t y[4];
+        for(int v = 0; v < 4; ++v) {
+            const float32x4_t d = vld1q_f32(delayed[i] + 4 * v);
+            lp[v] = vaddq_f32(lp[v], vmulq_f32(cross, vsubq_f32(d, lp[v])));
+            y[v]  = vaddq_f32(vmulq_f32(ghigh[v], d),
+                              vmulq_f32(gdiff[v], lp[v]));
+        }
+
+        for(int v = 0; v < 4; ++v)
+            y[v] = hadamard4(y[v], odd, high);
+        for(int v = 0; v < 4; v += 2) { //h = 4
+            const float32x4_t a = y[v], b = y[v + 1];
+            y[v]     = vaddq_f32(a, b);
+            y[v + 1] = vsubq_f32(a, b);
+        }
+        outl[i] += vgetq_lane_f32(y[0], 0);
+        outr[i] += vgetq_lane_f32(y[2], 0);
+        for(int v = 0; v < 2; ++v) {    //h = 8
+            const float32x4_t a = y[v], b = y[v + 2];
+            y[v]     = vaddq_f32(a, b);
+            y[v + 2] = vsubq_f32(a, b);
+        }
+
+        const float32x4_t x = vdupq_n_f32(in[i]);
+        for(int v = 0; v < 4; ++v)
+            vst1q_f32(written[i] + 4 * v,
+                      vaddq_f32(vmulq_f32(quarter, y[v]), vmulq_f32(x, gin[v])));
+    }
+    for(int v = 0; v < 4; ++v)
+        vst1q_f32(f.lp + 4 * v, lp[v]);
+}
+#endif
+
+FdnBankKernel fdnBankKernel(SimdLevel level)
+{
+    if(!simdSupported(level))
+        return fdnBankScalar;
+    switch(level) {
+#ifdef ZYN_SIMD_SSE2
+        case SimdLevel::SSE2:
+            return fdnBankSSE2;
+#endif
+#ifdef ZYN_SIMD_AVX2
+        case SimdLevel::AVX2:
+            return fdnBankAVX2;
+#endif
+#ifdef ZYN_SIMD_NEON
+        case SimdLevel::NEON:
+            return fdnBankNEON;
+#endif
+        default:
+            return fdnBankScalar;
+    }
+}
+
+const FdnBankKernel fdnBank = fdnBankKernel(simdLevel());
+
+}
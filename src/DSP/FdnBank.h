@@ -0,0 +1,57 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  FdnBank.h - Feedback delay network of Reverb
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include "SIMD.h"
+
+namespace zyn {
+
+//Delay lines of the network, one per lane
+#define FDN_LINES 16
+//Largest number of samples given to a kernel at once
+#define FDN_BLOCK 32
+
+typedef float FdnLaneBuffer[FDN_BLOCK][FDN_LINES];
+
+/**State of all delay lines.
+ * Lines 0..7 feed the left output, 8..15 the right one.*/
+struct FdnLanes {
+    float glow[FDN_LINES];  //gain of a pass through a line below the crossover
+    float ghigh[FDN_LINES]; //gain of a pass above the crossover
+    float lp[FDN_LINES];    //state of the crossover low pass
+    float in[FDN_LINES];    //gain of the input into a line
+    float cross;            //coefficient of the crossover low pass
+};
+
+/**
+ * Runs n samples (at most FDN_BLOCK) of the network.
+ * delayed holds what comes out of the delay lines. It is damped (with
+ * separate gains below and above the crossover), summed into outl/outr and
+ * mixed with a 16x16 Hadamard matrix; the mix plus the input is returned in
+ * written.
+ */
+typedef void (*FdnBankKernel)(FdnLanes &f, const float *in,
+                              const FdnLaneBuffer delayed,
+                              FdnLaneBuffer written,
+                              float *outl, float *outr, int n);
+
+/**Reference implementation, all others match it within float rounding*/
+void fdnBankScalar(FdnLanes &f, const float *in,
+                   const FdnLaneBuffer delayed, FdnLaneBuffer written,
+                   float *outl, float *outr, int n);
+
+/**Kernel for the given instruction set (scalar one if unsupported)*/
+FdnBankKernel fdnBankKernel(SimdLevel level);
+
+/**Fastest kernel for the running CPU*/
+extern const FdnBankKernel fdnBank;
+
+}
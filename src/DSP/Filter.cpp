@@ -47,7 +47,8 @@ Filter *Filter::generate(Allocator &memory, const FilterParams *pars,
             filter = memory.alloc<FormantFilter>(pars, &memory, srate, bufsize);
             break;
         case 2:
-            filter = memory.alloc<SVFilter>(Ftype, 1000.0f, pars->getq(), Fstages, srate, bufsize);
+            filter = memory.alloc<SVFilter>(Ftype, 1000.0f, pars->getq(), Fstages, srate, bufsize,
+                    pars->Pramped);
             filter->outgain = dB2rap(pars->getgain());
             if(filter->outgain > 1.0f)
                 filter->outgain = sqrt(filter->outgain);
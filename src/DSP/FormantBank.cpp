@@ -0,0 +1,392 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  FormantBank.cpp - Parallel band pass filters of FormantFilter
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include "FormantBank.h"
+#include "AnalogFilter.h"
+
+#ifdef ZYN_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef ZYN_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace zyn {
+
+const float MAX_FREQ    = 20000.0f;
+const float MAX_FREQ_CO = 1.0f / MAX_FREQ;
+
+//Constants of Value_Smoothing_Filter::apply()
+const float SMOOTH_A = 0.07f;
+const float SMOOTH_B = 1 + SMOOTH_A;
+
+/*
+ * Kernels
+ *
+ * Every group of 4 formants is run over the whole block at once, with its
+ * history kept in registers, and accumulated per lane. The lanes of each
+ * sample are summed up at the end as (l0 + l1) + (l2 + l3).
+ */
+
+void formantBankScalar(FormantLanes &b, int groups, int stages, float w,
+                       const float *in, float *out, int n)
+{
+    float acc[4 * n];
+    memset(acc, 0, sizeof(acc));
+
+    for(int l = 0; l < 4 * groups; ++l) {
+        const float gm = SMOOTH_B * b.amp[l];
+        float g1 = b.g1[l], g2 = b.g2[l];
+        for(int i = 0; i < n; ++i) {
+            float x = in[i];
+            for(int s = 0; s < stages; ++s) {
+                float y = x * b.c0[l] + b.x1[s][l] * b.c1[l];
+                y = y + b.x2[s][l] * b.c2[l];
+                y = y + b.y1[s][l] * b.d1[l];
+                y = y + b.y2[s][l] * b.d2[l];
+                b.x2[s][l] = b.x1[s][l];
+                b.x1[s][l] = x;
+                b.y2[s][l] = b.y1[s][l];
+                b.y1[s][l] = y;
+                x = y;
+            }
+            float amp = b.amp[l];
+            if(b.smooth[l]) {
+                g1  = g1 + w * ((gm - g1) - SMOOTH_A * g2);
+                g2  = g2 + w * (g1 - g2);
+                amp = g2;
+            }
+            acc[4 * i + l % 4] = acc[4 * i + l % 4] + x * amp;
+        }
+        b.g1[l] = g1;
+        b.g2[l] = g2;
+    }
+
+    for(int i = 0; i < n; ++i)
+        out[i] = (acc[4 * i] + acc[4 * i + 1])
+                 + (acc[4 * i + 2] + acc[4 * i + 3]);
+}
+
+#ifdef ZYN_SIMD_SSE2
+static inline __m128 select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static void formantBankSSE2(FormantLanes &b, int groups, int stages, float w,
+                            const float *in, float *out, int n)
+{
+    float acc[4 * n];
+    memset(acc, 0, sizeof(acc));
+
+    const __m128 a  = _mm_set1_ps(SMOOTH_A);
+    const __m128 wv = _mm_set1_ps(w);
+    for(int g = 0; g < groups; ++g) {
+        const int o = 4 * g;
+        const __m128 c0 = _mm_loadu_ps(b.c0 + o);
+        const __m128 c1 = _mm_loadu_ps(b.c1 + o);
+        const __m128 c2 = _mm_loadu_ps(b.c2 + o);
+        const __m128 d1 = _mm_loadu_ps(b.d1 + o);
+        const __m128 d2 = _mm_loadu_ps(b.d2 + o);
+        const __m128 gt = _mm_loadu_ps(b.amp + o);
+        const __m128 gm = _mm_mul_ps(_mm_set1_ps(SMOOTH_B), gt);
+        const __m128 mask =
+            _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(b.smooth + o)));
+        const bool smoothing = _mm_movemask_ps(mask);
+        __m128 g1 = _mm_loadu_ps(b.g1 + o);
+        __m128 g2 = _mm_loadu_ps(b.g2 + o);
+
+        __m128 x1[MAX_FILTER_STAGES + 1], x2[MAX_FILTER_STAGES + 1];
+        __m128 y1[MAX_FILTER_STAGES + 1], y2[MAX_FILTER_STAGES + 1];
+        for(int s = 0; s < stages; ++s) {
+            x1[s] = _mm_loadu_ps(b.x1[s] + o);
+            x2[s] = _mm_loadu_ps(b.x2[s] + o);
+            y1[s] = _mm_loadu_ps(b.y1[s] + o);
+            y2[s] = _mm_loadu_ps(b.y2[s] + o);
+        }
+
+        for(int i = 0; i < n; ++i) {
+            __m128 x = _mm_set1_ps(in[i]);
+            for(int s = 0; s < stages; ++s) {
+                __m128 y = _mm_add_ps(_mm_mul_ps(x, c0), _mm_mul_ps(x1[s], c1));
+                y = _mm_add_ps(y, _mm_mul_ps(x2[s], c2));
+                y = _mm_add_ps(y, _mm_mul_ps(y1[s], d1));
+                y = _mm_add_ps(y, _mm_mul_ps(y2[s], d2));
+                x2[s] = x1[s];
+                x1[s] = x;
+                y2[s] = y1[s];
+                y1[s] = y;
+                x     = y;
+            }
+            __m128 amp = gt;
+            if(smoothing) {
+                const __m128 n1 = _mm_add_ps(g1, _mm_mul_ps(wv,
+                            _mm_sub_ps(_mm_sub_ps(gm, g1), _mm_mul_ps(a, g2))));
+                const __m128 n2 = _mm_add_ps(g2, _mm_mul_ps(wv,
+                            _mm_sub_ps(n1, g2)));
+                g1  = select(mask, n1, g1);
+                g2  = select(mask, n2, g2);
+                amp = select(mask, n2, gt);
+            }
+            _mm_storeu_ps(acc + 4 * i, _mm_add_ps(_mm_loadu_ps(acc + 4 * i),
+                                                  _mm_mul_ps(x, amp)));
+        }
+
+        for(int s = 0; s < stages; ++s) {
+            _mm_storeu_ps(b.x1[s] + o, x1[s]);
+            _mm_storeu_ps(b.x2[s] + o, x2[s]);
+            _mm_storeu_ps(b.y1[s] + o, y1[s]);
+            _mm_storeu_ps(b.y2[s] + o, y2[s]);
+        }
+        _mm_storeu_ps(b.g1 + o, g1);
+        _mm_storeu_ps(b.g2 + o, g2);
+    }
+
+    //transposed, so the lanes of four samples are summed at once
+    for(int i = 0; i < n; i += 4) {
+        __m128 r0 = _mm_loadu_ps(acc + 4 * i);
+        __m128 r1 = _mm_loadu_ps(acc + 4 * i + 4);
+        __m128 r2 = _mm_loadu_ps(acc + 4 * i + 8);
+        __m128 r3 = _mm_loadu_ps(acc + 4 * i + 12);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_add_ps(r0, r1),
+                                          _mm_add_ps(r2, r3)));
+    }
+}
+#endif
+
+#ifdef ZYN_SIMD_NEON
+static void formantBankNEON(FormantLanes &b, int groups, int stages, float w,
+                            const float *in, float *out, int n)
+{
+    float acc[4 * n];
+    memset(acc, 0, sizeof(acc));
+
+    const float32x4_t a  = vdupq_n_f32(SMOOTH_A);
+    const float32x4_t wv = vdupq_n_f32(w);
+    for(int g = 0; g < groups; ++g) {
+        const int o = 4 * g;
+        const float32x4_t c0 = vld1q_f32(b.c0 + o);
+        const float32x4_t c1 = vld1q_f32(b.c1 + o);
+        const float32x4_t c2 = vld1q_f32(b.c2 + o);
+        const float32x4_t d1 = vld1q_f32(b.d1 + o);
+        const float32x4_t d2 = vld1q_f32(b.d2 + o);
+        const float32x4_t gt = vld1q_f32(b.amp + o);
+        const float32x4_t gm = vmulq_f32(vdupq_n_f32(SMOOTH_B), gt);
+        const uint32x4_t mask = vld1q_u32((const uint32_t *)(b.smooth + o));
+        const bool smoothing = b.smooth[o] || b.smooth[o + 1]
+                               || b.smooth[o + 2] || b.smooth[o + 3];
+        float32x4_t g1 = vld1q_f32(b.g1 + o);
+        float32x4_t g2 = vld1q_f32(b.g2 + o);
+
+        float32x4_t x1[MAX_FILTER_STAGES + 1], x2[MAX_FILTER_STAGES + 1];
+        float32x4_t y1[MAX_FILTER_STAGES + 1], y2[MAX_FILTER_STAGES + 1];
+        for(int s = 0; s < stages; ++s) {
+            x1[s] = vld1q_f32(b.x1[s] + o);
+            x2[s] = vld1q_f32(b.x2[s] + o);
+            y1[s] = vld1q_f32(b.y1[s] + o);
+            y2[s] = vld1q_f32(b.y2[s] + o);
+        }
+
+        for(int i = 0; i < n; ++i) {
+            float32x4_t x = vdupq_n_f32(in[i]);
+            for(int s = 0; s < stages; ++s) {
+                float32x4_t y = vaddq_f32(vmulq_f32(x, c0), vmulq_f32(x1[s], c1));
+                y = vaddq_f32(y, vmulq_f32(x2[s], c2));
+                y = vaddq_f32(y, vmulq_f32(y1[s], d1));
+                y = vaddq_f32(y, vmulq_f32(y2[s], d2));
+                x2[s] = x1[s];
+                x1[s] = x;
+                y2[s] = y1[s];
+                y1[s] = y;
+                x     = y;
+            }
+            float32x4_t amp = gt;
+            if(smoothing) {
+                const float32x4_t n1 = vaddq_f32(g1, vmulq_f32(wv,
+                            vsubq_f32(vsubq_f32(gm, g1), vmulq_f32(a, g2))));
+                const float32x4_t n2 = vaddq_f32(g2, vmulq_f32(wv,
+                            vsubq_f32(n1, g2)));
+                g1  = vbslq_f32(mask, n1, g1);
+                g2  = vbslq_f32(mask, n2, g2);
+                amp = vbslq_f32(mask, n2, gt);
+            }
+            vst1q_f32(acc + 4 * i, vaddq_f32(vld1q_f32(acc + 4 * i),
+                                             vmulq_f32(x, amp)));
+        }
+
+        for(int s = 0; s < stages; ++s) {
+            vst1q_f32(b.x1[s] + o, x1[s]);
+            vst1q_f32(b.x2[s] + o, x2[s]);
+            vst1q_f32(b.y1[s] + o, y1[s]);
+            vst1q_f32(b.y2[s] + o, y2[s]);
+        }
+        vst1q_f32(b.g1 + o, g1);
+        vst1q_f32(b.g2 + o, g2);
+    }
+
+    for(int i = 0; i < n; ++i) {
+        const float32x4_t v = vld1q_f32(acc + 4 * i);
+        const float32x2_t p = vpadd_f32(vget_low_f32(v), vget_high_f32(v));
+        out[i] = vget_lane_f32(vpadd_f32(p, p), 0);
+    }
+}
+#endif
+
+FormantBankKernel formantBankKernel(SimdLevel level)
+{
+    if(!simdSupported(level))
+        return formantBankScalar;
+    switch(level) {
+#ifdef ZYN_SIMD_SSE2
+        //4 formants per vector already cover most banks, AVX2 uses SSE2
+        case SimdLevel::SSE2:
+        case SimdLevel::AVX2:
+            return formantBankSSE2;
+#endif
+#ifdef ZYN_SIMD_NEON
+        case SimdLevel::NEON:
+            return formantBankNEON;
+#endif
+        default:
+            return formantBankScalar;
+    }
+}
+
+const FormantBankKernel formantBank = formantBankKernel(simdLevel());
+
+FormantBank::FormantBank(int formants_, int stages_, unsigned int srate,
+                         int bufsize)
+    :formants(formants_), stages(stages_), samplerate_f(srate),
+      buffersize(bufsize)
+{
+    if(stages >= MAX_FILTER_STAGES)
+        stages = MAX_FILTER_STAGES;
+
+    //rate of Value_Smoothing_Filter::sample_rate()
+    const float FS = srate;
+    const float T  = 0.05f;
+    ampw = 10.0f / (FS * T);
+
+    memset(&lanes, 0, sizeof(lanes));
+    for(int n = 0; n < formants; ++n) {
+        formant[n].freq      = 1000.0f;
+        formant[n].q         = 10.0f;
+        formant[n].recompute = true;
+        formant[n].freq_smoothing.sample_rate(srate);
+        formant[n].freq_smoothing.reset(formant[n].freq * MAX_FREQ_CO);
+        lanes.g1[n] = lanes.g2[n] = 1.0f;
+    }
+}
+
+void FormantBank::cleanup(void)
+{
+    memset(lanes.x1, 0, sizeof(lanes.x1));
+    memset(lanes.x2, 0, sizeof(lanes.x2));
+    memset(lanes.y1, 0, sizeof(lanes.y1));
+    memset(lanes.y2, 0, sizeof(lanes.y2));
+}
+
+//Same rounding as AnalogFilter::setfreq()
+void FormantBank::setfreq_and_q(int n, float frequency, float q)
+{
+    formant[n].q = q;
+    if(frequency < 0.1f)
+        frequency = 0.1f;
+    else if(frequency > MAX_FREQ)
+        frequency = MAX_FREQ;
+    frequency = ceilf(frequency);
+    if(fabsf(frequency - formant[n].freq) >= 1.0f) {
+        formant[n].freq      = frequency;
+        formant[n].recompute = true;
+    }
+}
+
+void FormantBank::setq(int n, float q)
+{
+    formant[n].q         = q;
+    formant[n].recompute = true;
+}
+
+void FormantBank::computecoeff(int n, float frequency)
+{
+    int order;
+    const AnalogFilter::Coeff c = AnalogFilter::computeCoeff(4 /*BPF*/,
+            frequency, formant[n].q, stages, 1.0f, samplerate_f, order);
+    lanes.c0[n] = c.c[0];
+    lanes.c1[n] = c.c[1];
+    lanes.c2[n] = c.c[2];
+    lanes.d1[n] = c.d[1];
+    lanes.d2[n] = c.d[2];
+}
+
+void FormantBank::filterout(const float *in, float *out, const float *amp)
+{
+    assert((buffersize % 8) == 0);
+    const int groups = (formants + 3) / 4;
+
+    for(int n = 0; n < formants; ++n) {
+        lanes.amp[n]    = amp[n];
+        lanes.smooth[n] = amp[n] == lanes.g2[n] ? 0 : -1;
+    }
+
+    //Frequencies in transition step their coefficients every 8 samples,
+    //as AnalogFilter::singlefilterout_freqbuf() does
+    float steps[FF_MAX_FORMANTS][buffersize / 8];
+    bool  moving[FF_MAX_FORMANTS];
+    bool  anymoving = false;
+    for(int n = 0; n < formants; ++n) {
+        moving[n] = formant[n].freq_smoothing.apply_every8(steps[n],
+                buffersize, formant[n].freq * MAX_FREQ_CO);
+        if(moving[n]) {
+            for(int k = 0; k < buffersize / 8; ++k)
+                steps[n][k] = ceilf(steps[n][k] * MAX_FREQ);
+            anymoving = true;
+        } else if(formant[n].recompute) {
+            computecoeff(n, formant[n].freq);
+            formant[n].recompute = false;
+        }
+    }
+
+    if(!anymoving)
+        formantBank(lanes, groups, stages + 1, ampw, in, out, buffersize);
+    else {
+        float frequency[FF_MAX_FORMANTS];
+        for(int n = 0; n < formants; ++n)
+            frequency[n] = -1.0f;
+        for(int i = 0; i < buffersize; i += 8) {
+            for(int n = 0; n < formants; ++n) {
+                const float f = steps[n][i / 8];
+                if(moving[n] && fabsf(f - frequency[n]) >= 1.0f) {
+                    computecoeff(n, f);
+                    frequency[n] = f;
+                }
+            }
+            formantBank(lanes, groups, stages + 1, ampw, in + i, out + i, 8);
+        }
+        for(int n = 0; n < formants; ++n)
+            if(moving[n])
+                formant[n].recompute = true;
+    }
+
+    //end of Value_Smoothing_Filter::apply()
+    for(int n = 0; n < formants; ++n)
+        if(lanes.smooth[n]) {
+            lanes.g2[n] += 1e-10f;
+            if(fabsf(amp[n] - lanes.g2[n]) < 0.0001f)
+                lanes.g2[n] = amp[n];
+        }
+}
+
+}
@@ -0,0 +1,92 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  FormantBank.h - Parallel band pass filters of FormantFilter
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <stdint.h>
+#include "../globals.h"
+#include "SIMD.h"
+#include "Value_Smoothing_Filter.h"
+
+namespace zyn {
+
+/**State of all formants, one formant per vector lane.
+ * Formants are grouped by 4, unused lanes are zero. FormantFilter comes
+ * from the Allocator, so the kernels must not assume any alignment.*/
+struct FormantLanes {
+    enum { groups = (FF_MAX_FORMANTS + 3) / 4, lanes = 4 * groups };
+
+    //biquad coefficients (see AnalogFilter::Coeff)
+    float c0[lanes], c1[lanes], c2[lanes], d1[lanes], d2[lanes];
+    //history of every stage
+    float x1[MAX_FILTER_STAGES + 1][lanes];
+    float x2[MAX_FILTER_STAGES + 1][lanes];
+    float y1[MAX_FILTER_STAGES + 1][lanes];
+    float y2[MAX_FILTER_STAGES + 1][lanes];
+    //amplitude smoothing, same as Value_Smoothing_Filter
+    float g1[lanes], g2[lanes];
+    float amp[lanes];    //target amplitude
+    int32_t smooth[lanes]; //-1 while g2 moves towards amp
+};
+
+/**
+ * Adds up n samples of all formants of the first groups, each applying
+ * stages biquads to in and weighted by its (smoothed) amplitude, into out.
+ * w is the rate of the amplitude smoothing.
+ */
+typedef void (*FormantBankKernel)(FormantLanes &bank, int groups, int stages,
+                                  float w, const float *in, float *out, int n);
+
+/**Reference implementation, all others match it within float rounding*/
+void formantBankScalar(FormantLanes &bank, int groups, int stages, float w,
+                       const float *in, float *out, int n);
+
+/**Kernel for the given instruction set (scalar one if unsupported)*/
+FormantBankKernel formantBankKernel(SimdLevel level);
+
+/**Fastest kernel for the running CPU*/
+extern const FormantBankKernel formantBank;
+
+/**Band pass filters of a formant filter, processed in a single pass.
+ * Each formant behaves like an AnalogFilter band pass (including its
+ * frequency smoothing) followed by a smoothed amplitude.*/
+class FormantBank
+{
+    public:
+        FormantBank(int formants, int stages, unsigned int srate, int bufsize);
+
+        void setfreq_and_q(int n, float frequency, float q);
+        void setq(int n, float q);
+        void cleanup(void);
+
+        /**Replace out by the sum of all formants applied to in, formant n
+         * being scaled by amp[n]*/
+        void filterout(const float *in, float *out, const float *amp);
+
+    private:
+        void computecoeff(int n, float frequency);
+
+        int   formants;
+        int   stages;
+        float samplerate_f;
+        int   buffersize;
+        float ampw; //rate of the amplitude smoothing
+
+        struct {
+            float freq; //rounded frequency in Hz
+            float q;
+            bool  recompute;
+            Value_Smoothing_Filter freq_smoothing;
+        } formant[FF_MAX_FORMANTS];
+
+        FormantLanes lanes;
+};
+
+}
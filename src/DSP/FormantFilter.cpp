@@ -16,18 +16,15 @@
 #include "../Misc/Util.h"
 #include "../Misc/Allocator.h"
 #include "FormantFilter.h"
-#include "AnalogFilter.h"
 #include "../Params/FilterParams.h"
 
 namespace zyn {
 
 FormantFilter::FormantFilter(const FilterParams *pars, Allocator *alloc, unsigned int srate, int bufsize)
-    :Filter(srate, bufsize), memory(*alloc)
+    :Filter(srate, bufsize), memory(*alloc),
+      bank(pars->Pnumformants, pars->Pstages, srate, bufsize)
 {
     numformants = pars->Pnumformants;
-    for(int i = 0; i < numformants; ++i)
-        formant[i] = memory.alloc<AnalogFilter>(4 /*BPF*/, 1000.0f, 10.0f, pars->Pstages, srate, bufsize);
-    cleanup();
 
     for(int j = 0; j < FF_MAX_VOWELS; ++j)
         for(int i = 0; i < numformants; ++i) {
@@ -39,12 +36,6 @@ FormantFilter::FormantFilter(const FilterParams *pars, Allocator *alloc, unsigne
                 pars->Pvowels[j].formants[i].q);
         }
 
-    for(int i = 0; i < FF_MAX_FORMANTS; ++i)
-    {
-        formant_amp_smoothing[i].sample_rate(srate);
-        formant_amp_smoothing[i].reset(1.0f);
-    }
-
     for(int i = 0; i < numformants; ++i) {
         currentformants[i].freq = 1000.0f;
         currentformants[i].amp  = 1.0f;
@@ -74,15 +65,11 @@ FormantFilter::FormantFilter(const FilterParams *pars, Allocator *alloc, unsigne
 }
 
 FormantFilter::~FormantFilter()
-{
-    for(int i = 0; i < numformants; ++i)
-        memory.dealloc(formant[i]);
-}
+{}
 
 void FormantFilter::cleanup()
 {
-    for(int i = 0; i < numformants; ++i)
-        formant[i]->cleanup();
+    bank.cleanup();
 }
 
 inline float log_2(float x)
@@ -140,8 +127,8 @@ void FormantFilter::setpos(float frequency)
                 * (1.0f - pos) + formantpar[p2][i].amp * pos;
             currentformants[i].q =
                 formantpar[p1][i].q * (1.0f - pos) + formantpar[p2][i].q * pos;
-            formant[i]->setfreq_and_q(currentformants[i].freq,
-                                      currentformants[i].q * Qfactor);
+            bank.setfreq_and_q(i, currentformants[i].freq,
+                               currentformants[i].q * Qfactor);
         }
         firsttime = false;
     }
@@ -165,8 +152,8 @@ void FormantFilter::setpos(float frequency)
                                       * pos) * formantslowness;
 
 
-            formant[i]->setfreq_and_q(currentformants[i].freq,
-                                      currentformants[i].q * Qfactor);
+            bank.setfreq_and_q(i, currentformants[i].freq,
+                               currentformants[i].q * Qfactor);
         }
 
     oldQfactor = Qfactor;
@@ -181,7 +168,7 @@ void FormantFilter::setq(float q_)
 {
     Qfactor = q_;
     for(int i = 0; i < numformants; ++i)
-        formant[i]->setq(Qfactor * currentformants[i].q);
+        bank.setq(i, Qfactor * currentformants[i].q);
 }
 
 void FormantFilter::setgain(float /*dBgain*/)
@@ -197,32 +184,14 @@ void FormantFilter::setfreq_and_q(float frequency, float q_)
 void FormantFilter::filterout(float *smp)
 {
     float inbuffer[buffersize];
+    float amp[FF_MAX_FORMANTS];
 
-    memcpy(inbuffer, smp, bufferbytes);
-    memset(smp, 0, bufferbytes);
+    for(int i = 0; i < buffersize; ++i)
+        inbuffer[i] = smp[i] * outgain;
+    for(int j = 0; j < numformants; ++j)
+        amp[j] = currentformants[j].amp;
 
-    float formantbuf[buffersize];
-
-    for(int j = 0; j < numformants; ++j) {
-
-        float tmpbuf[buffersize];
-
-        for(int i = 0; i < buffersize; ++i)
-            tmpbuf[i] = inbuffer[i] * outgain;
-
-        formant[j]->filterout(tmpbuf);
-
-        if ( formant_amp_smoothing[j].apply( formantbuf, buffersize, currentformants[j].amp ) )
-        {
-            for(int i = 0; i < buffersize; ++i)
-                smp[i] += tmpbuf[i] * formantbuf[i];
-        }
-        else
-        {
-            for(int i = 0; i < buffersize; ++i)
-                smp[i] += tmpbuf[i] * currentformants[j].amp;
-        }
-    }
+    bank.filterout(inbuffer, smp, amp);
 }
 
 }
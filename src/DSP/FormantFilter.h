@@ -16,7 +16,7 @@
 
 #include "../globals.h"
 #include "Filter.h"
-#include "Value_Smoothing_Filter.h"
+#include "FormantBank.h"
 
 namespace zyn {
 
@@ -37,8 +37,6 @@ class FormantFilter:public Filter
         void setpos(float input);
 
 
-        class AnalogFilter * formant[FF_MAX_FORMANTS];
-
         struct {
             float freq, amp, q; //frequency,amplitude,Q
         } formantpar[FF_MAX_VOWELS][FF_MAX_FORMANTS],
@@ -55,7 +53,7 @@ class FormantFilter:public Filter
         float vowelclearness, sequencestretch;
         Allocator &memory;
 
-        Value_Smoothing_Filter formant_amp_smoothing[FF_MAX_FORMANTS];
+        FormantBank bank;
 };
 
 }
@@ -0,0 +1,198 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PartitionedConvolver.cpp - Low latency FFT convolution with a fixed filter
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cstring>
+#include "PartitionedConvolver.h"
+#include "FFTwrapper.h"
+
+namespace zyn {
+
+/*
+ * Timing of the tail, with L = ratio * blocksize:
+ *
+ * The input of the tail is collected into the second half of its window,
+ * one buffer at a time. At phase 0 the window holds the two latest complete
+ * blocks of L samples; it is transformed into the newest slot of the
+ * frequency domain delay line and shifted by L. Phases 0 .. ratio-2 each
+ * multiply-accumulate their share of the partitions and the last phase
+ * turns the sum back into samples. Those are played during the next ratio
+ * buffers, which is 2*L samples after the input block they belong to
+ * started: exactly where the head ends.
+ */
+
+PartitionedConvolver::PartitionedConvolver(const float *ir, int irlen,
+                                           int blocksize_)
+    :blocksize(blocksize_), phase(0)
+{
+    ratio = 1024 / blocksize;
+    if(ratio < 8)
+        ratio = 8;
+    const int headlen = 2 * ratio * blocksize;
+
+    initsegment(head, ir, irlen < headlen ? irlen : headlen, blocksize);
+    initsegment(tail, ir + headlen, irlen - headlen, ratio * blocksize);
+}
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+    freesegment(head);
+    freesegment(tail);
+}
+
+void PartitionedConvolver::initsegment(Segment &s, const float *ir, int len,
+                                       int size)
+{
+    s.size   = size;
+    s.bins   = size + 1;
+    s.parts  = len > 0 ? (len + size - 1) / size : 0;
+    s.newest = 0;
+    s.filled = 0;
+    if(!s.parts) {
+        s.hre = s.him = s.xre = s.xim = s.accre = s.accim = NULL;
+        s.input = s.output = NULL;
+        s.fft = NULL;
+        return;
+    }
+
+    const int n = s.parts * s.bins;
+    s.hre    = new float[n];
+    s.him    = new float[n];
+    s.xre    = new float[n];
+    s.xim    = new float[n];
+    s.accre  = new float[s.bins];
+    s.accim  = new float[s.bins];
+    s.input  = new float[2 * size];
+    s.output = new float[2 * size];
+    s.fft    = new FFTwrapper(2 * size);
+
+    //the inverse FFT is unnormalized, so the 1/N goes into the partitions
+    const float norm = 1.0f / (2 * size);
+    for(int p = 0; p < s.parts; ++p) {
+        const int   off = p * size;
+        const int   cnt = len - off < size ? len - off : size;
+        float      *h   = s.input;
+        memset(h, 0, 2 * size * sizeof(float));
+        for(int i = 0; i < cnt; ++i)
+            h[i] = ir[off + i] * norm;
+        s.fft->smps2split(h, s.hre + p * s.bins, s.him + p * s.bins);
+    }
+
+    memset(s.accre, 0, s.bins * sizeof(float));
+    memset(s.accim, 0, s.bins * sizeof(float));
+    memset(s.input, 0, 2 * size * sizeof(float));
+    memset(s.output, 0, 2 * size * sizeof(float));
+}
+
+void PartitionedConvolver::freesegment(Segment &s)
+{
+    delete [] s.hre;
+    delete [] s.him;
+    delete [] s.xre;
+    delete [] s.xim;
+    delete [] s.accre;
+    delete [] s.accim;
+    delete [] s.input;
+    delete [] s.output;
+    delete s.fft;
+}
+
+//The spectra of the past input are left alone: multiplyadd() only reads the
+//slots written since, which keeps this cheap enough for the realtime thread
+void PartitionedConvolver::cleanup(void)
+{
+    Segment *segs[2] = {&head, &tail};
+    for(Segment *s: segs) {
+        if(!s->parts)
+            continue;
+        memset(s->accre, 0, s->bins * sizeof(float));
+        memset(s->accim, 0, s->bins * sizeof(float));
+        memset(s->input, 0, 2 * s->size * sizeof(float));
+        memset(s->output, 0, 2 * s->size * sizeof(float));
+        s->newest = 0;
+        s->filled = 0;
+    }
+    phase = 0;
+}
+
+//Split real and imaginary parts let the compiler vectorize this loop
+void PartitionedConvolver::multiplyadd(Segment &s, int from, int to)
+{
+    float *accre = s.accre, *accim = s.accim;
+    if(to > s.filled)
+        to = s.filled;
+    for(int p = from; p < to; ++p) {
+        int slot = s.newest - p;
+        if(slot < 0)
+            slot += s.parts;
+        const float *hr = s.hre + p * s.bins, *hi = s.him + p * s.bins;
+        const float *xr = s.xre + slot * s.bins, *xi = s.xim + slot * s.bins;
+        for(int k = 0; k < s.bins; ++k) {
+            accre[k] += xr[k] * hr[k] - xi[k] * hi[k];
+            accim[k] += xr[k] * hi[k] + xi[k] * hr[k];
+        }
+    }
+}
+
+void PartitionedConvolver::process(const float *in, float *out)
+{
+    const int bytes = blocksize * sizeof(float);
+
+    //both segments take their input before out (which may be in) is written
+    if(tail.parts) {
+        if(phase == 0) {
+            if(++tail.newest == tail.parts)
+                tail.newest = 0;
+            if(tail.filled < tail.parts)
+                ++tail.filled;
+            tail.fft->smps2split(tail.input,
+                                 tail.xre + tail.newest * tail.bins,
+                                 tail.xim + tail.newest * tail.bins);
+            memcpy(tail.input, tail.input + tail.size, tail.size * sizeof(float));
+            memset(tail.accre, 0, tail.bins * sizeof(float));
+            memset(tail.accim, 0, tail.bins * sizeof(float));
+        }
+        memcpy(tail.input + tail.size + phase * blocksize, in, bytes);
+    }
+
+    if(head.parts) {
+        memcpy(head.input, head.input + blocksize, bytes);
+        memcpy(head.input + blocksize, in, bytes);
+        if(++head.newest == head.parts)
+            head.newest = 0;
+        if(head.filled < head.parts)
+            ++head.filled;
+        head.fft->smps2split(head.input, head.xre + head.newest * head.bins,
+                             head.xim + head.newest * head.bins);
+        memset(head.accre, 0, head.bins * sizeof(float));
+        memset(head.accim, 0, head.bins * sizeof(float));
+        multiplyadd(head, 0, head.parts);
+        head.fft->split2smps(head.accre, head.accim, head.output);
+        memcpy(out, head.output + blocksize, bytes);
+    }
+    else
+        memset(out, 0, bytes);
+
+    if(tail.parts) {
+        //ratio - 1 phases share the partitions, the last one does the IFFT
+        if(phase < ratio - 1)
+            multiplyadd(tail, phase * tail.parts / (ratio - 1),
+                        (phase + 1) * tail.parts / (ratio - 1));
+        const float *t = tail.output + tail.size + phase * blocksize;
+        for(int i = 0; i < blocksize; ++i)
+            out[i] += t[i];
+        if(phase == ratio - 1)
+            tail.fft->split2smps(tail.accre, tail.accim, tail.output);
+        if(++phase == ratio)
+            phase = 0;
+    }
+}
+
+}
@@ -0,0 +1,84 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PartitionedConvolver.h - Low latency FFT convolution with a fixed filter
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+
+namespace zyn {
+
+class FFTwrapper;
+
+/**
+ * Convolves a signal with an impulse response, one buffer at a time and
+ * without added latency.
+ *
+ * The first 2*L samples of the response (the head) are split into
+ * partitions of one buffer and run with uniformly partitioned overlap-save:
+ * every buffer costs one FFT, one inverse FFT and a multiply-accumulate per
+ * partition. The rest (the tail) uses partitions of L = m buffers, whose
+ * FFTs are m times longer but cover m times more of the response. A tail
+ * block is transformed once every m buffers, its multiply-accumulate work
+ * is spread evenly over the following m-1 buffers and the m-th one does the
+ * inverse FFT, so the result is ready exactly when the head stops covering
+ * the response. Thus the work of every buffer is about the same, no matter
+ * how long the response is.
+ *
+ * Construction allocates everything and is not realtime safe, process()
+ * and cleanup() are. cleanup() only clears the buffers of the current
+ * block, the spectra of the past input are skipped until they are
+ * overwritten, so its cost does not depend on the length of the response.
+ */
+class PartitionedConvolver
+{
+    public:
+        /**
+         * @param ir        impulse response
+         * @param irlen     length of ir in samples
+         * @param blocksize samples given to every process() call
+         */
+        PartitionedConvolver(const float *ir, int irlen, int blocksize);
+        ~PartitionedConvolver();
+
+        /**Convolves blocksize samples, in and out may be the same buffer*/
+        void process(const float *in, float *out);
+        /**Forgets the past input*/
+        void cleanup(void);
+
+        int getblocksize(void) const { return blocksize; }
+
+    private:
+        //One set of equally sized partitions
+        struct Segment {
+            int    size;     //partition length (the FFT is twice as long)
+            int    bins;     //size + 1
+            int    parts;    //number of partitions
+            float *hre, *him;   //spectra of the partitions, parts * bins
+            float *xre, *xim;   //spectra of past input blocks, parts * bins
+            float *accre, *accim; //sum of the products, bins
+            float *input;    //last two input blocks, 2 * size
+            float *output;   //inverse FFT, 2 * size
+            int    newest;   //slot of xre/xim holding the newest block
+            int    filled;   //slots written since the last cleanup
+            FFTwrapper *fft;
+        };
+
+        void initsegment(Segment &s, const float *ir, int len, int size);
+        void freesegment(Segment &s);
+        //Adds the products of partitions [from, to) to the accumulator,
+        //skipping those that would meet input from before a cleanup
+        void multiplyadd(Segment &s, int from, int to);
+
+        const int blocksize;
+        Segment   head, tail;
+        int       ratio; //m, tail partition size in blocks
+        int       phase; //block within the current tail block
+};
+
+}
@@ -0,0 +1,55 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  SIMD.cpp - Runtime detection of the available vector instruction sets
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "SIMD.h"
+
+namespace zyn {
+
+bool simdSupported(SimdLevel level)
+{
+    switch(level) {
+        case SimdLevel::Scalar:
+            return true;
+        case SimdLevel::SSE2:
+#ifdef ZYN_SIMD_SSE2
+            return true;
+#else
+            return false;
+#endif
+        case SimdLevel::AVX2:
+#ifdef ZYN_SIMD_AVX2
+            //may be called from static constructors
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+        case SimdLevel::NEON:
+#ifdef ZYN_SIMD_NEON
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+SimdLevel simdLevel(void)
+{
+    static const SimdLevel level =
+        simdSupported(SimdLevel::AVX2) ? SimdLevel::AVX2 :
+        simdSupported(SimdLevel::SSE2) ? SimdLevel::SSE2 :
+        simdSupported(SimdLevel::NEON) ? SimdLevel::NEON :
+        SimdLevel::Scalar;
+    return level;
+}
+
+}
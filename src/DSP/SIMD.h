@@ -0,0 +1,40 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  SIMD.h - Runtime detection of the available vector instruction sets
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+
+//Vector code for x86 is compiled for SSE2 (always present on x86_64) and
+//AVX2 (enabled per function through target attributes and only called when
+//the CPU reports it). ARM builds use NEON when the compiler targets it.
+#if defined(__SSE2__)
+#define ZYN_SIMD_SSE2 1
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ZYN_SIMD_AVX2 1
+#define ZYN_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ZYN_SIMD_NEON 1
+#endif
+
+namespace zyn {
+
+enum class SimdLevel {
+    Scalar, SSE2, AVX2, NEON
+};
+
+/**Best instruction set supported by both the build and the running CPU*/
+SimdLevel simdLevel(void);
+
+/**true if kernels for the given level can be run on this machine*/
+bool simdSupported(SimdLevel level);
+
+}
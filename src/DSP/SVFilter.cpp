@@ -17,6 +17,14 @@
 #include <cassert>
 #include "../Misc/Util.h"
 #include "SVFilter.h"
+#include "FastMath.h"
+#include "SIMD.h"
+
+#if defined(ZYN_SIMD_SSE2)
+#include <emmintrin.h>
+#elif defined(ZYN_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 #define errx(...) {}
 #define warnx(...) {}
@@ -27,19 +35,22 @@
 namespace zyn {
 
 SVFilter::SVFilter(unsigned char Ftype, float Ffreq, float Fq,
-                   unsigned char Fstages, unsigned int srate, int bufsize)
+                   unsigned char Fstages, unsigned int srate, int bufsize,
+                   bool ramped_)
     :Filter(srate, bufsize),
       type(Ftype),
       stages(Fstages),
       freq(Ffreq),
       q(Fq),
-      gain(1.0f)
+      gain(1.0f),
+      ramped(ramped_)
 {
     if(stages >= MAX_FILTER_STAGES)
         stages = MAX_FILTER_STAGES;
     outgain = 1.0f;
     cleanup();
     setfreq_and_q(Ffreq, Fq);
+    rampf = par.f;
     freq_smoothing.reset(Ffreq);
     freq_smoothing.sample_rate(srate);
 }
@@ -49,8 +60,10 @@ SVFilter::~SVFilter()
 
 void SVFilter::cleanup()
 {
-    for(int i = 0; i < MAX_FILTER_STAGES + 1; ++i)
+    for(int i = 0; i < MAX_FILTER_STAGES + 1; ++i) {
         st[i].low = st[i].high = st[i].band = st[i].notch = 0.0f;
+        rst[i] = st[i];
+    }
 }
 
 SVFilter::response::response(float b0, float b1, float b2,
@@ -100,13 +113,18 @@ SVFilter::response SVFilter::computeResponse(int type,
 
 
 
+//Coefficient f of a frequency
+static float svfreq(float freq, float samplerate_f)
+{
+    const float f = freq / samplerate_f * 4.0f;
+    return f > 0.99999f ? 0.99999f : f;
+}
+
 void SVFilter::computefiltercoefs(void)
 {
-    par.f = freq / samplerate_f * 4.0f;
-    if(par.f > 0.99999f)
-        par.f = 0.99999f;
-    par.q      = 1.0f - atanf(sqrtf(q)) * 2.0f / PI;
-    par.q      = powf(par.q, 1.0f / (stages + 1));
+    par.f = svfreq(freq, samplerate_f);
+    par.q      = 1.0f - fast_atan(sqrtf(q)) * 2.0f / PI;
+    par.q      = fast_pow(par.q, 1.0f / (stages + 1));
     par.q_sqrt = sqrtf(par.q);
 }
 
@@ -207,6 +225,16 @@ void SVFilter::filterout(float *smp)
 {
     assert((buffersize % 8) == 0);
 
+    if(ramped) {
+        float df;
+        const float f = ramp(df);
+        rampedfilterout(smp, st, f, df);
+
+        for(int i = 0; i < buffersize; ++i)
+            smp[i] *= outgain;
+        return;
+    }
+
     float freqbuf[buffersize];
 
     if ( freq_smoothing.apply( freqbuf, buffersize, freq ) )
@@ -232,4 +260,170 @@ void SVFilter::filterout(float *smp)
         smp[i] *= outgain;
 }
 
+/*
+ * Ramped filtering
+ *
+ * All stages are applied to a sample before moving on to the next one.
+ * Instead of recomputing the coefficients every 8 samples while the
+ * frequency moves, f is ramped linearly from its value at the end of the
+ * last block to the smoothed one at the last sample of this block (q does
+ * not depend on the frequency). Without frequency changes the result equals
+ * the one of the other mode (up to rounding when the compiler reorders the
+ * arithmetic, as with -ffast-math).
+ * The channels of filterout(l, r) share the vector lanes. A mono filter is
+ * a single recursion and runs the same loop in scalar code.
+ */
+
+//f of the first sample of the block, df is set to the change per sample
+float SVFilter::ramp(float &df)
+{
+    float freqbuf[buffersize / 8];
+    float end = par.f;
+    if(freq_smoothing.apply_every8(freqbuf, buffersize, freq))
+        end = svfreq(freq_smoothing.value(), samplerate_f);
+
+    const float start = rampf;
+    df    = (end - start) / buffersize;
+    rampf = end;
+    return start + df;
+}
+
+template<class T>
+static inline T svout(int type, T low, T high, T band, T notch)
+{
+    switch(type) {
+        case 1:
+            return high;
+        case 2:
+            return band;
+        case 3:
+            return notch;
+        default:
+            return low;
+    }
+}
+
+void SVFilter::rampedfilterout(float *smp, fstage *hist, float f, float df)
+{
+    const float pq  = par.q;
+    const float pqs = par.q_sqrt;
+    for(int i = 0; i < buffersize; ++i) {
+        const float fi = f + df * i;
+        float x = smp[i];
+        for(int j = 0; j < stages + 1; ++j) {
+            fstage &s = hist[j];
+            s.low   = s.low + fi * s.band;
+            s.high  = pqs * x - s.low - pq * s.band;
+            s.band  = fi * s.high + s.band;
+            s.notch = s.high + s.low;
+            x = svout(type, s.low, s.high, s.band, s.notch);
+        }
+        smp[i] = x;
+    }
+}
+
+#if defined(ZYN_SIMD_SSE2)
+typedef __m128 svpair;
+static inline svpair svset(float l, float r) { return _mm_setr_ps(l, r, 0.0f, 0.0f); }
+static inline svpair svdup(float x) { return _mm_set1_ps(x); }
+static inline svpair svadd(svpair a, svpair b) { return _mm_add_ps(a, b); }
+static inline svpair svsub(svpair a, svpair b) { return _mm_sub_ps(a, b); }
+static inline svpair svmul(svpair a, svpair b) { return _mm_mul_ps(a, b); }
+static inline svpair svload(const float *p)
+{
+    return _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)p);
+}
+static inline void svstore(float *p, svpair v)
+{
+    _mm_storel_pi((__m64 *)p, v);
+}
+#elif defined(ZYN_SIMD_NEON)
+typedef float32x2_t svpair;
+static inline svpair svset(float l, float r)
+{
+    const float v[2] = {l, r};
+    return vld1_f32(v);
+}
+static inline svpair svdup(float x) { return vdup_n_f32(x); }
+static inline svpair svadd(svpair a, svpair b) { return vadd_f32(a, b); }
+static inline svpair svsub(svpair a, svpair b) { return vsub_f32(a, b); }
+static inline svpair svmul(svpair a, svpair b) { return vmul_f32(a, b); }
+static inline svpair svload(const float *p) { return vld1_f32(p); }
+static inline void svstore(float *p, svpair v) { vst1_f32(p, v); }
+#endif
+
+void SVFilter::rampedfilterout(float *l, float *r, float f, float df)
+{
+#if defined(ZYN_SIMD_SSE2) || defined(ZYN_SIMD_NEON)
+    float lr[2 * buffersize];
+    for(int i = 0; i < buffersize; ++i) {
+        lr[2 * i]     = l[i];
+        lr[2 * i + 1] = r[i];
+    }
+
+    const int n = stages + 1;
+    svpair low[MAX_FILTER_STAGES + 1], high[MAX_FILTER_STAGES + 1];
+    svpair band[MAX_FILTER_STAGES + 1], notch[MAX_FILTER_STAGES + 1];
+    for(int j = 0; j < n; ++j) {
+        low[j]   = svset(st[j].low, rst[j].low);
+        high[j]  = svset(st[j].high, rst[j].high);
+        band[j]  = svset(st[j].band, rst[j].band);
+        notch[j] = svset(st[j].notch, rst[j].notch);
+    }
+
+    const svpair pq  = svdup(par.q);
+    const svpair pqs = svdup(par.q_sqrt);
+    for(int i = 0; i < buffersize; ++i) {
+        const svpair fi = svdup(f + df * i);
+        svpair x = svload(lr + 2 * i);
+        for(int j = 0; j < n; ++j) {
+            low[j]   = svadd(low[j], svmul(fi, band[j]));
+            high[j]  = svsub(svsub(svmul(pqs, x), low[j]), svmul(pq, band[j]));
+            band[j]  = svadd(svmul(fi, high[j]), band[j]);
+            notch[j] = svadd(high[j], low[j]);
+            x = svout(type, low[j], high[j], band[j], notch[j]);
+        }
+        svstore(lr + 2 * i, x);
+    }
+
+    for(int j = 0; j < n; ++j) {
+        float v[2];
+        svstore(v, low[j]);
+        st[j].low = v[0];
+        rst[j].low = v[1];
+        svstore(v, high[j]);
+        st[j].high = v[0];
+        rst[j].high = v[1];
+        svstore(v, band[j]);
+        st[j].band = v[0];
+        rst[j].band = v[1];
+        svstore(v, notch[j]);
+        st[j].notch = v[0];
+        rst[j].notch = v[1];
+    }
+
+    for(int i = 0; i < buffersize; ++i) {
+        l[i] = lr[2 * i];
+        r[i] = lr[2 * i + 1];
+    }
+#else
+    rampedfilterout(l, st, f, df);
+    rampedfilterout(r, rst, f, df);
+#endif
+}
+
+void SVFilter::filterout(float *l, float *r)
+{
+    assert((buffersize % 8) == 0);
+
+    float df;
+    const float f = ramp(df);
+    rampedfilterout(l, r, f, df);
+
+    for(int i = 0; i < buffersize; ++i) {
+        l[i] *= outgain;
+        r[i] *= outgain;
+    }
+}
+
 }
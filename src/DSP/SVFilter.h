@@ -27,9 +27,13 @@ class SVFilter:public Filter
                  float Ffreq,
                  float Fq,
                  unsigned char Fstages,
-                 unsigned int srate, int bufsize);
+                 unsigned int srate, int bufsize,
+                 bool ramped_ = false);
         ~SVFilter();
         void filterout(float *smp);
+        //Filter both channels of a stereo signal in one pass, r keeps its
+        //own history (ramped filters only)
+        void filterout(float *l, float *r);
         void setfreq(float frequency);
         void setfreq_and_q(float frequency, float q_);
         void setq(float q_);
@@ -39,6 +43,10 @@ class SVFilter:public Filter
         void setstages(int stages_);
         void cleanup();
 
+        //Whether stages are run together and the frequency is ramped
+        //per block instead of stepped every 8 samples
+        bool isramped(void) const { return ramped; }
+
         struct response {
             response(float b0, float b1, float b2,
                      float a0, float a1 ,float a2);
@@ -51,7 +59,8 @@ class SVFilter:public Filter
     private:
         struct fstage {
             float low, high, band, notch;
-        } st[MAX_FILTER_STAGES + 1];
+        } st[MAX_FILTER_STAGES + 1],
+          rst[MAX_FILTER_STAGES + 1]; //right channel of filterout(l, r)
 
         struct parameters {
             float f, q, q_sqrt;
@@ -61,12 +70,20 @@ class SVFilter:public Filter
     void singlefilterout(float *smp, fstage &x, parameters &par, int buffersize );
 
     void computefiltercoefs(void);
+        //Ramped processing, f moves by df every sample
+        float ramp(float &df);
+        void rampedfilterout(float *smp, fstage *hist, float f, float df);
+        void rampedfilterout(float *l, float *r, float f, float df);
+
         int   type;    // The type of the filter (LPF1,HPF1,LPF2,HPF2...)
         int   stages;  // how many times the filter is applied (0->1,1->2,etc.)
         float freq; // Frequency given in Hz
         float q;    // Q factor (resonance or Q factor)
         float gain; // the gain of the filter (if are shelf/peak) filters
 
+        bool  ramped;
+        float rampf; //f at the end of the last block (ramped)
+
     Value_Smoothing_Filter freq_smoothing;
 };
 
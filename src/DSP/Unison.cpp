@@ -26,7 +26,8 @@
 
 namespace zyn {
 
-Unison::Unison(Allocator *alloc_, int update_period_samples_, float max_delay_sec_, float srate_f)
+Unison::Unison(Allocator *alloc_, int update_period_samples_, float max_delay_sec_, float srate_f,
+               prng_t seed)
     :unison_size(0),
       base_freq(1.0f),
       uv(NULL),
@@ -39,7 +40,8 @@ Unison::Unison(Allocator *alloc_, int update_period_samples_, float max_delay_se
       unison_amplitude_samples(0.0f),
       unison_bandwidth_cents(10.0f),
       samplerate_f(srate_f),
-      alloc(*alloc_)
+      alloc(*alloc_),
+      rnd_state(seed)
 {
     if(max_delay < 10)
         max_delay = 10;
@@ -60,6 +62,8 @@ void Unison::setSize(int new_size)
     unison_size = new_size;
     alloc.devalloc(uv);
     uv = alloc.valloc<UnisonVoice>(unison_size);
+    for(int i = 0; i < unison_size; ++i)
+        uv[i].position = rnd_r(rnd_state) * 1.8f - 0.9f;
     first_time = true;
     updateParameters();
 }
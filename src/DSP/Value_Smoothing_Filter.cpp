@@ -30,6 +30,37 @@ Value_Smoothing_Filter::sample_rate ( nframes_t n )
     const float T = 0.05f;
 
     w = _cutoff / (FS * T);
+
+    /* one step of apply() is the linear map
+     *   (g1, g2) <- M (g1, g2) + u gm
+     * so 8 of them are M^8 and (I + M + ... + M^7) u */
+    const double a = 0.07;
+    const double M[2][2] = { { 1 - w, -w * a },
+                             { w * (1 - w), 1 - w - w * w * a } };
+    const double u[2] = { w, w * w };
+
+    double P[2][2] = { { 1, 0 }, { 0, 1 } };
+    double S[2] = { 0, 0 };
+    for ( int k = 0; k < 8; k++ )
+    {
+        S[0] += P[0][0] * u[0] + P[0][1] * u[1];
+        S[1] += P[1][0] * u[0] + P[1][1] * u[1];
+
+        const double Q[2][2] = {
+            { P[0][0] * M[0][0] + P[0][1] * M[1][0],
+              P[0][0] * M[0][1] + P[0][1] * M[1][1] },
+            { P[1][0] * M[0][0] + P[1][1] * M[1][0],
+              P[1][0] * M[0][1] + P[1][1] * M[1][1] } };
+        P[0][0] = Q[0][0]; P[0][1] = Q[0][1];
+        P[1][0] = Q[1][0]; P[1][1] = Q[1][1];
+    }
+
+    for ( int i = 0; i < 2; i++ )
+    {
+        m8[i][0] = P[i][0];
+        m8[i][1] = P[i][1];
+        u8[i] = S[i];
+    }
 }
 
 bool
@@ -72,3 +103,55 @@ Value_Smoothing_Filter::apply( sample_t * __restrict__ dst, nframes_t nframes, f
 
     return true;
 }
+
+bool
+Value_Smoothing_Filter::apply_every8( sample_t * __restrict__ dst, nframes_t nframes, float gt )
+{
+    if ( _reset_on_next_apply )
+    {
+        reset( gt );
+        _reset_on_next_apply = false;
+        return false;
+    }
+
+    if ( target_reached(gt) )
+        return false;
+
+    const float a = 0.07f;
+    const float b = 1 + a;
+
+    const float gm = b * gt;
+
+    float g1 = this->g1;
+    float g2 = this->g2;
+
+    /* dst[i / 8] is the value apply() gives for frame i */
+    g1 += w * (gm - g1 - a * g2);
+    g2 += w * (g1 - g2);
+    dst[0] = g2;
+
+    for (nframes_t i = 8; i < nframes; i += 8)
+    {
+        const float n1 = m8[0][0] * g1 + m8[0][1] * g2 + u8[0] * gm;
+        const float n2 = m8[1][0] * g1 + m8[1][1] * g2 + u8[1] * gm;
+        g1 = n1;
+        g2 = n2;
+        dst[i / 8] = g2;
+    }
+
+    for (int i = 1; i < 8; i++)
+    {
+        g1 += w * (gm - g1 - a * g2);
+        g2 += w * (g1 - g2);
+    }
+
+    g2 += 1e-10f;               /* denormal protection */
+
+    if ( fabsf( gt - g2 ) < 0.0001f )
+        g2 = gt;
+
+    this->g1 = g1;
+    this->g2 = g2;
+
+    return true;
+}
@@ -27,6 +27,9 @@ class Value_Smoothing_Filter
 {
     float w, g1, g2;
 
+    /* 8 steps at once, see apply_every8() */
+    float m8[2][2], u8[2];
+
     float _cutoff;
 
     bool _reset_on_next_apply;
@@ -48,9 +51,16 @@ public:
 
     inline bool target_reached ( float gt ) const { return gt == g2; }
 
+    /* value of the last frame of the last apply() or apply_every8() */
+    float value ( void ) const { return g2; }
+
     void sample_rate ( nframes_t n );
 
     bool apply( sample_t * __restrict__ dst, nframes_t nframes, float gt );
+
+    /* like apply(), but only writes the values of frames 0, 8, 16...
+     * to dst[i / 8]; nframes has to be a multiple of 8 */
+    bool apply_every8( sample_t * __restrict__ dst, nframes_t nframes, float gt );
 };
 
 #endif
@@ -63,7 +63,7 @@ rtosc::Ports Alienwah::ports = {
 
 Alienwah::Alienwah(EffectParams pars)
     :Effect(pars),
-      lfo(pars.srate, pars.bufsize),
+      lfo(pars.srate, pars.bufsize, pars.seed),
       oldl(NULL),
       oldr(NULL)
 {
@@ -15,10 +15,14 @@
 #include <rtosc/ports.h>
 #include <rtosc/port-sugar.h>
 #include "../Misc/Allocator.h"
+#include "../DSP/DelayLine.h"
 #include "Chorus.h"
 #include <iostream>
 using namespace std;
 
+//Largest number of samples processed at once
+#define CHORUS_BLOCK 64
+
 namespace zyn {
 
 #define rObject Chorus
@@ -28,7 +32,8 @@ namespace zyn {
 rtosc::Ports Chorus::ports = {
     {"preset::i", rProp(parameter)
                   rOptions(Chorus1, Chorus2, Chorus3, Celeste1, Celeste2,
-                           Flange1, Flange2, Flange3, Flange4, Flange5)
+                           Flange1, Flange2, Flange3, Flange4, Flange5,
+                           Ensemble1, Ensemble2)
                   rDoc("Instrument Presets"), 0,
                   rBegin;
                   rObject *o = (rObject*)d.obj;
@@ -42,29 +47,37 @@ rtosc::Ports Chorus::ports = {
     rEffParVol(rDefault(64)),
     rEffParPan(),
     rEffPar(Pfreq,    2, rShort("freq"),
-            rPresets(50, 45, 29, 26, 29, 57, 33, 53, 40, 55),
+            rPresets(50, 45, 29, 26, 29, 57, 33, 53, 40, 55, 40, 30),
             "Effect Frequency"),
     rEffPar(Pfreqrnd, 3, rShort("rand"),
             rPreset(4, 117) rPreset(6, 34) rPreset(7, 34) rPreset(9, 105)
-            rDefault(0), "Frequency Randomness"),
+            rPreset(11, 20) rDefault(0), "Frequency Randomness"),
     rEffParOpt(PLFOtype, 4, rShort("shape"),
             rOptions(sine, tri),
-            rPresets(sine, sine, tri, sine, sine, sine, tri, tri, tri, sine),
+            rPresets(sine, sine, tri, sine, sine, sine, tri, tri, tri, sine,
+                     sine, sine),
             "LFO Shape"),
     rEffPar(PStereo,  5, rShort("stereo"),
-            rPresets(90, 98, 42, 42, 50, 60, 40, 94, 62), "Stereo Mode"),
+            rPresets(90, 98, 42, 42, 50, 60, 40, 94, 62),
+            rPresetsAt(10, 90, 100), "Stereo Mode"),
     rEffPar(Pdepth,   6, rShort("depth"),
-            rPresets(40, 56, 97, 115, 115, 23, 35, 35, 12), "LFO Depth"),
+            rPresets(40, 56, 97, 115, 115, 23, 35, 35, 12),
+            rPresetsAt(10, 50, 60), "LFO Depth"),
     rEffPar(Pdelay,   7, rShort("delay"),
-            rPresets(85, 90, 95, 18, 9, 3, 3, 3, 19), "Delay"),
+            rPresets(85, 90, 95, 18, 9, 3, 3, 3, 19),
+            rPresetsAt(10, 80, 90), "Delay"),
     rEffPar(Pfeedback,8, rShort("fb"),
-            rPresets(64, 64, 90, 90, 31, 62, 109, 54, 97), "Feedback"),
+            rPresets(64, 64, 90, 90, 31, 62, 109, 54, 97),
+            rPresetsAt(10, 64, 64), "Feedback"),
     rEffPar(Plrcross, 9, rShort("l/r"), rPresets(119, 19, 127, 127, 127),
             rDefault(0), "Left/Right Crossover"),
     rEffParTF(Pflangemode, 10, rShort("flange"), rDefault(false),
               "Flange Mode"),
     rEffParTF(Poutsub, 11, rShort("sub"), rPreset(4, true), rPreset(7, true),
               rDefault(false), "Output Subtraction"),
+    rEffParRange(Pvoices, 12, rShort("voices"), rLinear(1, 8),
+                 rPresetsAt(10, 4, 8), rDefault(1),
+                 "Delayed copies per channel, with evenly spaced LFO phases"),
 };
 #undef rBegin
 #undef rEnd
@@ -72,24 +85,28 @@ rtosc::Ports Chorus::ports = {
 
 Chorus::Chorus(EffectParams pars)
     :Effect(pars),
-      lfo(pars.srate, pars.bufsize),
+      Pvoices(1),
+      lfo(pars.srate, pars.bufsize, pars.seed),
       maxdelay((int)(MAX_CHORUS_DELAY / 1000.0f * samplerate_f)),
-      delaySample(memory.valloc<float>(maxdelay), memory.valloc<float>(maxdelay))
+      delaySample(memory.alloc<DelayLine>(memory, maxdelay),
+                  memory.alloc<DelayLine>(memory, maxdelay))
 {
-    dlk = 0;
-    drk = 0;
     setpreset(Ppreset);
     changepar(1, 64);
-    lfo.effectlfoout(&lfol, &lfor);
-    dl2 = getdelay(lfol);
-    dr2 = getdelay(lfor);
+    float lfol[MAX_CHORUS_VOICES], lfor[MAX_CHORUS_VOICES];
+    lfo.effectlfoout(lfol, lfor, Pvoices);
+    for(int v = 0; v < Pvoices; ++v) {
+        dl2[v] = getdelay(lfol[v]);
+        dr2[v] = getdelay(lfor[v]);
+    }
+    lastvoices = Pvoices;
     cleanup();
 }
 
 Chorus::~Chorus()
 {
-    memory.devalloc(delaySample.l);
-    memory.devalloc(delaySample.r);
+    memory.dealloc(delaySample.l);
+    memory.dealloc(delaySample.r);
 }
 
 //get the delay value in samples; xlfo is the current lfo value
@@ -112,57 +129,62 @@ float Chorus::getdelay(float xlfo)
 //Apply the effect
 void Chorus::out(const Stereo<float *> &input)
 {
-    dl1 = dl2;
-    dr1 = dr2;
-    lfo.effectlfoout(&lfol, &lfor);
+    const int voices = Pvoices;
+    float lfol[MAX_CHORUS_VOICES], lfor[MAX_CHORUS_VOICES];
+    lfo.effectlfoout(lfol, lfor, voices);
+
+    float mindelay = maxdelay;
+    for(int v = 0; v < voices; ++v) {
+        dl1[v] = dl2[v];
+        dr1[v] = dr2[v];
+        dl2[v] = getdelay(lfol[v]);
+        dr2[v] = getdelay(lfor[v]);
+        //the phases of all voices move when their number changes
+        if(voices != lastvoices) {
+            dl1[v] = dl2[v];
+            dr1[v] = dr2[v];
+        }
+        mindelay = min(mindelay, min(min(dl1[v], dl2[v]), min(dr1[v], dr2[v])));
+    }
+    lastvoices = voices;
 
-    dl2 = getdelay(lfol);
-    dr2 = getdelay(lfor);
+    //the delay moves linearly between the lfo delays; a chunk must not read
+    //what it writes itself, unless it is a single sample
+    const int maxn = limit((int)mindelay - 1, 1, CHORUS_BLOCK);
+
+    //the voices are mixed at constant power, the feedback is their average
+    const float gain   = 1.0f / sqrtf(voices);
+    const float fbgain = fb * gain;
+
+    for(int start = 0; start < buffersize; start += maxn) {
+        const int n = min(buffersize - start, maxn);
+        float *outl = efxoutl + start, *outr = efxoutr + start;
 
-    for(int i = 0; i < buffersize; ++i) {
-        float inL = input.l[i];
-        float inR = input.r[i];
         //LRcross
-        Stereo<float> tmpc(inL, inR);
-        inL = tmpc.l * (1.0f - lrcross) + tmpc.r * lrcross;
-        inR = tmpc.r * (1.0f - lrcross) + tmpc.l * lrcross;
-
-        //Left channel
-
-        //compute the delay in samples using linear interpolation between the lfo delays
-        float mdel =
-            (dl1 * (buffersize - i) + dl2 * i) / buffersize_f;
-        if(++dlk >= maxdelay)
-            dlk = 0;
-        float tmp = dlk - mdel + maxdelay * 2.0f; //where should I get the sample from
-
-        dlhi  = (int) tmp;
-        dlhi %= maxdelay;
-
-        float dlhi2 = (dlhi - 1 + maxdelay) % maxdelay;
-        float dllo  = 1.0f + floorf(tmp) - tmp;
-        efxoutl[i] = cinterpolate(delaySample.l, maxdelay, dlhi2) * dllo
-                     + cinterpolate(delaySample.l, maxdelay,
-                                    dlhi) * (1.0f - dllo);
-        delaySample.l[dlk] = inL + efxoutl[i] * fb;
-
-        //Right channel
-
-        //compute the delay in samples using linear interpolation between the lfo delays
-        mdel = (dr1 * (buffersize - i) + dr2 * i) / buffersize_f;
-        if(++drk >= maxdelay)
-            drk = 0;
-        tmp = drk * 1.0f - mdel + maxdelay * 2.0f; //where should I get the sample from
-
-        dlhi  = (int) tmp;
-        dlhi %= maxdelay;
-
-        dlhi2      = (dlhi - 1 + maxdelay) % maxdelay;
-        dllo       = 1.0f + floorf(tmp) - tmp;
-        efxoutr[i] = cinterpolate(delaySample.r, maxdelay, dlhi2) * dllo
-                     + cinterpolate(delaySample.r, maxdelay,
-                                    dlhi) * (1.0f - dllo);
-        delaySample.r[dlk] = inR + efxoutr[i] * fb;
+        float inl[CHORUS_BLOCK], inr[CHORUS_BLOCK];
+        for(int i = 0; i < n; ++i) {
+            inl[i] = input.l[start + i] * (1.0f - lrcross)
+                     + input.r[start + i] * lrcross;
+            inr[i] = input.r[start + i] * (1.0f - lrcross)
+                     + input.l[start + i] * lrcross;
+            outl[i] = outr[i] = 0.0f;
+        }
+
+        for(int v = 0; v < voices; ++v) {
+            const float ddl = (dl2[v] - dl1[v]) / buffersize_f;
+            const float ddr = (dr2[v] - dr1[v]) / buffersize_f;
+            delaySample.l->read(dl1[v] + ddl * start, ddl, outl, n);
+            delaySample.r->read(dr1[v] + ddr * start, ddr, outr, n);
+        }
+
+        for(int i = 0; i < n; ++i) {
+            outl[i] *= gain;
+            outr[i] *= gain;
+            inl[i]  += outl[i] * fbgain;
+            inr[i]  += outr[i] * fbgain;
+        }
+        delaySample.l->write(inl, n);
+        delaySample.r->write(inr, n);
     }
 
     if(Poutsub)
@@ -180,8 +202,8 @@ void Chorus::out(const Stereo<float *> &input)
 //Cleanup the effect
 void Chorus::cleanup(void)
 {
-    memset(delaySample.l, 0, maxdelay * sizeof(float));
-    memset(delaySample.r, 0, maxdelay * sizeof(float));
+    delaySample.l->clear();
+    delaySample.r->clear();
 }
 
 //Parameter control
@@ -203,6 +225,11 @@ void Chorus::setfb(unsigned char _Pfb)
     fb  = (Pfb - 64.0f) / 64.1f;
 }
 
+void Chorus::setvoices(unsigned char _Pvoices)
+{
+    Pvoices = limit<int>(_Pvoices, 1, MAX_CHORUS_VOICES);
+}
+
 void Chorus::setvolume(unsigned char _Pvolume)
 {
     Pvolume   = _Pvolume;
@@ -212,29 +239,33 @@ void Chorus::setvolume(unsigned char _Pvolume)
 
 unsigned char Chorus::getpresetpar(unsigned char npreset, unsigned int npar)
 {
-#define	PRESET_SIZE 12
-#define	NUM_PRESETS 10
+#define	PRESET_SIZE 13
+#define	NUM_PRESETS 12
     static const unsigned char presets[NUM_PRESETS][PRESET_SIZE] = {
         //Chorus1
-        {64, 64, 50, 0,   0, 90, 40,  85, 64,  119, 0, 0},
+        {64, 64, 50, 0,   0, 90, 40,  85, 64,  119, 0, 0, 1},
         //Chorus2
-        {64, 64, 45, 0,   0, 98, 56,  90, 64,  19,  0, 0},
+        {64, 64, 45, 0,   0, 98, 56,  90, 64,  19,  0, 0, 1},
         //Chorus3
-        {64, 64, 29, 0,   1, 42, 97,  95, 90,  127, 0, 0},
+        {64, 64, 29, 0,   1, 42, 97,  95, 90,  127, 0, 0, 1},
         //Celeste1
-        {64, 64, 26, 0,   0, 42, 115, 18, 90,  127, 0, 0},
+        {64, 64, 26, 0,   0, 42, 115, 18, 90,  127, 0, 0, 1},
         //Celeste2
-        {64, 64, 29, 117, 0, 50, 115, 9,  31,  127, 0, 1},
+        {64, 64, 29, 117, 0, 50, 115, 9,  31,  127, 0, 1, 1},
         //Flange1
-        {64, 64, 57, 0,   0, 60, 23,  3,  62,  0,   0, 0},
+        {64, 64, 57, 0,   0, 60, 23,  3,  62,  0,   0, 0, 1},
         //Flange2
-        {64, 64, 33, 34,  1, 40, 35,  3,  109, 0,   0, 0},
+        {64, 64, 33, 34,  1, 40, 35,  3,  109, 0,   0, 0, 1},
         //Flange3
-        {64, 64, 53, 34,  1, 94, 35,  3,  54,  0,   0, 1},
+        {64, 64, 53, 34,  1, 94, 35,  3,  54,  0,   0, 1, 1},
         //Flange4
-        {64, 64, 40, 0,   1, 62, 12,  19, 97,  0,   0, 0},
+        {64, 64, 40, 0,   1, 62, 12,  19, 97,  0,   0, 0, 1},
         //Flange5
-        {64, 64, 55, 105, 0, 24, 39,  19, 17,  0,   0, 1}
+        {64, 64, 55, 105, 0, 24, 39,  19, 17,  0,   0, 1, 1},
+        //Ensemble1
+        {64, 64, 40, 0,   0, 90, 50,  80, 64,  0,   0, 0, 4},
+        //Ensemble2
+        {64, 64, 30, 20,  0, 100, 60, 90, 64,  0,   0, 0, 8}
     };
     if(npreset < NUM_PRESETS && npar < PRESET_SIZE) {
         return presets[npreset][npar];
@@ -294,6 +325,9 @@ void Chorus::changepar(int npar, unsigned char value)
         case 11:
             Poutsub = (value > 1) ? 1 : value;
             break;
+        case 12:
+            setvoices(value);
+            break;
     }
 }
 
@@ -312,6 +346,7 @@ unsigned char Chorus::getpar(int npar) const
         case 9:  return Plrcross;
         case 10: return Pflangemode;
         case 11: return Poutsub;
+        case 12: return Pvoices;
         default: return 0;
     }
 }
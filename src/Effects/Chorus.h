@@ -18,9 +18,12 @@
 #include "../Misc/Stereo.h"
 
 #define MAX_CHORUS_DELAY 250.0f //ms
+#define MAX_CHORUS_VOICES 8
 
 namespace zyn {
 
+class DelayLine;
+
 /**Chorus and Flange effects*/
 class Chorus:public Effect
 {
@@ -46,6 +49,7 @@ class Chorus:public Effect
          *   -# Feedback
          *   -# Flange Mode
          *   -# Subtractive
+         *   -# Voices
          * @param npar number of chosen parameter
          * @param value the new value
          */
@@ -65,6 +69,7 @@ class Chorus:public Effect
          *   -# Feedback
          *   -# Flange Mode
          *   -# Subtractive
+         *   -# Voices
          * @param npar number of chosen parameter
          * @return the value of the parameter
          */
@@ -80,6 +85,7 @@ class Chorus:public Effect
         unsigned char Pfb;         //feedback
         unsigned char Pflangemode; //how the LFO is scaled, to result chorus or flange
         unsigned char Poutsub;     //if I wish to subtract the output instead of the adding it
+        unsigned char Pvoices;     //number of delayed copies per channel (ensemble)
         EffectLFO     lfo;         //lfo-ul chorus
 
 
@@ -88,13 +94,16 @@ class Chorus:public Effect
         void setdepth(unsigned char _Pdepth);
         void setdelay(unsigned char _Pdelay);
         void setfb(unsigned char _Pfb);
+        void setvoices(unsigned char _Pvoices);
 
         //Internal Values
         float depth, delay, fb;
-        float dl1, dl2, dr1, dr2, lfol, lfor;
+        //delays of every voice at the start and the end of the buffer
+        float dl1[MAX_CHORUS_VOICES], dl2[MAX_CHORUS_VOICES];
+        float dr1[MAX_CHORUS_VOICES], dr2[MAX_CHORUS_VOICES];
+        int   lastvoices; //voices of the last buffer
         int   maxdelay;
-        Stereo<float *> delaySample;
-        int dlk, drk, dlhi;
+        Stereo<DelayLine *> delaySample;
         float getdelay(float xlfo);
 };
 
@@ -0,0 +1,297 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  Convolution.cpp - Convolution Effect
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <rtosc/ports.h>
+#include <rtosc/port-sugar.h>
+#include "Convolution.h"
+#include "../DSP/PartitionedConvolver.h"
+#include "../Misc/WavFile.h"
+
+namespace zyn {
+
+#define rObject Convolution
+#define rBegin [](const char *msg, rtosc::RtData &d) {
+#define rEnd }
+
+rtosc::Ports Convolution::ports = {
+    {"preset::i", rOptions(Stereo, Mono)
+                  rProp(parameter)
+                  rDoc("Instrument Presets"), 0,
+                  rBegin;
+                  rObject *o = (rObject*)d.obj;
+                  if(rtosc_narguments(msg))
+                      o->setpreset(rtosc_argument(msg, 0).i);
+                  else
+                      d.reply(d.loc, "i", o->Ppreset);
+                  rEnd},
+    rEffParVol(rDefault(100)),
+    rEffParPan(),
+    rEffPar(Plrcross, 2, rShort("cross"), rPresets(0, 64),
+            "Left/Right Crossover"),
+};
+#undef rBegin
+#undef rEnd
+#undef rObject
+
+/*
+ * Band limited resampling of the response: every output sample is the sum
+ * of the input samples around it weighted by a sinc, with its cutoff at the
+ * lower of both Nyquist frequencies, Kaiser windowed over RESAMPLE_ZEROS
+ * zero crossings on each side. The window is tabulated with RESAMPLE_STEPS
+ * points per zero crossing and linearly interpolated.
+ */
+#define RESAMPLE_ZEROS 16
+#define RESAMPLE_STEPS 256
+#define RESAMPLE_BETA  8.0
+
+static double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for(int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum  += term;
+    }
+    return sum;
+}
+
+//step is the distance of the output samples in input samples
+static void resample(const float *in, int inlen, float *out, int outlen,
+                     double step)
+{
+    const int points = RESAMPLE_ZEROS * RESAMPLE_STEPS;
+    std::vector<float> kernel(points + 2, 0.0f);
+    for(int i = 0; i <= points; ++i) {
+        const double x = (double)i / RESAMPLE_STEPS;
+        const double w = 1.0 - (x / RESAMPLE_ZEROS) * (x / RESAMPLE_ZEROS);
+        double h = besselI0(RESAMPLE_BETA * sqrt(w > 0.0 ? w : 0.0))
+                   / besselI0(RESAMPLE_BETA);
+        if(i)
+            h *= sin(M_PI * x) / (M_PI * x);
+        kernel[i] = h;
+    }
+
+    //cutoff relative to the input rate
+    const double fc    = step > 1.0 ? 1.0 / step : 1.0;
+    const double width = RESAMPLE_ZEROS / fc;
+    for(int i = 0; i < outlen; ++i) {
+        const double pos   = i * step;
+        int          first = ceil(pos - width);
+        int          last  = floor(pos + width);
+        if(first < 0)
+            first = 0;
+        if(last > inlen - 1)
+            last = inlen - 1;
+        double sum = 0.0;
+        for(int k = first; k <= last; ++k) {
+            const double t    = fabs(pos - k) * fc * RESAMPLE_STEPS;
+            const int    j    = t;
+            const float  frac = t - j;
+            sum += in[k] * (kernel[j] + (kernel[j + 1] - kernel[j]) * frac);
+        }
+        out[i] = fc * sum;
+    }
+}
+
+ConvolutionIR::ConvolutionIR()
+    :length(0), blocksize(0)
+{
+    conv[0] = conv[1] = NULL;
+}
+
+ConvolutionIR::~ConvolutionIR()
+{
+    delete conv[0];
+    delete conv[1];
+}
+
+int ConvolutionIR::loadfile(const std::string &filename_,
+                            unsigned int samplerate, int blocksize_)
+{
+    std::vector<float> smps;
+    int rate, channels;
+    if(loadWavFile(filename_, smps, rate, channels))
+        return -1;
+
+    const int    frames = smps.size() / channels;
+    const double step  = (double)rate / samplerate;
+    int len = (frames - 1) / step + 1;
+    if(len > MAX_CONVOLUTION_IR * (int)samplerate)
+        len = MAX_CONVOLUTION_IR * samplerate;
+
+    std::vector<float> ch[2], in(frames);
+    double energy = 0.0;
+    for(int c = 0; c < 2; ++c) {
+        //a mono response is used for both channels
+        if(c >= channels) {
+            ch[c] = ch[0];
+            continue;
+        }
+        for(int i = 0; i < frames; ++i)
+            in[i] = smps[i * channels + c];
+        ch[c].resize(len);
+        if(rate == (int)samplerate)
+            std::copy(in.begin(), in.begin() + len, ch[c].begin());
+        else
+            resample(in.data(), frames, ch[c].data(), len, step);
+        double e = 0.0;
+        for(int i = 0; i < len; ++i)
+            e += ch[c][i] * ch[c][i];
+        energy = e > energy ? e : energy;
+    }
+    if(energy <= 0.0)
+        return -1;
+
+    //unit energy keeps the wet level of different responses comparable
+    const float norm = 1.0f / sqrtf(energy);
+    for(int c = 0; c < 2; ++c) {
+        for(int i = 0; i < len; ++i)
+            ch[c][i] *= norm;
+        delete conv[c];
+        conv[c] = new PartitionedConvolver(ch[c].data(), len, blocksize_);
+    }
+
+    filename  = filename_;
+    length    = len;
+    blocksize = blocksize_;
+    return 0;
+}
+
+void ConvolutionIR::cleanup(void)
+{
+    for(int c = 0; c < 2; ++c)
+        if(conv[c])
+            conv[c]->cleanup();
+}
+
+Convolution::Convolution(EffectParams pars)
+    :Effect(pars),
+      Pvolume(100),
+      ir(NULL)
+{
+    setpreset(Ppreset);
+}
+
+Convolution::~Convolution()
+{}
+
+bool Convolution::setimpulse(ConvolutionIR *ir_)
+{
+    if(ir_ && ir_->conv[0] && ir_->blocksize != buffersize)
+        return false;
+    ir = ir_;
+    return true;
+}
+
+void Convolution::cleanup(void)
+{
+    if(ir)
+        ir->cleanup();
+}
+
+//Effect output
+void Convolution::out(const Stereo<float *> &smp)
+{
+    if(!ir || !ir->conv[0]) {
+        memset(efxoutl, 0, bufferbytes);
+        memset(efxoutr, 0, bufferbytes);
+        return;
+    }
+
+    for(int i = 0; i < buffersize; ++i) {
+        efxoutl[i] = smp.l[i] * pangainL;
+        efxoutr[i] = smp.r[i] * pangainR;
+    }
+
+    ir->conv[0]->process(efxoutl, efxoutl);
+    ir->conv[1]->process(efxoutr, efxoutr);
+
+    if(Plrcross)
+        for(int i = 0; i < buffersize; ++i)
+            crossover(efxoutl[i], efxoutr[i], lrcross);
+}
+
+//Parameter control
+void Convolution::setvolume(unsigned char _Pvolume)
+{
+    Pvolume = _Pvolume;
+    if(!insertion) {
+        if (Pvolume == 0) {
+            outvolume = 0.0f;
+        } else {
+            outvolume = powf(0.01f, (1.0f - Pvolume / 127.0f)) * 4.0f;
+        }
+        volume    = 1.0f;
+    }
+    else {
+        volume = outvolume = Pvolume / 127.0f;
+        if(Pvolume == 0)
+            cleanup();
+    }
+}
+
+unsigned char Convolution::getpresetpar(unsigned char npreset, unsigned int npar)
+{
+#define PRESET_SIZE 3
+#define NUM_PRESETS 2
+    static const unsigned char presets[NUM_PRESETS][PRESET_SIZE] = {
+        {100, 64, 0 }, //Stereo
+        {100, 64, 64}  //Mono
+    };
+    if(npreset < NUM_PRESETS && npar < PRESET_SIZE) {
+        if(npar == 0 && insertion != 0) {
+            /* lower the volume if this is insertion effect */
+            return presets[npreset][npar] / 2;
+        }
+        return presets[npreset][npar];
+    }
+    return 0;
+}
+
+void Convolution::setpreset(unsigned char npreset)
+{
+    if(npreset >= NUM_PRESETS)
+        npreset = NUM_PRESETS - 1;
+    for(int n = 0; n != 128; n++)
+        changepar(n, getpresetpar(npreset, n));
+    Ppreset = npreset;
+}
+
+void Convolution::changepar(int npar, unsigned char value)
+{
+    switch(npar) {
+        case 0:
+            setvolume(value);
+            break;
+        case 1:
+            setpanning(value);
+            break;
+        case 2:
+            setlrcross(value);
+            break;
+    }
+}
+
+unsigned char Convolution::getpar(int npar) const
+{
+    switch(npar) {
+        case 0:  return Pvolume;
+        case 1:  return Ppanning;
+        case 2:  return Plrcross;
+        default: return 0;
+    }
+}
+
+}
@@ -0,0 +1,102 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  Convolution.h - Convolution Effect
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include <string>
+#include "Effect.h"
+
+//Longest impulse response that is loaded, in seconds
+#define MAX_CONVOLUTION_IR 20
+
+namespace zyn {
+
+class PartitionedConvolver;
+
+/**
+ * Impulse response of the Convolution effect.
+ *
+ * It is loaded outside of the realtime thread (by MiddleWare or when
+ * loading a file) for a given sample rate and buffer size and then handed
+ * to the EffectMgr as a whole. It holds the state of the convolution too,
+ * one convolver per channel.
+ */
+class ConvolutionIR
+{
+    public:
+        ConvolutionIR();
+        ~ConvolutionIR();
+
+        /**
+         * Loads a mono or stereo wav file, resampled to samplerate (band
+         * limited to the lower of both Nyquist frequencies) and normalized
+         * to unit energy.
+         * @return 0 on success
+         */
+        int loadfile(const std::string &filename, unsigned int samplerate,
+                     int blocksize);
+        /**Forgets the past input, realtime safe*/
+        void cleanup(void) REALTIME;
+
+        std::string filename;
+        int length;    //samples per channel
+        int blocksize; //buffer size the convolvers were made for
+        PartitionedConvolver *conv[2];
+};
+
+/**Convolution Effect*/
+class Convolution:public Effect
+{
+    public:
+        Convolution(EffectParams pars);
+        ~Convolution();
+
+        void out(const Stereo<float *> &smp);
+        unsigned char getpresetpar(unsigned char npreset, unsigned int npar);
+        void setpreset(unsigned char npreset);
+        /**
+         * Sets the value of the chosen variable
+         *
+         * The possible parameters are:
+         *   -# Volume
+         *   -# Panning
+         *   -# L/R Crossover
+         * @param npar number of chosen parameter
+         * @param value the new value
+         */
+        void changepar(int npar, unsigned char value);
+        unsigned char getpar(int npar) const;
+        void cleanup(void);
+
+        /**Uses the given impulse response (owned by the caller), NULL
+         * silences the effect. The response is used as it is, so it has to
+         * be a freshly loaded one or one cleared by cleanup().
+         * The convolvers cannot be repartitioned in the realtime thread, so
+         * a response made for another buffer size is rejected.
+         * @return false if the response was rejected (the previous one is
+         *         kept)*/
+        bool setimpulse(ConvolutionIR *ir_) REALTIME;
+
+        static rtosc::Ports ports;
+    private:
+        //Parameters
+        unsigned char Pvolume;
+
+        void setvolume(unsigned char _Pvolume);
+
+        ConvolutionIR *ir;
+};
+
+}
+
+#endif
@@ -61,7 +61,7 @@ rtosc::Ports DynamicFilter::ports = {
 
 DynamicFilter::DynamicFilter(EffectParams pars)
     :Effect(pars),
-      lfo(pars.srate, pars.bufsize),
+      lfo(pars.srate, pars.bufsize, pars.seed),
       Pvolume(110),
       Pdepth(0),
       Pampsns(90),
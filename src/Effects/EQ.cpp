@@ -99,10 +99,8 @@ rtosc::Ports EQ::ports = {
 EQ::EQ(EffectParams pars)
     :Effect(pars)
 {
-    for(int i = 0; i < MAX_EQ_BANDS; ++i) {
-        filter[i].l = memory.alloc<AnalogFilter>(6, 1000.0f, 1.0f, 0, pars.srate, pars.bufsize);
-        filter[i].r = memory.alloc<AnalogFilter>(6, 1000.0f, 1.0f, 0, pars.srate, pars.bufsize);
-    }
+    for(int i = 0; i < MAX_EQ_BANDS; ++i)
+        filter[i].f = memory.alloc<AnalogFilter>(6, 1000.0f, 1.0f, 0, pars.srate, pars.bufsize);
     //default values
     Pvolume = 50;
 
@@ -112,19 +110,15 @@ EQ::EQ(EffectParams pars)
 
 EQ::~EQ()
 {
-       for(int i = 0; i < MAX_EQ_BANDS; ++i) {
-           memory.dealloc(filter[i].l);
-           memory.dealloc(filter[i].r);
-       }
+       for(int i = 0; i < MAX_EQ_BANDS; ++i)
+           memory.dealloc(filter[i].f);
 }
 
 // Cleanup the effect
 void EQ::cleanup(void)
 {
-    for(int i = 0; i < MAX_EQ_BANDS; ++i) {
-        filter[i].l->cleanup();
-        filter[i].r->cleanup();
-    }
+    for(int i = 0; i < MAX_EQ_BANDS; ++i)
+        filter[i].f->cleanup();
 }
 
 //Effect output
@@ -138,8 +132,7 @@ void EQ::out(const Stereo<float *> &smp)
     for(int i = 0; i < MAX_EQ_BANDS; ++i) {
         if(filter[i].Ptype == 0)
             continue;
-        filter[i].l->filterout(efxoutl);
-        filter[i].r->filterout(efxoutr);
+        filter[i].f->filterout(efxoutl, efxoutr);
     }
 }
 
@@ -201,35 +194,29 @@ void EQ::changepar(int npar, unsigned char value)
             filter[nb].Ptype = value;
             if(value > 9)
                 filter[nb].Ptype = 0;  //has to be changed if more filters will be added
-            if(filter[nb].Ptype != 0) {
-                filter[nb].l->settype(value - 1);
-                filter[nb].r->settype(value - 1);
-            }
+            if(filter[nb].Ptype != 0)
+                filter[nb].f->settype(value - 1);
             break;
         case 1:
             filter[nb].Pfreq = value;
             tmp = 600.0f * powf(30.0f, (value - 64.0f) / 64.0f);
-            filter[nb].l->setfreq(tmp);
-            filter[nb].r->setfreq(tmp);
+            filter[nb].f->setfreq(tmp);
             break;
         case 2:
             filter[nb].Pgain = value;
             tmp = 30.0f * (value - 64.0f) / 64.0f;
-            filter[nb].l->setgain(tmp);
-            filter[nb].r->setgain(tmp);
+            filter[nb].f->setgain(tmp);
             break;
         case 3:
             filter[nb].Pq = value;
             tmp = powf(30.0f, (value - 64.0f) / 64.0f);
-            filter[nb].l->setq(tmp);
-            filter[nb].r->setq(tmp);
+            filter[nb].f->setq(tmp);
             break;
         case 4:
             filter[nb].Pstages = value;
             if(value >= MAX_FILTER_STAGES)
                 filter[nb].Pstages = MAX_FILTER_STAGES - 1;
-            filter[nb].l->setstages(value);
-            filter[nb].r->setstages(value);
+            filter[nb].f->setstages(value);
             break;
     }
 }
@@ -276,7 +263,7 @@ float EQ::getfreqresponse(float freq)
     for(int i = 0; i < MAX_EQ_BANDS; ++i) {
         if(filter[i].Ptype == 0)
             continue;
-        resp *= filter[i].l->H(freq);
+        resp *= filter[i].f->H(freq);
     }
     return rap2dB(resp * outvolume);
 }
@@ -292,8 +279,8 @@ void EQ::getFilter(float *a, float *b) const
         auto &F = filter[i];
         if(F.Ptype == 0)
             continue;
-        const double Fb[3] = {F.l->coeff.c[0], F.l->coeff.c[1], F.l->coeff.c[2]};
-        const double Fa[3] = {1.0f, -F.l->coeff.d[1], -F.l->coeff.d[2]};
+        const double Fb[3] = {F.f->coeff.c[0], F.f->coeff.c[1], F.f->coeff.c[2]};
+        const double Fa[3] = {1.0f, -F.f->coeff.d[1], -F.f->coeff.d[2]};
 
         for(int j=0; j<F.Pstages+1; ++j) {
             for(int k=0; k<3; ++k) {
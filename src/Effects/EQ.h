@@ -52,7 +52,7 @@ class EQ:public Effect
              * you are just looking to do a batch convolution in the end
              * Perhaps some static functions to do the filter design?
              */
-            class AnalogFilter *l, *r;
+            class AnalogFilter *f; //filters both channels
         } filter[MAX_EQ_BANDS];
 };
 
@@ -17,9 +17,12 @@
 #include <rtosc/ports.h>
 #include <rtosc/port-sugar.h>
 #include "../Misc/Allocator.h"
+#include "../DSP/DelayLine.h"
 #include "Echo.h"
 
 #define MAX_DELAY 2
+//Largest number of samples processed at once
+#define ECHO_BLOCK 64
 
 namespace zyn {
 
@@ -71,10 +74,9 @@ Echo::Echo(EffectParams pars)
       delayTime(1),
       lrdelay(0),
       avgDelay(0),
-      delay(memory.valloc<float>(MAX_DELAY * pars.srate),
-            memory.valloc<float>(MAX_DELAY * pars.srate)),
+      delay(memory.alloc<DelayLine>(memory, MAX_DELAY * pars.srate),
+            memory.alloc<DelayLine>(memory, MAX_DELAY * pars.srate)),
       old(0.0f),
-      pos(0),
       delta(1),
       ndelta(1)
 {
@@ -84,15 +86,15 @@ Echo::Echo(EffectParams pars)
 
 Echo::~Echo()
 {
-    memory.devalloc(delay.l);
-    memory.devalloc(delay.r);
+    memory.dealloc(delay.l);
+    memory.dealloc(delay.r);
 }
 
 //Cleanup the effect
 void Echo::cleanup(void)
 {
-    memset(delay.l, 0, MAX_DELAY * samplerate * sizeof(float));
-    memset(delay.r, 0, MAX_DELAY * samplerate * sizeof(float));
+    delay.l->clear();
+    delay.r->clear();
     old = Stereo<float>(0.0f);
 }
 
@@ -119,36 +121,73 @@ void Echo::initdelays(void)
 //Effect output
 void Echo::out(const Stereo<float *> &input)
 {
-    for(int i = 0; i < buffersize; ++i) {
-        float ldl = delay.l[pos.l];
-        float rdl = delay.r[pos.r];
-        ldl = ldl * (1.0f - lrcross) + rdl * lrcross;
-        rdl = rdl * (1.0f - lrcross) + ldl * lrcross;
-
-        efxoutl[i] = ldl * 2.0f;
-        efxoutr[i] = rdl * 2.0f;
-
-        ldl = input.l[i] * pangainL - ldl * fb;
-        rdl = input.r[i] * pangainR - rdl * fb;
-
-        //LowPass Filter
-        old.l = delay.l[(pos.l + delta.l) % (MAX_DELAY * samplerate)] =
-                    ldl * hidamp + old.l * (1.0f - hidamp);
-        old.r = delay.r[(pos.r + delta.r) % (MAX_DELAY * samplerate)] =
-                    rdl * hidamp + old.r * (1.0f - hidamp);
-
-        //increment
-        ++pos.l; // += delta.l;
-        ++pos.r; // += delta.r;
-
-        //ensure that pos is still in bounds
-        pos.l %= MAX_DELAY * samplerate;
-        pos.r %= MAX_DELAY * samplerate;
-
-        //adjust delay if needed
-        delta.l = (15 * delta.l + ndelta.l) / 16;
-        delta.r = (15 * delta.r + ndelta.r) / 16;
+    for(int i = 0; i < buffersize;) {
+        if(delta.l != ndelta.l || delta.r != ndelta.r) {
+            outsample(input, i++);
+            continue;
+        }
+        //no sample of a block may be read back within the same block
+        int n = buffersize - i;
+        if(n > ECHO_BLOCK)
+            n = ECHO_BLOCK;
+        if(n > delta.l)
+            n = delta.l;
+        if(n > delta.r)
+            n = delta.r;
+        outblock(input, i, n);
+        i += n;
+    }
+}
+
+void Echo::outblock(const Stereo<float *> &input, int i, int n)
+{
+    float ldl[ECHO_BLOCK], rdl[ECHO_BLOCK];
+    delay.l->read(delta.l, ldl, n);
+    delay.r->read(delta.r, rdl, n);
+
+    for(int k = 0; k < n; ++k) {
+        const float l = ldl[k] * (1.0f - lrcross) + rdl[k] * lrcross;
+        const float r = rdl[k] * (1.0f - lrcross) + l * lrcross;
+
+        efxoutl[i + k] = l * 2.0f;
+        efxoutr[i + k] = r * 2.0f;
+
+        ldl[k] = input.l[i + k] * pangainL - l * fb;
+        rdl[k] = input.r[i + k] * pangainR - r * fb;
+    }
+
+    //LowPass Filter, a recurrence and therefore one sample at a time
+    for(int k = 0; k < n; ++k) {
+        old.l = ldl[k] = ldl[k] * hidamp + old.l * (1.0f - hidamp);
+        old.r = rdl[k] = rdl[k] * hidamp + old.r * (1.0f - hidamp);
     }
+
+    delay.l->write(ldl, n);
+    delay.r->write(rdl, n);
+}
+
+void Echo::outsample(const Stereo<float *> &input, int i)
+{
+    float ldl = delay.l->read(delta.l);
+    float rdl = delay.r->read(delta.r);
+    ldl = ldl * (1.0f - lrcross) + rdl * lrcross;
+    rdl = rdl * (1.0f - lrcross) + ldl * lrcross;
+
+    efxoutl[i] = ldl * 2.0f;
+    efxoutr[i] = rdl * 2.0f;
+
+    ldl = input.l[i] * pangainL - ldl * fb;
+    rdl = input.r[i] * pangainR - rdl * fb;
+
+    //LowPass Filter
+    old.l = ldl * hidamp + old.l * (1.0f - hidamp);
+    old.r = rdl * hidamp + old.r * (1.0f - hidamp);
+    delay.l->write(old.l);
+    delay.r->write(old.r);
+
+    //adjust delay if needed
+    delta.l = (15 * delta.l + ndelta.l) / 16;
+    delta.r = (15 * delta.r + ndelta.r) / 16;
 }
 
 
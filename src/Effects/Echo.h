@@ -19,6 +19,8 @@
 
 namespace zyn {
 
+class DelayLine;
+
 /**Echo Effect*/
 class Echo:public Effect
 {
@@ -86,13 +88,15 @@ class Echo:public Effect
         float       avgDelay;
 
         void initdelays(void);
+        //Runs n samples whose delayed input was written before them
+        void outblock(const Stereo<float *> &input, int i, int n);
+        //Runs one sample while the delay is being smoothed
+        void outsample(const Stereo<float *> &input, int i);
         //2 channel ring buffer
-        Stereo<float *> delay;
-        Stereo<float>   old;
+        Stereo<DelayLine *> delay;
+        Stereo<float>       old;
 
-        //position of reading/writing from delaysample
-        Stereo<int> pos;
-        //step size for delay buffer
+        //current and target delay in samples
         Stereo<int> delta;
         Stereo<int> ndelta;
 };
@@ -21,10 +21,10 @@ namespace zyn {
 
 EffectParams::EffectParams(Allocator &alloc_, bool insertion_, float *efxoutl_, float *efxoutr_,
             unsigned char Ppreset_, unsigned int srate_, int bufsize_, FilterParams *filterpars_,
-            bool filterprotect_)
+            bool filterprotect_, prng_t seed_)
     :alloc(alloc_), insertion(insertion_), efxoutl(efxoutl_), efxoutr(efxoutr_),
      Ppreset(Ppreset_), srate(srate_), bufsize(bufsize_), filterpars(filterpars_),
-     filterprotect(filterprotect_)
+     filterprotect(filterprotect_), seed(seed_)
 {}
 Effect::Effect(EffectParams pars)
     :Ppreset(pars.Ppreset),
@@ -24,6 +24,10 @@
 #define rEffPar(name, idx, ...) \
   {STRINGIFY(name) "::i",  rProp(parameter) rDefaultDepends(preset) \
       rLinear(0,127) DOC(__VA_ARGS__), NULL, rEffParCb(idx)}
+//like rEffPar, for parameters with a narrower range given as rLinear()
+#define rEffParRange(name, idx, ...) \
+  {STRINGIFY(name) "::i",  rProp(parameter) rDefaultDepends(preset) \
+      DOC(__VA_ARGS__), NULL, rEffParCb(idx)}
 #define rEffParOpt(name, idx, ...) \
   {STRINGIFY(name) "::i:c:S",  rProp(parameter) rDefaultDepends(preset) \
    rProp(enumerated) DOC(__VA_ARGS__), NULL, \
@@ -89,10 +93,12 @@ struct EffectParams
      * @param efxoutr_     Effect output buffer Right channel
      * @param filterpars_  pointer to FilterParams array
      * @param Ppreset_     chosen preset
+     * @param seed_        seed of the effect's random generators, which
+     *                     should differ between instances
      * @return Initialized Effect Parameter object*/
     EffectParams(Allocator &alloc_, bool insertion_, float *efxoutl_, float *efxoutr_,
             unsigned char Ppreset_, unsigned int srate, int bufsize, FilterParams *filterpars_,
-            bool filterprotect=false);
+            bool filterprotect=false, prng_t seed_=0x1234);
 
 
     Allocator &alloc;
@@ -104,6 +110,7 @@ struct EffectParams
     int bufsize;
     FilterParams *filterpars;
     bool filterprotect;
+    prng_t seed;
 };
 
 /**this class is inherited by the all effects(Reverb, Echo, ..)*/
@@ -19,17 +19,18 @@
 
 namespace zyn {
 
-EffectLFO::EffectLFO(float srate_f, float bufsize_f)
+EffectLFO::EffectLFO(float srate_f, float bufsize_f, prng_t seed)
     :Pfreq(40),
       Prandomness(0),
       PLFOtype(0),
       Pstereo(64),
+      rnd_state(seed),
       xl(0.0f),
       xr(0.0f),
-      ampl1(RND),
-      ampl2(RND),
-      ampr1(RND),
-      ampr2(RND),
+      ampl1(rnd_r(rnd_state)),
+      ampl2(rnd_r(rnd_state)),
+      ampr1(rnd_r(rnd_state)),
+      ampr2(rnd_r(rnd_state)),
       lfornd(0.0f),
       samplerate_f(srate_f),
       buffersize_f(bufsize_f)
@@ -82,29 +83,44 @@ float EffectLFO::getlfoshape(float x)
 //LFO output
 void EffectLFO::effectlfoout(float *outl, float *outr)
 {
-    float out;
+    effectlfoout(outl, outr, 1);
+}
+
+void EffectLFO::effectlfoout(float *outl, float *outr, int voices)
+{
+    for(int v = 0; v < voices; ++v) {
+        const float offset = v / (float)voices;
+        float x, out;
+
+        x = xl + offset;
+        if(x > 1.0f)
+            x -= 1.0f;
+        out = getlfoshape(x);
+        if((lfotype == 0) || (lfotype == 1))
+            out *= (ampl1 + xl * (ampl2 - ampl1));
+        outl[v] = (out + 1.0f) * 0.5f;
+
+        x = xr + offset;
+        if(x > 1.0f)
+            x -= 1.0f;
+        out = getlfoshape(x);
+        if((lfotype == 0) || (lfotype == 1))
+            out *= (ampr1 + xr * (ampr2 - ampr1));
+        outr[v] = (out + 1.0f) * 0.5f;
+    }
 
-    out = getlfoshape(xl);
-    if((lfotype == 0) || (lfotype == 1))
-        out *= (ampl1 + xl * (ampl2 - ampl1));
     xl += incx;
     if(xl > 1.0f) {
         xl   -= 1.0f;
         ampl1 = ampl2;
-        ampl2 = (1.0f - lfornd) + lfornd * RND;
+        ampl2 = (1.0f - lfornd) + lfornd * rnd_r(rnd_state);
     }
-    *outl = (out + 1.0f) * 0.5f;
-
-    out = getlfoshape(xr);
-    if((lfotype == 0) || (lfotype == 1))
-        out *= (ampr1 + xr * (ampr2 - ampr1));
     xr += incx;
     if(xr > 1.0f) {
         xr   -= 1.0f;
         ampr1 = ampr2;
-        ampr2 = (1.0f - lfornd) + lfornd * RND;
+        ampr2 = (1.0f - lfornd) + lfornd * rnd_r(rnd_state);
     }
-    *outr = (out + 1.0f) * 0.5f;
 }
 
 }
@@ -14,6 +14,8 @@
 #ifndef EFFECT_LFO_H
 #define EFFECT_LFO_H
 
+#include "../Misc/Util.h"
+
 namespace zyn {
 
 /**LFO for some of the Effect objects
@@ -21,9 +23,11 @@ namespace zyn {
 class EffectLFO
 {
     public:
-        EffectLFO(float srate_f, float bufsize_f);
+        EffectLFO(float srate_f, float bufsize_f, prng_t seed);
         ~EffectLFO();
         void effectlfoout(float *outl, float *outr);
+        /**Output of voices LFOs per channel, with evenly spaced phases*/
+        void effectlfoout(float *outl, float *outr, int voices);
         void updateparams(void);
         unsigned char Pfreq;
         unsigned char Prandomness;
@@ -32,6 +36,7 @@ class EffectLFO
     private:
         float getlfoshape(float x);
 
+        prng_t rnd_state; //own generator, for reproducible renders
         float xl, xr;
         float incx;
         float ampl1, ampl2, ampr1, ampr2; //necessary for "randomness"
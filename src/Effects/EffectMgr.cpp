@@ -26,6 +26,7 @@
 #include "EQ.h"
 #include "DynamicFilter.h"
 #include "Phaser.h"
+#include "Convolution.h"
 #include "../Misc/XMLwrapper.h"
 #include "../Misc/Util.h"
 #include "../Params/FilterParams.h"
@@ -132,7 +133,7 @@ static const rtosc::Ports local_ports = {
             d.reply(d.loc, "bb", sizeof(a), a, sizeof(b), b);
         }},
     {"efftype::i:c:S", rOptions(Disabled, Reverb, Echo, Chorus,
-     Phaser, Alienwah, Distortion, EQ, DynFilter) rDefault(Disabled)
+     Phaser, Alienwah, Distortion, EQ, DynFilter, Convolution) rDefault(Disabled)
      rProp(parameter) rDoc("Get Effect Type"), NULL,
      rCOptionCb(obj->nefx, obj->changeeffectrt(var))},
     {"efftype:b", rProp(internal) rDoc("Pointer swap EffectMgr"), NULL,
@@ -146,14 +147,36 @@ static const rtosc::Ports local_ports = {
             std::swap(eff->nefx,eff_->nefx);
             std::swap(eff->efx,eff_->efx);
             std::swap(eff->filterpars,eff_->filterpars);
+            std::swap(eff->ir,eff_->ir);
             std::swap(eff->efxoutl, eff_->efxoutl);
             std::swap(eff->efxoutr, eff_->efxoutr);
 
             //Return the old data for destruction
             d.reply("/free", "sb", "EffectMgr", sizeof(EffectMgr*), &eff_);
         }},
+    {"ir:b", rProp(internal) rDoc("Pointer swap of the impulse response"), NULL,
+        [](const char *msg, rtosc::RtData &d)
+        {
+            EffectMgr     *eff = (EffectMgr*)d.obj;
+            ConvolutionIR *ir  = *(ConvolutionIR**)rtosc_argument(msg,0).b.data;
+
+            eff->swapimpulse(ir);
+
+            //Return the old data for destruction
+            if(ir)
+                d.reply("/free", "sb", "ConvolutionIR",
+                        sizeof(ConvolutionIR*), &ir);
+        }},
+    {"irfile:", rDoc("File of the impulse response of the Convolution effect"),
+        NULL,
+        [](const char *, rtosc::RtData &d)
+        {
+            EffectMgr *eff = (EffectMgr*)d.obj;
+            d.reply(d.loc, "s", eff->ir ? eff->ir->filename.c_str() : "");
+        }},
     rSubtype(Alienwah),
     rSubtype(Chorus),
+    rSubtype(Convolution),
     rSubtype(Distorsion),
     rSubtype(DynamicFilter),
     rSubtype(Echo),
@@ -170,9 +193,11 @@ EffectMgr::EffectMgr(Allocator &alloc, const SYNTH_T &synth_,
       efxoutl(new float[synth_.buffersize]),
       efxoutr(new float[synth_.buffersize]),
       filterpars(new FilterParams(in_effect, time_)),
+      ir(NULL),
       nefx(0),
       efx(NULL),
       time(time_),
+      seed(prng()),
       dryonly(false),
       memory(alloc),
       synth(synth_)
@@ -189,6 +214,7 @@ EffectMgr::~EffectMgr()
 {
     memory.dealloc(efx);
     delete filterpars;
+    delete ir;
     delete [] efxoutl;
     delete [] efxoutr;
 }
@@ -211,7 +237,7 @@ void EffectMgr::changeeffectrt(int _nefx, bool avoidSmash)
     memset(efxoutr, 0, synth.bufferbytes);
     memory.dealloc(efx);
     EffectParams pars(memory, insertion, efxoutl, efxoutr, 0,
-            synth.samplerate, synth.buffersize, filterpars, avoidSmash);
+            synth.samplerate, synth.buffersize, filterpars, avoidSmash, seed);
     try {
         switch (nefx) {
             case 1:
@@ -238,6 +264,10 @@ void EffectMgr::changeeffectrt(int _nefx, bool avoidSmash)
             case 8:
                 efx = memory.alloc<DynamicFilter>(pars);
                 break;
+            case 9:
+                efx = memory.alloc<Convolution>(pars);
+                static_cast<Convolution*>(efx)->setimpulse(ir);
+                break;
             //put more effect here
             default:
                 efx = NULL;
@@ -398,8 +428,8 @@ void EffectMgr::out(float *smpsl, float *smpsr)
             v1 = (1.0f - volume) * 2.0f;
             v2 = 1.0f;
         }
-        if((nefx == 1) || (nefx == 2))
-            v2 *= v2;  //for Reverb and Echo, the wet function is not liniar
+        if((nefx == 1) || (nefx == 2) || (nefx == 9))
+            v2 *= v2;  //for Reverb, Echo and Convolution, the wet function is not liniar
 
         if(dryonly)   //this is used for instrument effect only
             for(int i = 0; i < synth.buffersize; ++i) {
@@ -452,9 +482,24 @@ void EffectMgr::paste(EffectMgr &e)
         std::swap(filterpars, e.filterpars);
         efx->filterpars = filterpars;
     }
+    if(e.ir) {
+        std::swap(ir, e.ir);
+        if(Convolution *c = dynamic_cast<Convolution*>(efx))
+            c->setimpulse(ir);
+    }
     cleanup(); // cleanup the effect and recompute its parameters
 }
 
+void EffectMgr::swapimpulse(ConvolutionIR *&ir_)
+{
+    //the convolvers are made for one buffer size, other ones are unusable
+    if(ir_ && ir_->conv[0] && ir_->blocksize != synth.buffersize)
+        return;
+    std::swap(ir, ir_);
+    if(Convolution *c = dynamic_cast<Convolution*>(efx))
+        c->setimpulse(ir);
+}
+
 void EffectMgr::add2XML(XMLwrapper& xml)
 {
     xml.addpar("type", geteffect());
@@ -487,6 +532,8 @@ void EffectMgr::add2XML(XMLwrapper& xml)
         filterpars->add2XML(xml);
         xml.endbranch();
     }
+    if(nefx == 9 && ir)
+        xml.addparstr("ir_file", ir->filename);
     xml.endbranch();
 }
 
@@ -499,6 +546,7 @@ void EffectMgr::getfromXML(XMLwrapper& xml)
 
     preset = xml.getpar127("preset", preset);
 
+    std::string irfile;
     if(xml.enterbranch("EFFECT_PARAMETERS")) {
         for(int n = 0; n != 128; n++) {
             if(xml.enterbranch("par_no", n) == 0) {
@@ -531,8 +579,27 @@ void EffectMgr::getfromXML(XMLwrapper& xml)
             filterpars->getfromXML(xml);
             xml.exitbranch();
         }
+        irfile = xml.getparstr("ir_file", "");
         xml.exitbranch();
     }
+
+    //XML is loaded outside of the realtime thread, so the response of the
+    //Convolution effect can be loaded right here. A missing or broken one
+    //drops the previous response, which belongs to another file.
+    ConvolutionIR *nir = NULL;
+    if(!irfile.empty()) {
+        nir = new ConvolutionIR;
+        if(nir->loadfile(irfile, synth.samplerate, synth.buffersize)) {
+            std::cerr << "failed to load impulse response " << irfile
+                      << std::endl;
+            delete nir;
+            nir = NULL;
+        }
+    }
+    if(Convolution *c = dynamic_cast<Convolution*>(efx))
+        c->setimpulse(nir);
+    delete ir;
+    ir = nir;
     cleanup();
 }
 
@@ -18,10 +18,12 @@
 
 #include "../Params/FilterParams.h"
 #include "../Params/Presets.h"
+#include "../Misc/Util.h"
 
 namespace zyn {
 
 class Effect;
+class ConvolutionIR;
 class FilterParams;
 class XMLwrapper;
 class Allocator;
@@ -35,6 +37,10 @@ class EffectMgr:public Presets
         ~EffectMgr() override;
 
         void paste(EffectMgr &e);
+        /**Uses ir_ as the impulse response of the Convolution effect and
+         * gives back the previous one in ir_. A response made for another
+         * buffer size is given back unused.*/
+        void swapimpulse(ConvolutionIR *&ir_) REALTIME;
         void add2XML(XMLwrapper& xml) override;
         void defaults(void) REALTIME;
         void getfromXML(XMLwrapper& xml);
@@ -68,6 +74,9 @@ class EffectMgr:public Presets
         float getEQfreqresponse(float freq);
 
         FilterParams *filterpars;
+        /**Impulse response of the Convolution effect (NULL if none).
+         * It is kept across changes of the effect type.*/
+        ConvolutionIR *ir;
 
         static const rtosc::Ports &ports;
         int     nefx;
@@ -78,6 +87,10 @@ class EffectMgr:public Presets
         //Parameters Prior to initialization
         char preset;
 
+        //Seed of the random generators of the effects, drawn once per
+        //instance so that e.g. two Reverbs do not share their random state
+        prng_t seed;
+
         /**
          * When loading an effect from XML the child effect cannot be loaded
          * directly as it would require access to the realtime memory pool,
@@ -16,12 +16,27 @@
 #include "../Misc/Allocator.h"
 #include "../DSP/AnalogFilter.h"
 #include "../DSP/Unison.h"
+#include "../DSP/CombBank.h"
+#include "../DSP/FdnBank.h"
+#include "../DSP/FastMath.h"
 #include <cmath>
 #include <rtosc/ports.h>
 #include <rtosc/port-sugar.h>
 
 namespace zyn {
 
+static_assert(REV_COMBS == COMB_BANK_CHANNEL, "one comb per lane");
+static_assert(REV_COMBS * 2 == FDN_LINES, "one FDN line per comb");
+
+//Size of a delay line holding len samples (a power of two)
+static int ringsize(int len)
+{
+    int size = 1;
+    while(size < len)
+        size *= 2;
+    return size;
+}
+
 #define rObject Reverb
 #define rBegin [](const char *msg, rtosc::RtData &d) {
 #define rEnd }
@@ -29,7 +44,8 @@ namespace zyn {
 rtosc::Ports Reverb::ports = {
     {"preset::i", rOptions(Cathedral1, Cathedral2, Cathedral3,
             Hall1, Hall2, Room1, Room2, Basement,
-            Tunnel, Echoed1, Echoed2, VeryLong1, VeryLong2)
+            Tunnel, Echoed1, Echoed2, VeryLong1, VeryLong2,
+            DenseHall, DenseRoom)
                   rProp(parameter)
                   rDoc("Instrument Presets"), 0,
                   rBegin;
@@ -40,35 +56,37 @@ rtosc::Ports Reverb::ports = {
                       d.reply(d.loc, "i", o->Ppreset);
                   rEnd},
     rEffParVol(rDefault(90), rPresets(80, 80, 80),
-               rPresetsAt(5, 100, 100, 110, 85, 95)),
+               rPresetsAt(5, 100, 100, 110, 85, 95), rPreset(14, 100)),
     rEffParPan(rPreset(8, 80)),
     rEffPar(Ptime,    2, rShort("time"), rLinear(0, 127),
-            rPresets(63, 69, 69, 51, 53, 33, 21, 14, 84, 26, 40, 93, 111),
+            rPresets(63, 69, 69, 51, 53, 33, 21, 14, 84, 26, 40, 93, 111,
+                     72, 30),
             "Length of Reverb"),
     rEffPar(Pidelay,  3, rShort("i.time"),
-            rPresets(24, 35, 24, 10, 20, 0, 26, 0, 20, 60, 88, 15, 30),
+            rPresets(24, 35, 24, 10, 20, 0, 26, 0, 20, 60, 88, 15, 30, 12, 0),
             "Delay for first impulse"),
     rEffPar(Pidelayfb,4, rShort("i.fb"), rPresetsAt(8, 42, 71, 71), rDefault(0),
             "Feedback for first impulse"),
     rEffPar(Plpf,     7, rShort("lpf"),
             rPreset(1, 85), rPresetsAt(62, 127, 51, 114, 114, 114),
-            rDefault(127), "Low pass filter"),
+            rPreset(14, 110), rDefault(127), "Low pass filter"),
     rEffPar(Phpf,     8, rShort("hpf"),
             rPresets(5), rPresetsAt(2, 75, 21, 75), rPreset(7, 50),
-            rPreset(12, 90), rDefault(0), "High pass filter"),
+            rPreset(12, 90), rPreset(13, 10), rDefault(0), "High pass filter"),
     rEffPar(Plohidamp,9, rShort("damp"), rDefault(0),
-            rPresets(83, 71, 78, 78, 71, 106, 77, 71, 78, 64, 88, 77, 74)
+            rPresets(83, 71, 78, 78, 71, 106, 77, 71, 78, 64, 88, 77, 74,
+                     84, 96)
             "Dampening"),
     //Todo make this a selector
     rEffParOpt(Ptype,    10, rShort("type"),
-            rOptions(Random, Freeverb, Bandwidth),
+            rOptions(Random, Freeverb, Bandwidth, FDN),
             rPresets(Freeverb, Random, Freeverb, Freeverb, Freeverb, Random,
                      Freeverb, Random, Freeverb, Freeverb, Freeverb, Random,
-                     Freeverb)
+                     Freeverb, FDN, FDN)
             rDefault(Random), "Type"),
     rEffPar(Proomsize,11,rShort("size"),
             rPreset(2, 85), rPresetsAt(5, 30, 45, 25, 105),
-            rPresetsAt(11, 95, 80), rDefault(64),
+            rPresetsAt(11, 95, 80, 80, 40), rDefault(64),
             "Room Size"),
     rEffPar(Pbandwidth,12,rShort("bw"), rDefault(20), "Bandwidth"),
 };
@@ -95,20 +113,34 @@ Reverb::Reverb(EffectParams pars)
       bandwidth(NULL),
       idelay(NULL),
       lpf(NULL),
-      hpf(NULL) // no filter
+      hpf(NULL), // no filter
+      rnd_state(pars.seed)
 {
     for(int i = 0; i < REV_COMBS * 2; ++i) {
-        comblen[i] = 800 + (int)(RND * 1400.0f);
-        combk[i]   = 0;
-        lpcomb[i]  = 0;
-        combfb[i]  = -0.97f;
-        comb[i]    = NULL;
+        comblen[i]  = 800 + (int)(rnd_r(rnd_state) * 1400.0f);
+        combk[i]    = 0;
+        combmask[i] = 0;
+        combs.lp[i] = 0;
+        combs.fb[i] = -0.97f;
+        comb[i]     = NULL;
+
+        //lines of both channels get the input with alternating signs
+        fdn.glow[i]  = fdn.ghigh[i] = 0.0f;
+        fdn.lp[i]    = 0.0f;
+        fdn.in[i]    = (i % 2) ? -1.0f : 1.0f;
+        fdnphase[i]  = i / (float)FDN_LINES;
+        fdnrate[i]   = (0.5f + 0.07f * i) / samplerate_f;
+        fdndelay[i]  = 0.0f;
     }
+    combs.damp = 0.0f;
+    fdn.cross  = 1.0f - expf(-2.0f * PI * 2500.0f / samplerate_f);
+    fdndepth   = 6.0f * samplerate_f / 44100.0f;
 
     for(int i = 0; i < REV_APS * 2; ++i) {
-        aplen[i] = 500 + (int)(RND * 500.0f);
-        apk[i]   = 0;
-        ap[i]    = NULL;
+        aplen[i]  = 500 + (int)(rnd_r(rnd_state) * 500.0f);
+        apk[i]    = 0;
+        apmask[i] = 0;
+        ap[i]     = NULL;
     }
     setpreset(Ppreset);
     cleanup(); //do not call this before the comb initialisation
@@ -133,14 +165,13 @@ Reverb::~Reverb()
 void Reverb::cleanup(void)
 {
     for(int i = 0; i < REV_COMBS * 2; ++i) {
-        lpcomb[i] = 0.0f;
-        for(int j = 0; j < comblen[i]; ++j)
-            comb[i][j] = 0.0f;
+        combs.lp[i] = 0.0f;
+        fdn.lp[i]   = 0.0f;
+        memset(comb[i], 0, (combmask[i] + 1) * sizeof(float));
     }
 
     for(int i = 0; i < REV_APS * 2; ++i)
-        for(int j = 0; j < aplen[i]; ++j)
-            ap[i][j] = 0.0f;
+        memset(ap[i], 0, (apmask[i] + 1) * sizeof(float));
 
     if(idelay)
         for(int i = 0; i < idelaylen; ++i)
@@ -151,38 +182,153 @@ void Reverb::cleanup(void)
         lpf->cleanup();
 }
 
-//Process one channel; 0=left, 1=right
-void Reverb::processmono(int ch, float *output, float *inputbuf)
+//Run the combs of both channels together, adding them to efxoutl/efxoutr
+void Reverb::processcombs(const float *inputbuf)
 {
     //todo: implement the high part from lohidamp
 
-    for(int j = REV_COMBS * ch; j < REV_COMBS * (ch + 1); ++j) {
-        int &ck = combk[j];
-        const int comblength = comblen[j];
-        float    &lpcombj    = lpcomb[j];
+    //a pass must not read what it writes itself
+    int maxn = COMB_BANK_BLOCK;
+    for(int j = 0; j < REV_COMBS * 2; ++j)
+        if(comblen[j] < maxn)
+            maxn = comblen[j];
+
+    alignas(32) CombLaneBuffer delayed, written;
+    for(int start = 0; start < buffersize; start += maxn) {
+        const int n = buffersize - start < maxn ? buffersize - start : maxn;
+
+        for(int j = 0; j < REV_COMBS * 2; ++j) {
+            const float *c    = comb[j];
+            const int    mask = combmask[j];
+            const int    k    = (combk[j] - comblen[j]) & mask;
+            for(int i = 0; i < n; ++i)
+                delayed[i][j] = c[(k + i) & mask];
+        }
 
-        for(int i = 0; i < buffersize; ++i) {
-            float fbout = comb[j][ck] * combfb[j];
-            fbout   = fbout * (1.0f - lohifb) + lpcombj * lohifb;
-            lpcombj = fbout;
+        combBank(combs, inputbuf + start, delayed, written,
+                 efxoutl + start, efxoutr + start, n);
 
-            comb[j][ck] = inputbuf[i] + fbout;
-            output[i]  += fbout;
+        for(int j = 0; j < REV_COMBS * 2; ++j) {
+            float    *c    = comb[j];
+            const int mask = combmask[j];
+            const int k    = combk[j];
+            for(int i = 0; i < n; ++i)
+                c[(k + i) & mask] = written[i][j];
+            combk[j] = (k + n) & mask;
+        }
+    }
+}
 
-            if((++ck) >= comblength)
-                ck = 0;
+//Run the allpasses of both channels, one stage after the other
+void Reverb::processallpasses(void)
+{
+    float *const output[2] = {efxoutl, efxoutr};
+    for(int s = 0; s < REV_APS; ++s) {
+        const int l = s, r = REV_APS + s;
+        int maxn = aplen[l] < aplen[r] ? aplen[l] : aplen[r];
+        if(maxn > COMB_BANK_BLOCK)
+            maxn = COMB_BANK_BLOCK;
+
+        for(int start = 0; start < buffersize; start += maxn) {
+            const int n = buffersize - start < maxn ? buffersize - start : maxn;
+            for(int ch = 0; ch < 2; ++ch) {
+                const int j    = ch ? r : l;
+                float    *a    = ap[j];
+                float    *out  = output[ch] + start;
+                const int mask = apmask[j];
+                const int rk   = (apk[j] - aplen[j]) & mask;
+                const int wk   = apk[j];
+                float tmp[COMB_BANK_BLOCK], fb[COMB_BANK_BLOCK];
+
+                for(int i = 0; i < n; ++i)
+                    tmp[i] = a[(rk + i) & mask];
+                for(int i = 0; i < n; ++i) {
+                    fb[i]  = 0.7f * tmp[i] + out[i];
+                    out[i] = tmp[i] - 0.7f * fb[i];
+                }
+                for(int i = 0; i < n; ++i)
+                    a[(wk + i) & mask] = fb[i];
+                apk[j] = (wk + n) & mask;
+            }
         }
     }
+}
 
-    for(int j = REV_APS * ch; j < REV_APS * (1 + ch); ++j) {
-        int &ak = apk[j];
-        const int aplength = aplen[j];
-        for(int i = 0; i < buffersize; ++i) {
-            float tmp = ap[j][ak];
-            ap[j][ak] = 0.7f * tmp + output[i];
-            output[i] = tmp - 0.7f * ap[j][ak];
-            if((++ak) >= aplength)
-                ak = 0;
+//Run the feedback delay network, adding it to efxoutl/efxoutr
+void Reverb::processfdn(const float *inputbuf)
+{
+    //a chunk must not read what it writes itself
+    const int reach = (int)ceilf(fdndepth) + 2;
+    int maxn = FDN_BLOCK;
+    for(int j = 0; j < FDN_LINES; ++j)
+        if(comblen[j] - reach < maxn)
+            maxn = comblen[j] - reach;
+
+    alignas(32) FdnLaneBuffer delayed, written;
+    for(int start = 0; start < buffersize; start += maxn) {
+        const int n = buffersize - start < maxn ? buffersize - start : maxn;
+
+        //The odd lines keep their delay and read whole samples
+        for(int j = 1; j < FDN_LINES; j += 2) {
+            const float *c    = comb[j];
+            const int    mask = combmask[j];
+            const int    src  = (combk[j] - comblen[j]) & mask;
+            if(src + n <= mask + 1)
+                for(int i = 0; i < n; ++i)
+                    delayed[i][j] = c[src + i];
+            else
+                for(int i = 0; i < n; ++i)
+                    delayed[i][j] = c[(src + i) & mask];
+        }
+
+        //The delay of the even lines moves linearly within a chunk, by far
+        //less than a sample. All reads of a chunk use the same two taps per
+        //sample, which keeps them contiguous (the fraction may go slightly
+        //beyond [0, 1])
+        for(int j = 0; j < FDN_LINES; j += 2) {
+            fdnphase[j] += n * fdnrate[j];
+            if(fdnphase[j] >= 1.0f)
+                fdnphase[j] -= 1.0f;
+            const float d0 = fdndelay[j];
+            const float d1 = comblen[j]
+                             + fdndepth * fast_sin(2.0f * PI * fdnphase[j]);
+            const float dd = (d1 - d0) / n;
+            fdndelay[j] = d1;
+
+            const float *c    = comb[j];
+            const int    mask = combmask[j];
+            const int    di   = (int)(0.5f * (d0 + d1));
+            const int    src  = (combk[j] - di - 1) & mask; //oldest sample read
+            const float  fr0  = d0 - di;
+            if(src + n + 1 <= mask + 1) {
+                const float *p = c + src;
+                for(int i = 0; i < n; ++i) {
+                    const float fr = fr0 + dd * (i + 1);
+                    delayed[i][j] = p[i + 1] + fr * (p[i] - p[i + 1]);
+                }
+            } else
+                for(int i = 0; i < n; ++i) {
+                    const float fr = fr0 + dd * (i + 1);
+                    const float a  = c[(src + i + 1) & mask];
+                    const float b  = c[(src + i) & mask];
+                    delayed[i][j] = a + fr * (b - a);
+                }
+        }
+
+        fdnBank(fdn, inputbuf + start, delayed, written,
+                efxoutl + start, efxoutr + start, n);
+
+        for(int j = 0; j < FDN_LINES; ++j) {
+            float    *c    = comb[j];
+            const int mask = combmask[j];
+            const int k    = combk[j];
+            if(k + n <= mask + 1)
+                for(int i = 0; i < n; ++i)
+                    c[k + i] = written[i][j];
+            else
+                for(int i = 0; i < n; ++i)
+                    c[(k + i) & mask] = written[i][j];
+            combk[j] = (k + n) & mask;
         }
     }
 }
@@ -216,8 +362,12 @@ void Reverb::out(const Stereo<float *> &smp)
     if(hpf)
         hpf->filterout(inputbuf);
 
-    processmono(0, efxoutl, inputbuf); //left
-    processmono(1, efxoutr, inputbuf); //right
+    if(Ptype == 3)
+        processfdn(inputbuf);
+    else {
+        processcombs(inputbuf);
+        processallpasses();
+    }
 
     float lvol = rs / REV_COMBS * pangainL;
     float rvol = rs / REV_COMBS * pangainR;
@@ -257,9 +407,23 @@ void Reverb::settime(unsigned char _Ptime)
     float t = powf(60.0f, Ptime / 127.0f) - 0.97f;
 
     for(int i = 0; i < REV_COMBS * 2; ++i)
-        combfb[i] =
+        combs.fb[i] =
             -expf((float)comblen[i] / samplerate_f * logf(0.001f) / t);
     //the feedback is negative because it removes the DC
+    setfdngains();
+}
+
+//Gains of the FDN lines for a decay to -60dB after the reverb time,
+//which is shortened above the crossover by the damping
+void Reverb::setfdngains(void)
+{
+    const float t     = powf(60.0f, Ptime / 127.0f) - 0.97f;
+    const float thigh = t * (1.0f - 0.9f * (Plohidamp - 64) / 64.1f);
+    for(int i = 0; i < FDN_LINES; ++i) {
+        const float len = (float)comblen[i] / samplerate_f * logf(0.001f);
+        fdn.glow[i]  = expf(len / t);
+        fdn.ghigh[i] = expf(len / thigh);
+    }
 }
 
 void Reverb::setlohidamp(unsigned char _Plohidamp)
@@ -268,7 +432,7 @@ void Reverb::setlohidamp(unsigned char _Plohidamp)
     //remove this when the high part from lohidamp is added
     if(Plohidamp == 64) {
         lohidamptype = 0;
-        lohifb = 0.0f;
+        combs.damp = 0.0f;
     }
     else {
         if(Plohidamp < 64)
@@ -276,8 +440,9 @@ void Reverb::setlohidamp(unsigned char _Plohidamp)
         if(Plohidamp > 64)
             lohidamptype = 2;
         float x = fabsf((float)(Plohidamp - 64) / 64.1f);
-        lohifb = x * x;
+        combs.damp = x * x;
     }
+    setfdngains();
 }
 
 void Reverb::setidelay(unsigned char _Pidelay)
@@ -335,14 +500,21 @@ void Reverb::setlpf(unsigned char _Plpf)
 void Reverb::settype(unsigned char _Ptype)
 {
     Ptype = _Ptype;
-    const int NUM_TYPES = 3;
+    const int NUM_TYPES = 4;
     const int combtunings[NUM_TYPES][REV_COMBS] = {
         //this is unused (for random)
         {0,    0,    0,    0,    0,    0,    0,    0      },
         //Freeverb by Jezar at Dreampoint
         {1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617   },
         //duplicate of Freeverb by Jezar at Dreampoint
-        {1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617   }
+        {1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617   },
+        //this is unused (for FDN)
+        {0,    0,    0,    0,    0,    0,    0,    0      }
+    };
+    //FDN lines, primes spread between 12ms and 45ms (left, right)
+    const int fdntunings[FDN_LINES] = {
+        557, 661, 787, 929,  1103, 1307, 1549, 1847,
+        607, 719, 853, 1013, 1201, 1423, 1693, 1999
     };
 
     const int aptunings[NUM_TYPES][REV_APS] = {
@@ -351,7 +523,9 @@ void Reverb::settype(unsigned char _Ptype)
         //Freeverb by Jezar at Dreampoint
         {225, 341, 441, 556  },
         //duplicate of Freeverb by Jezar at Dreampoint
-        {225, 341, 441, 556  }
+        {225, 341, 441, 556  },
+        //this is unused (for FDN)
+        {0,   0,   0,   0    }
     };
 
     if(Ptype >= NUM_TYPES)
@@ -361,28 +535,38 @@ void Reverb::settype(unsigned char _Ptype)
     float samplerate_adjust = samplerate_f / 44100.0f;
     float tmp;
     for(int i = 0; i < REV_COMBS * 2; ++i) {
+        int reach = 0; //beyond comblen
         if(Ptype == 0)
-            tmp = 800.0f + (int)(RND * 1400.0f);
+            tmp = 800.0f + (int)(rnd_r(rnd_state) * 1400.0f);
+        else if(Ptype == 3)
+            tmp = fdntunings[i];
         else
             tmp = combtunings[Ptype][i % REV_COMBS];
         tmp *= roomsize;
-        if(i > REV_COMBS)
+        if(i > REV_COMBS && Ptype != 3)
             tmp += 23.0f;
         tmp *= samplerate_adjust; //adjust the combs according to the samplerate
         if(tmp < 10.0f)
             tmp = 10.0f;
-        combk[i]   = 0;
-        lpcomb[i]  = 0;
-        if(comblen[i] != (int)tmp || comb[i] == NULL) {
-            comblen[i] = (int) tmp;
+        if(Ptype == 3) { //room for the modulation and a few samples per chunk
+            reach = (int)ceilf(fdndepth) + 2;
+            if(tmp < reach + 8)
+                tmp = reach + 8;
+        }
+        combk[i]    = 0;
+        combs.lp[i] = 0;
+        comblen[i]  = (int) tmp;
+        fdndelay[i] = comblen[i];
+        if(comb[i] == NULL || combmask[i] + 1 != ringsize(comblen[i] + reach)) {
+            combmask[i] = ringsize(comblen[i] + reach) - 1;
             memory.devalloc(comb[i]);
-            comb[i] = memory.valloc<float>(comblen[i]);
+            comb[i] = memory.valloc<float>(combmask[i] + 1);
         }
     }
 
     for(int i = 0; i < REV_APS * 2; ++i) {
         if(Ptype == 0)
-            tmp = 500 + (int)(RND * 500.0f);
+            tmp = 500 + (int)(rnd_r(rnd_state) * 500.0f);
         else
             tmp = aptunings[Ptype][i % REV_APS];
         tmp *= roomsize;
@@ -392,10 +576,11 @@ void Reverb::settype(unsigned char _Ptype)
         if(tmp < 10)
             tmp = 10;
         apk[i]   = 0;
-        if(aplen[i] != (int)tmp || ap[i] == NULL) {
-            aplen[i] = (int) tmp;
+        aplen[i] = (int) tmp;
+        if(ap[i] == NULL || apmask[i] + 1 != ringsize(aplen[i])) {
+            apmask[i] = ringsize(aplen[i]) - 1;
             memory.devalloc(ap[i]);
-            ap[i] = memory.valloc<float>(aplen[i]);
+            ap[i] = memory.valloc<float>(apmask[i] + 1);
         }
     }
     memory.dealloc(bandwidth);
@@ -404,7 +589,8 @@ void Reverb::settype(unsigned char _Ptype)
         //not been verified yet.
         //As this cannot be resized in a RT context, a good upper bound should
         //be found
-        bandwidth = memory.alloc<Unison>(&memory, buffersize / 4 + 1, 2.0f, samplerate_f);
+        bandwidth = memory.alloc<Unison>(&memory, buffersize / 4 + 1, 2.0f, samplerate_f,
+                                         prng_r(rnd_state));
         bandwidth->setSize(50);
         bandwidth->setBaseFrequency(1.0f);
     }
@@ -436,7 +622,7 @@ void Reverb::setbandwidth(unsigned char _Pbandwidth)
 unsigned char Reverb::getpresetpar(unsigned char npreset, unsigned int npar)
 {
 #define	PRESET_SIZE 13
-#define	NUM_PRESETS 13
+#define	NUM_PRESETS 15
     static const unsigned char presets[NUM_PRESETS][PRESET_SIZE] = {
         //Cathedral1
         {80,  64, 63,  24, 0,  0, 0, 85,  5,  83,  1, 64,  20},
@@ -463,7 +649,11 @@ unsigned char Reverb::getpresetpar(unsigned char npreset, unsigned int npar)
         //VeryLong1
         {90,  64, 93,  15, 0,  0, 0, 114, 0,  77,  0, 95,  20},
         //VeryLong2
-        {90,  64, 111, 30, 0,  0, 0, 114, 90, 74,  1, 80,  20}
+        {90,  64, 111, 30, 0,  0, 0, 114, 90, 74,  1, 80,  20},
+        //DenseHall
+        {90,  64, 72,  12, 0,  0, 0, 127, 10, 84,  3, 80,  20},
+        //DenseRoom
+        {100, 64, 30,  0,  0,  0, 0, 110, 0,  96,  3, 40,  20}
     };
     if(npreset < NUM_PRESETS && npar < PRESET_SIZE) {
         if (npar == 0 && insertion != 0) {
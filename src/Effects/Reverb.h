@@ -15,6 +15,8 @@
 #define REVERB_H
 
 #include "Effect.h"
+#include "../DSP/CombBank.h"
+#include "../DSP/FdnBank.h"
 
 #define REV_COMBS 8
 #define REV_APS 4
@@ -60,14 +62,16 @@ class Reverb:public Effect
         void settype(unsigned char _Ptype);
         void setroomsize(unsigned char _Proomsize);
         void setbandwidth(unsigned char _Pbandwidth);
-        void processmono(int ch, float *output, float *inputbuf);
+        void processcombs(const float *inputbuf);
+        void processallpasses(void);
+        void processfdn(const float *inputbuf);
+        void setfdngains(void);
 
 
         //Parameters
         int   lohidamptype;   //0=disable, 1=highdamp (lowpass), 2=lowdamp (highpass)
         int   idelaylen;
         int   idelayk;
-        float lohifb;
         float idelayfb;
         float roomsize;
         float rs;   //rs is used to "normalise" the volume according to the roomsize
@@ -76,14 +80,25 @@ class Reverb:public Effect
         class Unison * bandwidth;
 
         //Internal Variables
+        //The delay lines are rounded up to a power of two, comb j reads
+        //what was written comblen[j] samples before combk[j]
         float *comb[REV_COMBS * 2];
         int    combk[REV_COMBS * 2];
-        float  combfb[REV_COMBS * 2]; //feedback-ul fiecarui filtru "comb"
-        float  lpcomb[REV_COMBS * 2]; //pentru Filtrul LowPass
+        int    combmask[REV_COMBS * 2];
+        CombLanes combs; //feedback and lowpass of the combs (lohifb is damp)
         float *ap[REV_APS * 2];
         int    apk[REV_APS * 2];
+        int    apmask[REV_APS * 2];
         float *idelay;
+        //The FDN type runs on the comb delay lines, with the delays of the
+        //even lines modulated around comblen by up to fdndepth samples
+        FdnLanes fdn;
+        float  fdnphase[FDN_LINES]; //phase of the modulation
+        float  fdnrate[FDN_LINES];  //its frequency (cycles per sample)
+        float  fdndelay[FDN_LINES]; //delay at the end of the last chunk
+        float  fdndepth;
         class AnalogFilter * lpf, *hpf; //filters
+        prng_t rnd_state; //random comb/allpass lengths
 };
 
 }
@@ -14,6 +14,7 @@
 #include <cassert>
 #include <utility>
 #include <cstdio>
+#include <atomic>
 #include "../../tlsf/tlsf.h"
 #include "Allocator.h"
 
@@ -44,6 +45,21 @@ struct AllocatorImpl
     //nice values
     next_t *pools = 0;
     unsigned long long totalAlloced = 0;
+
+    //Guards the tlsf pool when notes are (de)allocated from several render
+    //threads (see WorkerPool). Uncontended in the single threaded case.
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+};
+
+struct AllocatorLock
+{
+    AllocatorLock(AllocatorImpl *impl_) :impl(impl_)
+    {
+        while(impl->lock.test_and_set(std::memory_order_acquire))
+            ;
+    }
+    ~AllocatorLock() { impl->lock.clear(std::memory_order_release); }
+    AllocatorImpl *impl;
 };
 
 Allocator::Allocator(void) : transaction_active()
@@ -72,6 +88,7 @@ Allocator::~Allocator(void)
 
 void *AllocatorClass::alloc_mem(size_t mem_size)
 {
+    AllocatorLock l(impl);
     impl->totalAlloced += mem_size;
     void *mem = tlsf_malloc(impl->tlsf, mem_size);
     //printf("Allocator.malloc(%p, %d) = %p\n", impl, mem_size, mem);
@@ -82,12 +99,14 @@ void *AllocatorClass::alloc_mem(size_t mem_size)
 void AllocatorClass::dealloc_mem(void *memory)
 {
     //printf("dealloc_mem(%d)\n", tlsf_block_size(memory));
+    AllocatorLock l(impl);
     tlsf_free(impl->tlsf, memory);
     //free(memory);
 }
 
 bool AllocatorClass::lowMemory(unsigned n, size_t chunk_size) const
 {
+    AllocatorLock l(impl);
     //This should stay on the stack
     void *buf[n];
     for(unsigned i=0; i<n; ++i)
@@ -105,6 +124,7 @@ bool AllocatorClass::lowMemory(unsigned n, size_t chunk_size) const
 
 void AllocatorClass::addMemory(void *v, size_t mem_size)
 {
+    AllocatorLock l(impl);
     next_t *n = impl->pools;
     while(n->next) n = n->next;
     n->next = (next_t*)v;
@@ -50,6 +50,12 @@ static const rtosc::Ports ports = {
     rToggle(cfg.BankUIAutoClose, "Automatic Closing of BackUI After Patch Selection"),
     rParamI(cfg.GzipCompression, "Level of Gzip Compression For Save Files"),
     rParamI(cfg.Interpolation, "Level of Interpolation, Linear/Cubic"),
+    rParamI(cfg.RenderThreads, "Threads used to render parts (0/1 renders serially)"),
+    rParamI(cfg.PADCacheSize, "Size limit of the PADsynth sample cache in MiB (0 disables it)"),
+    rParamI(cfg.PADCacheMaxAge, "Days after which unused cached PADsynth samples are removed (0 keeps them)"),
+    rToggle(cfg.PADPreview, "Play a quick PADsynth preview while the full quality samples are computed"),
+    rToggle(cfg.PADLazy, "Only compute the PADsynth samples of the octaves which are played"),
+    rParamI(cfg.PADLazyDropTime, "Seconds after which unplayed lazy PADsynth samples are dropped (0 keeps them)"),
     {"cfg.presetsDirList", rDoc("list of preset search directories"), 0,
         [](const char *msg, rtosc::RtData &d)
         {
@@ -207,6 +213,13 @@ void Config::init()
     cfg.GzipCompression = 3;
 
     cfg.Interpolation = 0;
+    cfg.RenderThreads = 0;
+    cfg.PADCacheDir    = "";
+    cfg.PADCacheSize   = 512;
+    cfg.PADCacheMaxAge = 30;
+    cfg.PADPreview     = 1;
+    cfg.PADLazy        = 0;
+    cfg.PADLazyDropTime = 300;
     cfg.CheckPADsynth = 1;
     cfg.IgnoreProgramChange = 0;
 
@@ -336,6 +349,33 @@ void Config::readConfig(const char *filename)
                                            0,
                                            1);
 
+        cfg.RenderThreads  = xmlcfg.getpar("render_threads",
+                                           cfg.RenderThreads,
+                                           0,
+                                           NUM_MIDI_PARTS);
+
+        cfg.PADCacheDir    = xmlcfg.getparstr("pad_cache_dir", "");
+        cfg.PADCacheSize   = xmlcfg.getpar("pad_cache_size",
+                                           cfg.PADCacheSize,
+                                           0,
+                                           1 << 20);
+        cfg.PADCacheMaxAge = xmlcfg.getpar("pad_cache_max_age",
+                                           cfg.PADCacheMaxAge,
+                                           0,
+                                           3650);
+        cfg.PADPreview     = xmlcfg.getpar("pad_preview",
+                                           cfg.PADPreview,
+                                           0,
+                                           1);
+        cfg.PADLazy        = xmlcfg.getpar("pad_lazy",
+                                           cfg.PADLazy,
+                                           0,
+                                           1);
+        cfg.PADLazyDropTime = xmlcfg.getpar("pad_lazy_drop_time",
+                                            cfg.PADLazyDropTime,
+                                            0,
+                                            86400);
+
         cfg.CheckPADsynth = xmlcfg.getpar("check_pad_synth",
                                           cfg.CheckPADsynth,
                                           0,
@@ -446,6 +486,13 @@ void Config::saveConfig(const char *filename) const
         }
 
     xmlcfg->addpar("interpolation", cfg.Interpolation);
+    xmlcfg->addpar("render_threads", cfg.RenderThreads);
+    xmlcfg->addparstr("pad_cache_dir", cfg.PADCacheDir);
+    xmlcfg->addpar("pad_cache_size", cfg.PADCacheSize);
+    xmlcfg->addpar("pad_cache_max_age", cfg.PADCacheMaxAge);
+    xmlcfg->addpar("pad_preview", cfg.PADPreview);
+    xmlcfg->addpar("pad_lazy", cfg.PADLazy);
+    xmlcfg->addpar("pad_lazy_drop_time", cfg.PADLazyDropTime);
 
     //linux stuff
     xmlcfg->addparstr("linux_oss_wave_out_dev", cfg.oss_devs.linux_wave_out);
@@ -46,6 +46,11 @@ class Config
             int   BankUIAutoClose;
             int   GzipCompression;
             int   Interpolation;
+            int   RenderThreads;
+            std::string PADCacheDir;
+            int   PADCacheSize, PADCacheMaxAge;
+            int   PADPreview;
+            int   PADLazy, PADLazyDropTime;
             std::string bankRootDirList[MAX_BANK_ROOT_DIRS], currentBankDir;
             std::string presetsDirList[MAX_BANK_ROOT_DIRS];
             std::string favoriteList[MAX_BANK_ROOT_DIRS];
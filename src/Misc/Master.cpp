@@ -22,8 +22,10 @@
 #include "../Params/LFOParams.h"
 #include "../Effects/EffectMgr.h"
 #include "../DSP/FFTwrapper.h"
+#include "../DSP/FastMath.h"
 #include "../Misc/Allocator.h"
 #include "../Containers/ScratchString.h"
+#include "WorkerPool.h"
 #include "../Nio/Nio.h"
 #include "PresetExtractor.h"
 
@@ -38,6 +40,10 @@
 #include <algorithm>
 #include <cmath>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <unistd.h>
 
 using namespace std;
@@ -816,6 +822,11 @@ Master::Master(const SYNTH_T &synth_, Config* config)
     //Note Visualization
     memset(activeNotes, 0, sizeof(activeNotes));
 
+    //Multithreaded part rendering
+    partpool = nullptr;
+    if(config->cfg.RenderThreads > 1)
+        partpool = new WorkerPool(config->cfg.RenderThreads);
+
     defaults();
 
     mastercb = 0;
@@ -945,14 +956,16 @@ void Master::defaults()
 /*
  * Note On Messages (velocity=0 for NoteOff)
  */
-void Master::noteOn(char chan, note_t note, char velocity, float note_log2_freq)
+void Master::noteOn(char chan, note_t note, char velocity, float note_log2_freq,
+                    int frame_offset)
 {
     if(velocity) {
         for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart) {
             if(chan == part[npart]->Prcvchn) {
                 fakepeakpart[npart] = velocity * 2;
                 if(part[npart]->Penabled)
-                    part[npart]->NoteOn(note, velocity, keyshift, note_log2_freq);
+                    part[npart]->NoteOn(note, velocity, keyshift, note_log2_freq,
+                                        frame_offset);
             }
         }
         activeNotes[note] = 1;
@@ -1263,9 +1276,18 @@ bool Master::AudioOut(float *outr, float *outl)
     memset(outr, 0, synth.bufferbytes);
 
     //Compute part samples and store them part[npart]->partoutl,partoutr
-    for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
-        if(part[npart]->Penabled)
-            part[npart]->ComputePartSmps();
+    //Active watchpoints share one output queue, so they force serial rendering
+    if(partpool && !watcher.any_active()) {
+        int nparts = 0;
+        for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+            if(part[npart]->Penabled)
+                renderparts[nparts++] = part[npart];
+        partpool->run(renderPart, this, nparts);
+    } else {
+        for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+            if(part[npart]->Penabled)
+                part[npart]->ComputePartSmps();
+    }
 
     //Insertion effects
     for(int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
@@ -1382,7 +1404,7 @@ bool Master::AudioOut(float *outr, float *outl)
         if(Pinsparts[nefx] == -2)
             insefx[nefx]->out(outl, outr);
 
-    float vol = dB2rap(Volume);
+    float vol = fast_dB2rap(Volume);
 
     //Master Volume
     /* this is where the master volume smoothing and application happens */
@@ -1477,8 +1499,14 @@ void Master::GetAudioOutSamples(size_t nsamples,
     }
 }
 
+void Master::renderPart(void *ctx, int job)
+{
+    static_cast<Master*>(ctx)->renderparts[job]->ComputePartSmps();
+}
+
 Master::~Master()
 {
+    delete partpool;
     delete []bufl;
     delete []bufr;
 
@@ -1556,8 +1584,82 @@ void Master::vuresetpeaks()
 
 void Master::applyparameters(void)
 {
+    applyparameters([]{return false;}, [](int, int){});
+}
+
+void Master::applyparameters(std::function<bool()> do_abort,
+                             std::function<void(int,int)> progress)
+{
+    struct Task {
+        Part *part;
+        int   kititem;
+    };
+
+    //The PADsynth phases are seeded from the parameters, so the result does
+    //not depend on the scheduling.
+    //The oscillators share the master's FFTwrapper, so they are prepared
+    //here before fanning out.
+    std::vector<Task> tasks;
     for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
-        part[npart]->applyparameters();
+        for(int n = 0; n < NUM_KIT_ITEMS; ++n)
+            if(part[npart]->needsapply(n)) {
+                part[npart]->prepareoscillators(n);
+                tasks.push_back(Task{part[npart], n});
+            }
+
+    const int total = tasks.size();
+#ifdef WIN32
+    //C++11 threads are broken on mingw cross compilation (see
+    //PADnoteParameters::sampleGenerator())
+    for(int t = 0; t < total; ++t) {
+        progress(t, total);
+        Task &task = tasks[t];
+        if(!do_abort())
+            task.part->applyparameters(task.kititem, do_abort, 1);
+    }
+    progress(total, total);
+#else
+    const unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+    const unsigned nthreads = std::min(cores, (unsigned)total);
+    //leftover cores are used by the PADsynth sample generators
+    const unsigned task_threads = std::max(cores / std::max(nthreads, 1u), 1u);
+
+    std::atomic<int>        next(0);
+    int                     done = 0;
+    std::mutex              done_mutex;
+    std::condition_variable done_cv;
+
+    auto worker = [&]() {
+        int t;
+        while((t = next++) < total) {
+            Task &task = tasks[t];
+            if(!do_abort())
+                task.part->applyparameters(task.kititem, do_abort,
+                                           task_threads);
+            std::lock_guard<std::mutex> lock(done_mutex);
+            ++done;
+            done_cv.notify_one();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(unsigned i = 0; i < nthreads; ++i)
+        threads.emplace_back(worker);
+
+    std::unique_lock<std::mutex> lock(done_mutex);
+    int reported = -1;
+    while(reported != total) {
+        done_cv.wait(lock, [&]{return done != reported;});
+        reported = done;
+        lock.unlock();
+        progress(reported, total);
+        lock.lock();
+    }
+    lock.unlock();
+
+    for(auto &thread : threads)
+        thread.join();
+#endif
 }
 
 void Master::initialize_rt(void)
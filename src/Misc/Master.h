@@ -17,6 +17,7 @@
 #include "../globals.h"
 #include "Microtonal.h"
 #include <atomic>
+#include <functional>
 #include <rtosc/automations.h>
 #include <rtosc/miditable.h>
 #include <rtosc/savefile.h>
@@ -88,6 +89,11 @@ class Master
         /**Regenerate PADsynth and other non-RT parameters
          * It is NOT SAFE to call this from a RT context*/
         void applyparameters(void) NONREALTIME;
+        /**Same as above, with one task per kit item spread over all cores.
+         * progress(done, total) is called from the calling thread whenever
+         * tasks have finished; do_abort is checked by all tasks*/
+        void applyparameters(std::function<bool()> do_abort,
+                             std::function<void(int,int)> progress) NONREALTIME;
 
         //This must be called prior-to/at-the-time-of RT insertion
         void initialize_rt(void) REALTIME;
@@ -104,7 +110,10 @@ class Master
         void noteOn(char chan, note_t note, char velocity) {
             noteOn(chan, note, velocity, note / 12.0f);
         };
-        void noteOn(char chan, note_t note, char velocity, float note_log2_freq);
+        /**@param frame_offset sample offset of the event within the next
+         *                     buffer computed by AudioOut()*/
+        void noteOn(char chan, note_t note, char velocity, float note_log2_freq,
+                    int frame_offset = 0);
         void noteOff(char chan, note_t note);
         void polyphonicAftertouch(char chan, note_t note, char velocity);
         void setController(char chan, int type, int par);
@@ -254,6 +263,12 @@ class Master
                            class DataObj& d, int msg_id = -1,
                            Master* master_from_mw = nullptr);
 
+        //Optional pool for rendering the parts concurrently (nullptr if the
+        //parts are rendered serially)
+        class WorkerPool *partpool;
+        Part *renderparts[NUM_MIDI_PARTS];
+        static void renderPart(void *ctx, int job) REALTIME;
+
         Value_Smoothing_Filter smoothing;
 
         Value_Smoothing_Filter smoothing_part_l[NUM_MIDI_PARTS];
@@ -19,6 +19,7 @@
 #include <dirent.h>
 #include <sys/stat.h>
 #include <mutex>
+#include <thread>
 
 #include <rtosc/undo-history.h>
 #include <rtosc/thread-link.h>
@@ -45,7 +46,10 @@
 #include "../Params/ADnoteParameters.h"
 #include "../Params/SUBnoteParameters.h"
 #include "../Params/PADnoteParameters.h"
+#include "../Params/PADCache.h"
+#include "../Params/PADSampleStore.h"
 #include "../DSP/FFTwrapper.h"
+#include "../Effects/Convolution.h"
 #include "../Synth/OscilGen.h"
 #include "../Nio/Nio.h"
 
@@ -191,12 +195,18 @@ void deallocate(const char *str, void *v)
         delete (Master*)v;
     else if(!strcmp(str, "fft_t"))
         delete[] (fft_t*)v;
+    else if(!strcmp(str, "OscilTables"))
+        delete (OscilTables*)v;
     else if(!strcmp(str, "KbmInfo"))
         delete (KbmInfo*)v;
     else if(!strcmp(str, "SclInfo"))
         delete (SclInfo*)v;
     else if(!strcmp(str, "Microtonal"))
         delete (Microtonal*)v;
+    else if(!strcmp(str, "PADSampleTable"))
+        PADSampleStore::release((PADSampleTable*)v);
+    else if(!strcmp(str, "ConvolutionIR"))
+        delete (ConvolutionIR*)v;
     else
         fprintf(stderr, "Unknown type '%s', leaking pointer %p!!\n", str, v);
 }
@@ -207,43 +217,206 @@ void deallocate(const char *str, void *v)
  *****************************************************************************/
 
 // This lets MiddleWare compute non-realtime PAD synth data and send it to the backend
-void preparePadSynth(string path, PADnoteParameters *p, rtosc::RtData &d)
+void preparePadSynth(string path, PADnoteParameters *p, rtosc::RtData &d,
+                     int quality = -1)
 {
     //printf("preparing padsynth parameters\n");
     assert(!path.empty());
-    path += "sample";
+    path += "samples";
 
 #ifdef WIN32
-    unsigned num = p->sampleGenerator([&path,&d]
-                       (unsigned N, PADnoteParameters::Sample &&s)
-                       {
-                           //printf("sending info to '%s'\n",
-                           //       (path+to_s(N)).c_str());
-                           d.chain((path+to_s(N)).c_str(), "ifb",
-                                   s.size, s.basefreq, sizeof(float*), &s.smp);
-                       }, []{return false;}, 1);
+    const unsigned max_threads = 1;
 #else
-    std::mutex rtdata_mutex;
-    unsigned num = p->sampleGenerator([&rtdata_mutex, &path,&d]
-                       (unsigned N, PADnoteParameters::Sample&& s)
-                       {
-                           //printf("sending info to '%s'\n",
-                           //       (path+to_s(N)).c_str());
-                           rtdata_mutex.lock();
-                           // send non-realtime computed data to PADnoteParameters
-                           d.chain((path+to_s(N)).c_str(), "ifb",
-                                   s.size, s.basefreq, sizeof(float*), &s.smp);
-                           rtdata_mutex.unlock();
-                       }, []{return false;});
+    const unsigned max_threads = 0;
 #endif
-
-    //clear out unused samples
-    for(unsigned i = num; i < PAD_MAX_SAMPLES; ++i) {
-        d.chain((path+to_s(i)).c_str(), "ifb",
-                0, 440.0f, sizeof(float*), NULL);
-    }
+    auto never = []{return false;};
+    const uint64_t key = p->samplekey(quality);
+    PADSampleTable *table;
+    if(PADSampleStore::lazy())
+        table = PADSampleStore::acquireLazy(key, *p, p->phaseseed(),
+                                            quality);
+    else
+        table = PADSampleStore::acquire(key,
+            [p, &never, max_threads, quality, key](PADSampleTable &t)
+            {
+                t.num = p->sampleGenerator([&t]
+                           (unsigned N, PADnoteParameters::Sample&& s)
+                           {
+                               t.sample[N] = std::move(s);
+                           }, never, max_threads, NULL, quality,
+                           ~(uint64_t)0, key);
+                return true;
+            }, never);
+
+    // send non-realtime computed data to PADnoteParameters
+    d.chain(path.c_str(), "b", sizeof(PADSampleTable*), &table);
 }
 
+//Pquality.samplesize of the preview samples (2^14 samples)
+#define PAD_PREVIEW_QUALITY 0
+
+//Samples computed in the background, handed to the MiddleWare via /load-pad
+struct PadSampleSet
+{
+    string             path;
+    PADnoteParameters *pars;
+    unsigned           generation;
+    PADSampleTable    *table;
+};
+
+/*
+ * Progressive PADsynth preparation
+ *
+ * A small preview sample set is generated and sent to the backend right
+ * away. The configured quality is then computed from a copy of the
+ * parameters in the background and swapped in through /load-pad.
+ * Preparing the same object again or changing any of its parameters
+ * cancels a generation that is still running, and results which went stale
+ * in the meantime are dropped.
+ */
+class PadPreparer
+{
+    public:
+        PadPreparer(MiddleWare *mw_, const Config *config_)
+            :mw(mw_), config(config_), generation(0)
+        {}
+
+        ~PadPreparer(void)
+        {
+            for(auto &j:jobs)
+                stale.push_back(j.second);
+            for(Job *job:stale)
+                job->abort = true;
+            PADSampleStore::wakeWaiting();
+            for(Job *job:stale) {
+                job->thread.join();
+                delete job;
+            }
+        }
+
+        void prepare(const string &path, PADnoteParameters *p,
+                     rtosc::RtData &d)
+        {
+            reap();
+            cancel(path);
+            //lazy tables only compute a single sample up front, so they do
+            //not need a preview either
+            if(!config->cfg.PADPreview || config->cfg.PADLazy
+               || p->Pquality.samplesize <= PAD_PREVIEW_QUALITY) {
+                preparePadSynth(path, p, d);
+                return;
+            }
+
+            //the preview and the final samples share their phases, as both
+            //are seeded with phaseseed()
+            preparePadSynth(path, p, d, PAD_PREVIEW_QUALITY);
+
+            //the copy gets its own FFT, as the one of master is not thread
+            //safe
+            FFTwrapper        *fft  = new FFTwrapper(p->synth.oscilsize);
+            PADnoteParameters *copy = new PADnoteParameters(p->synth, fft,
+                                                            nullptr);
+            copy->paste(*p);
+
+            PadSampleSet *set = new PadSampleSet;
+            set->path       = path;
+            set->pars       = p;
+            set->generation = ++generation;
+            set->table      = NULL;
+
+            Job *job = new Job;
+            job->abort      = false;
+            job->done       = false;
+            job->generation = set->generation;
+            job->thread     = std::thread(generate, job, copy, fft, set, mw);
+            jobs[path] = job;
+        }
+
+        //Stop the background generation for path, if there is one
+        void cancel(const string &path)
+        {
+            auto it = jobs.find(path);
+            if(it == jobs.end())
+                return;
+            it->second->abort = true;
+            PADSampleStore::wakeWaiting();
+            stale.push_back(it->second);
+            jobs.erase(it);
+        }
+
+        //Send a finished set to the backend, unless it went stale
+        void load(PadSampleSet *set, PADnoteParameters *current,
+                  rtosc::RtData &d)
+        {
+            auto it = jobs.find(set->path);
+            if(it != jobs.end() && it->second->generation == set->generation
+               && current == set->pars) {
+                stale.push_back(it->second);
+                jobs.erase(it);
+
+                d.chain((set->path + "samples").c_str(), "b",
+                        sizeof(PADSampleTable*), &set->table);
+            } else
+                PADSampleStore::release(set->table);
+            delete set;
+            reap();
+        }
+
+    private:
+        struct Job {
+            std::thread       thread;
+            std::atomic_bool  abort, done;
+            unsigned          generation;
+        };
+
+        static void generate(Job *job, PADnoteParameters *pars,
+                             FFTwrapper *fft, PadSampleSet *set,
+                             MiddleWare *mw)
+        {
+            auto do_abort = [job]{return (bool)job->abort;};
+            const uint64_t key = pars->samplekey();
+            set->table = PADSampleStore::acquire(key,
+                    [pars, &do_abort, key](PADSampleTable &t)
+                    {
+                        t.num = pars->sampleGenerator(
+                                [&t](unsigned N, PADnoteParameters::Sample &&s)
+                                {
+                                    t.sample[N] = std::move(s);
+                                }, do_abort, 0, NULL, -1, ~(uint64_t)0, key);
+                        return !do_abort();
+                    }, do_abort);
+            delete pars;
+            delete fft;
+
+            if(job->abort) {
+                PADSampleStore::release(set->table);
+                delete set;
+            } else
+                mw->messageAnywhere("/load-pad", "b", sizeof(set), &set);
+            job->done = true;
+        }
+
+        //Join the threads of stale or delivered jobs which are finished
+        void reap(void)
+        {
+            for(auto it = stale.begin(); it != stale.end();) {
+                if(!(*it)->done) {
+                    ++it;
+                    continue;
+                }
+                (*it)->thread.join();
+                delete *it;
+                it = stale.erase(it);
+            }
+        }
+
+        MiddleWare   *mw;
+        const Config *config;
+        unsigned      generation;
+        std::map<string, Job*> jobs; //running, per PADnoteParameters path
+        std::list<Job*>        stale;
+};
+
 /******************************************************************************
  *                      MIDI Serialization                                    *
  *                                                                            *
@@ -413,11 +586,11 @@ struct NonRtObjStore
             d.obj = nullptr; // tell walk_ports that there's nothing to recurse here...
         }
     }
-    void handlePad(const char *msg, rtosc::RtData &d) {
+    void handlePad(const char *msg, rtosc::RtData &d, PadPreparer &preparer) {
         string obj_rl(d.message, msg);
         void *pad = get(obj_rl);
         if(!strcmp(msg, "prepare")) {
-            preparePadSynth(obj_rl, (PADnoteParameters*)pad, d);
+            preparer.prepare(obj_rl, (PADnoteParameters*)pad, d);
             d.matches++;
             d.reply((obj_rl+"needPrepare").c_str(), "F");
         } else {
@@ -430,6 +603,7 @@ struct NonRtObjStore
                     if(!strcmp(msg, "oscilgen/prepare"))
                         ; //ignore
                     else {
+                        preparer.cancel(obj_rl);
                         d.reply((obj_rl+"needPrepare").c_str(), "T");
                     }
                 }
@@ -684,7 +858,23 @@ public:
                     return -1;
                 }
             }
-            m->applyparameters();
+
+            //Generate the samples on all cores, report progress as
+            //"/load-progress ii" (finished and total kit items)
+            abort_load = false;
+            m->applyparameters([this]{return abort_load.load();},
+                    [this](int done, int total) {
+                        char buf[64];
+                        rtosc_message(buf, sizeof(buf), "/load-progress",
+                                      "ii", done, total);
+                        broadcastToRemote(buf);
+                        if(idle)
+                            idle(idle_ptr);
+                    });
+            if(abort_load) {
+                delete m;
+                return -1;
+            }
         }
 
         //Update resource locator table
@@ -854,6 +1044,18 @@ public:
             d.chain("/microtonal/paste_scl", "b", sizeof(void*), &scl);
     }
 
+    //path is the one of an EffectMgr, with a trailing slash
+    void loadIr(const char *path, const char *filename, rtosc::RtData &d)
+    {
+        ConvolutionIR *ir = new ConvolutionIR;
+        int err = ir->loadfile(filename, synth.samplerate, synth.buffersize);
+        if(err) {
+            d.reply("/alert", "s", "Error: Could not load the impulse response.");
+            delete ir;
+        } else
+            d.chain((string(path) + "ir").c_str(), "b", sizeof(void*), &ir);
+    }
+
     void loadKbm(const char *filename, rtosc::RtData &d)
     {
         KbmInfo *kbm = new KbmInfo;
@@ -978,6 +1180,9 @@ public:
     std::atomic_int pending_load[NUM_MIDI_PARTS];
     std::atomic_int actual_load[NUM_MIDI_PARTS];
 
+    //Set to cancel a running loadMaster()
+    std::atomic_bool abort_load;
+
     //Undo/Redo
     rtosc::UndoHistory undo;
 
@@ -999,6 +1204,9 @@ public:
     //Synthesis Rate Parameters
     SYNTH_T synth;
 
+    //Background PADsynth generation (posts to multi_thread_source)
+    PadPreparer pad_preparer;
+
     PresetsStore presetsstore;
 
     CallbackRepeater autoSave;
@@ -1484,7 +1692,8 @@ static rtosc::Ports nonRtParamPorts = {
     {"part#" STRINGIFY(NUM_MIDI_PARTS)
         "/kit#" STRINGIFY(NUM_KIT_ITEMS) "/padpars/", 0, &PADnoteParameters::non_realtime_ports,
         rBegin
-        impl.obj_store.handlePad(chomp(chomp(chomp(msg))), d);
+        impl.obj_store.handlePad(chomp(chomp(chomp(msg))), d,
+                                 impl.pad_preparer);
         rEnd},
 };
 
@@ -1601,11 +1810,23 @@ static rtosc::Ports middwareSnoopPortsWithoutNonRtParams = {
         const char *file = rtosc_argument(msg, 0).s;
         impl.saveXsz(file, d);
         rEnd},
+    {"load-pad:b", rDoc("Swap in PADsynth samples computed in the background"), 0,
+        rBegin;
+        PadSampleSet *set = *(PadSampleSet**)rtosc_argument(msg, 0).b.data;
+        impl.pad_preparer.load(set,
+                (PADnoteParameters*)impl.obj_store.get(set->path), d);
+        rEnd},
     {"load_scl:s", rDoc("Load a scale from a file"), 0,
         rBegin;
         const char *file = rtosc_argument(msg, 0).s;
         impl.loadScl(file, d);
         rEnd},
+    {"load_ir:ss", rDoc("Load the impulse response of a Convolution effect"), 0,
+        rBegin;
+        const char *path = rtosc_argument(msg, 0).s;
+        const char *file = rtosc_argument(msg, 1).s;
+        impl.loadIr(path, file, d);
+        rEnd},
     {"load_kbm:s", 0, 0,
         rBegin;
         const char *file = rtosc_argument(msg, 0).s;
@@ -1901,6 +2122,7 @@ static rtosc::Ports middlewareReplyPorts = {
 MiddleWareImpl::MiddleWareImpl(MiddleWare *mw, SYNTH_T synth_,
     Config* config, int preferrred_port)
     :parent(mw), config(config), ui(nullptr), synth(std::move(synth_)),
+    pad_preparer(mw, config),
     presetsstore(*config), autoSave(-1, [this]() {
             auto master = this->master;
             this->doReadOnlyOp([master](){
@@ -1931,6 +2153,10 @@ MiddleWareImpl::MiddleWareImpl(MiddleWare *mw, SYNTH_T synth_,
     cb = [](void*, const char*){};
     idle = 0;
     idle_ptr = 0;
+    abort_load = false;
+
+    PADCache::setConfig(config);
+    PADSampleStore::setConfig(config);
 
     recreateMinimalMaster();
     osc    = GUI::genOscInterface(mw);
@@ -2492,6 +2718,12 @@ void MiddleWare::setIdleCallback(void(*cb)(void*), void *ptr)
     impl->idle_ptr = ptr;
 }
 
+void MiddleWare::abortLoad(void)
+{
+    impl->abort_load = true;
+    PADSampleStore::wakeWaiting();
+}
+
 void MiddleWare::transmitMsg(const char *msg)
 {
     impl->handleMsg(msg);
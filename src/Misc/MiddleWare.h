@@ -54,6 +54,8 @@ class MiddleWare
         void setUiCallback(void(*cb)(void*,const char *),void *ui);
         //Set callback to run while busy
         void setIdleCallback(void(*cb)(void*),void *ptr);
+        //Cancel loading a master (from any thread, e.g. the idle callback)
+        void abortLoad(void);
         //Handle events
         void tick(void);
         //Do A Readonly Operation (For Parameter Copy)
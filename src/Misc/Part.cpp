@@ -20,6 +20,7 @@
 #include "../Params/ADnoteParameters.h"
 #include "../Params/SUBnoteParameters.h"
 #include "../Params/PADnoteParameters.h"
+#include "../Synth/OscilGen.h"
 #include "../Synth/Resonance.h"
 #include "../Synth/SynthNote.h"
 #include "../Synth/ADnote.h"
@@ -493,7 +494,8 @@ static int kit_usage(const Part::Kit *kits, int note, int mode)
  */
 bool Part::NoteOnInternal(note_t note,
                   unsigned char velocity,
-                  float note_log2_freq)
+                  float note_log2_freq,
+                  int frame_offset)
 {
     //Verify Basic Mode and sanity
     const bool isRunningNote   = notePool.existsRunningNote();
@@ -563,17 +565,25 @@ bool Part::NoteOnInternal(note_t note,
         const int sendto = Pkitmode ? item.sendto() : 0;
 
         try {
-            if(item.Padenabled)
-                notePool.insertNote(note, sendto,
-                        {memory.alloc<ADnote>(kit[i].adpars, pars,
-                            wm, (pre+"kit"+i+"/adpars/").c_str), 0, i});
-            if(item.Psubenabled)
-                notePool.insertNote(note, sendto,
-                        {memory.alloc<SUBnote>(kit[i].subpars, pars, wm, (pre+"kit"+i+"/subpars/").c_str), 1, i});
-            if(item.Ppadenabled)
-                notePool.insertNote(note, sendto,
-                        {memory.alloc<PADnote>(kit[i].padpars, pars, interpolation, wm,
-                            (pre+"kit"+i+"/padpars/").c_str), 2, i});
+            SynthNote *sn;
+            if(item.Padenabled) {
+                sn = memory.alloc<ADnote>(kit[i].adpars, pars,
+                        wm, (pre+"kit"+i+"/adpars/").c_str);
+                sn->setStartOffset(frame_offset);
+                notePool.insertNote(note, sendto, {sn, 0, i});
+            }
+            if(item.Psubenabled) {
+                sn = memory.alloc<SUBnote>(kit[i].subpars, pars, wm,
+                        (pre+"kit"+i+"/subpars/").c_str);
+                sn->setStartOffset(frame_offset);
+                notePool.insertNote(note, sendto, {sn, 1, i});
+            }
+            if(item.Ppadenabled) {
+                sn = memory.alloc<PADnote>(kit[i].padpars, pars, interpolation, wm,
+                        (pre+"kit"+i+"/padpars/").c_str);
+                sn->setStartOffset(frame_offset);
+                notePool.insertNote(note, sendto, {sn, 2, i});
+            }
         } catch (std::bad_alloc & ba) {
             std::cerr << "dropped new note: " << ba.what() << std::endl;
         }
@@ -887,14 +897,14 @@ void Part::ComputePartSmps()
             float tmpoutr[synth.buffersize];
             float tmpoutl[synth.buffersize];
             auto &note = *s.note;
-            note.noteout(&tmpoutl[0], &tmpoutr[0]);
+            note.offsetnoteout(&tmpoutl[0], &tmpoutr[0]);
 
             for(int i = 0; i < synth.buffersize; ++i) { //add the note to part(mix)
                 partfxinputl[d.sendto][i] += tmpoutl[i];
                 partfxinputr[d.sendto][i] += tmpoutr[i];
             }
 
-            if(note.finished())
+            if(note.offsetfinished())
                 notePool.kill(s);
         }
     }
@@ -1147,8 +1157,31 @@ void Part::applyparameters(void)
 void Part::applyparameters(std::function<bool()> do_abort)
 {
     for(int n = 0; n < NUM_KIT_ITEMS; ++n)
-        if(kit[n].Ppadenabled && kit[n].padpars)
-            kit[n].padpars->applyparameters(do_abort);
+        applyparameters(n, do_abort, 0);
+}
+
+bool Part::needsapply(int n) const
+{
+    return (kit[n].Padenabled && kit[n].adpars)
+        || (kit[n].Ppadenabled && kit[n].padpars);
+}
+
+void Part::prepareoscillators(int n)
+{
+    if(kit[n].Padenabled && kit[n].adpars)
+        kit[n].adpars->prepareoscillators();
+    if(kit[n].Ppadenabled && kit[n].padpars)
+        if(kit[n].padpars->oscilgen->needPrepare())
+            kit[n].padpars->oscilgen->prepare();
+}
+
+void Part::applyparameters(int n, std::function<bool()> do_abort,
+                           unsigned max_threads)
+{
+    if(kit[n].Padenabled && kit[n].adpars)
+        kit[n].adpars->applyparameters();
+    if(kit[n].Ppadenabled && kit[n].padpars)
+        kit[n].padpars->applyparameters(do_abort, max_threads);
 }
 
 void Part::initialize_rt(void)
@@ -19,6 +19,7 @@
 #include "../globals.h"
 #include "../Params/Controller.h"
 #include "../Containers/NotePool.h"
+#include "Util.h"
 
 #include <functional>
 
@@ -53,16 +54,18 @@ class Part
         };
 
         //returns true when note is successfully applied
+        //frame_offset delays the start of the note within the next buffer
         bool NoteOn(note_t note, uint8_t vel, int shift,
-                    float log2_freq) REALTIME {
+                    float log2_freq, int frame_offset = 0) REALTIME {
             return (getNoteLog2Freq(shift, log2_freq) &&
-                NoteOnInternal(note, vel, log2_freq));
+                NoteOnInternal(note, vel, log2_freq, frame_offset));
         };
 
         //returns true when note is successfully applied
         bool NoteOnInternal(note_t note,
                     unsigned char velocity,
-                    float note_log2_freq) REALTIME;
+                    float note_log2_freq,
+                    int frame_offset = 0) REALTIME;
         void NoteOff(note_t note) REALTIME;
         void PolyphonicAftertouch(note_t note,
                                   unsigned char velocity) REALTIME;
@@ -90,6 +93,13 @@ class Part
 
         void applyparameters(void) NONREALTIME;
         void applyparameters(std::function<bool()> do_abort) NONREALTIME;
+        //Per kit item steps of applyparameters() for concurrent loading.
+        //prepareoscillators() uses the FFTwrapper shared with the other
+        //parts, so it must not run concurrently with itself.
+        bool needsapply(int kititem) const;
+        void prepareoscillators(int kititem) NONREALTIME;
+        void applyparameters(int kititem, std::function<bool()> do_abort,
+                             unsigned max_threads) NONREALTIME;
 
         void initialize_rt(void) REALTIME;
         void kill_rt(void) REALTIME;
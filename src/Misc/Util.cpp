@@ -42,6 +42,45 @@ bool isPlugin = false;
 
 prng_t prng_state = 0x1234;
 
+prng_t prng_skip(prng_t p, uint32_t n)
+{
+    //compose the affine step x*a+c with itself n times
+    prng_t acc_a = 1, acc_c = 0;
+    prng_t a = 1103515245, c = 12345;
+    while(n) {
+        if(n & 1) {
+            acc_a *= a;
+            acc_c  = acc_c * a + c;
+        }
+        c *= a + 1;
+        a *= a;
+        n >>= 1;
+    }
+    return acc_a * p + acc_c;
+}
+
+void rnd_fill(prng_t &p, float *buf, int len)
+{
+    //four interleaved lanes, each advanced by four steps per iteration
+    const prng_t a4 = 1103515245u * 1103515245u * 1103515245u * 1103515245u;
+    const prng_t c4 = prng_skip(0, 4);
+    prng_t lane[4];
+    prng_t x = p;
+    for(int k = 0; k < 4; ++k)
+        lane[k] = prng_r(x);
+
+    int i = 0;
+    for(; i + 4 <= len; i += 4)
+        for(int k = 0; k < 4; ++k) {
+            buf[i + k] = (lane[k] & 0x7fffffff) / (INT32_MAX_FLOAT * 1.0f);
+            lane[k]    = lane[k] * a4 + c4;
+        }
+    for(int k = 0; i < len; ++i, ++k)
+        buf[i] = (lane[k] & 0x7fffffff) / (INT32_MAX_FLOAT * 1.0f);
+
+    p = prng_skip(p, len);
+}
+
 /*
  * Transform the velocity according the scaling parameter (velocity sensing)
  */
@@ -146,6 +146,24 @@ inline void sprng(prng_t p)
 #endif
 #define RND (prng() / (INT32_MAX_FLOAT * 1.0f))
 
+/*
+ * Reentrant variants operating on a caller owned state.
+ * Realtime code (notes, effects, worker threads) keeps its own prng_t, so
+ * that its output does not depend on what else consumed the global state.
+ */
+
+//Random float (0.0f..1.0f) using the state p
+inline float rnd_r(prng_t &p)
+{
+    return (prng_r(p) & 0x7fffffff) / (INT32_MAX_FLOAT * 1.0f);
+}
+
+//Return the state reached after n calls of prng_r() on p
+prng_t prng_skip(prng_t p, uint32_t n);
+
+//Fill buf with len values of rnd_r(p) (same sequence, vectorizable)
+void rnd_fill(prng_t &p, float *buf, int len);
+
 //Linear Interpolation
 float interpolate(const float *data, size_t len, float pos);
 
@@ -93,4 +93,100 @@ void WavFile::writeMonoSamples(int nsmps, short int *smps)
     }
 }
 
+//Little endian fields, independent of the host
+static unsigned int readLE(const unsigned char *p, int bytes)
+{
+    unsigned int v = 0;
+    for(int i = bytes - 1; i >= 0; --i)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+static float wavSample(const unsigned char *p, int bits, bool isfloat)
+{
+    if(isfloat) {
+        if(bits == 32) {
+            union { unsigned int i; float f; } u;
+            u.i = readLE(p, 4);
+            return u.f;
+        }
+        union { unsigned long long i; double f; } u;
+        u.i = readLE(p, 4) | (unsigned long long)readLE(p + 4, 4) << 32;
+        return u.f;
+    }
+    switch(bits) {
+        case 8: //unsigned
+            return (p[0] - 128) / 128.0f;
+        case 16:
+            return (short int)readLE(p, 2) / 32768.0f;
+        case 24: //sign extended through the top byte
+            return (int)(readLE(p, 3) << 8) / 2147483648.0f;
+        default:
+            return (int)readLE(p, 4) / 2147483648.0f;
+    }
+}
+
+int loadWavFile(const string &filename, vector<float> &smps,
+                int &samplerate, int &channels)
+{
+    FILE *f = fopen(filename.c_str(), "rb");
+    if(!f)
+        return -1;
+
+    unsigned char hdr[12];
+    if(fread(hdr, 1, 12, f) != 12 || memcmp(hdr, "RIFF", 4)
+       || memcmp(hdr + 8, "WAVE", 4)) {
+        fclose(f);
+        return -1;
+    }
+
+    int  bits = 0;
+    bool isfloat = false, gotfmt = false;
+    channels = 0;
+    unsigned char chunk[8];
+    while(fread(chunk, 1, 8, f) == 8) {
+        const unsigned int len = readLE(chunk + 4, 4);
+        if(!memcmp(chunk, "fmt ", 4) && len >= 16) {
+            unsigned char fmt[40];
+            const unsigned int n = len < sizeof(fmt) ? len : sizeof(fmt);
+            if(fread(fmt, 1, n, f) != n)
+                break;
+            unsigned int tag = readLE(fmt, 2);
+            channels   = readLE(fmt + 2, 2);
+            samplerate = readLE(fmt + 4, 4);
+            bits       = readLE(fmt + 14, 2);
+            if(tag == 0xFFFE && n >= 26) //WAVE_FORMAT_EXTENSIBLE
+                tag = readLE(fmt + 24, 2);
+            isfloat = tag == 3;
+            gotfmt  = (tag == 1 && (bits == 8 || bits == 16 || bits == 24
+                                    || bits == 32))
+                      || (isfloat && (bits == 32 || bits == 64));
+            if(!gotfmt || channels < 1 || samplerate < 1)
+                break;
+            fseek(f, len - n + (len & 1), SEEK_CUR);
+        }
+        else if(!memcmp(chunk, "data", 4) && gotfmt) {
+            //streamed files may not know the length of their data
+            const long start = ftell(f);
+            fseek(f, 0, SEEK_END);
+            const unsigned long avail = ftell(f) - start;
+            fseek(f, start, SEEK_SET);
+            const unsigned long size = len < avail ? len : avail;
+            const int frame = channels * bits / 8;
+            vector<unsigned char> raw(size - size % frame);
+            const size_t got = fread(raw.data(), 1, raw.size(), f);
+            fclose(f);
+            const size_t nsmps = got / frame * channels;
+            smps.resize(nsmps);
+            for(size_t i = 0; i < nsmps; ++i)
+                smps[i] = wavSample(&raw[i * bits / 8], bits, isfloat);
+            return nsmps ? 0 : -1;
+        }
+        else //chunks are padded to an even length
+            fseek(f, len + (len & 1), SEEK_CUR);
+    }
+    fclose(f);
+    return -1;
+}
+
 }
@@ -15,6 +15,7 @@
 #ifndef WAVFILE_H
 #define WAVFILE_H
 #include <string>
+#include <vector>
 
 namespace zyn {
 
@@ -36,6 +37,15 @@ class WavFile
         FILE *file;
 };
 
+/**
+ * Reads a RIFF WAVE file with 8, 16, 24 or 32 bit integer or 32 or 64 bit
+ * float samples.
+ * @param smps gets the interleaved samples, integers are scaled to [-1, 1)
+ * @return 0 on success, -1 if the file can't be read
+ */
+int loadWavFile(const std::string &filename, std::vector<float> &smps,
+                int &samplerate, int &channels);
+
 }
 
 #endif
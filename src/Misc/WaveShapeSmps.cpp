@@ -12,6 +12,7 @@
 */
 
 #include "WaveShapeSmps.h"
+#include "../DSP/FastMath.h"
 #include <cmath>
 
 namespace zyn {
@@ -81,7 +82,7 @@ void waveShapeSmps(int n,
             ws = powf(10, ws * ws * 3.0f) - 1.0f + 0.001f; //Arctangent
             for(i = 0; i < n; ++i) {
                 smps[i] += offs;
-                smps[i] = atanf(smps[i] * ws) / atanf(ws);
+                smps[i] = fast_atan(smps[i] * ws) / fast_atan(ws);
                 smps[i] -= offs;
             }
             break;
@@ -92,7 +93,7 @@ void waveShapeSmps(int n,
             else
                 tmpv = 1.1f;
             for(i = 0; i < n; ++i)
-                smps[i] = sinf(smps[i] * (0.1f + ws - ws * smps[i])) / tmpv;
+                smps[i] = fast_sin(smps[i] * (0.1f + ws - ws * smps[i])) / tmpv;
             ;
             break;
         case 3:
@@ -115,7 +116,7 @@ void waveShapeSmps(int n,
             else
                 tmpv = 1.0f;
             for(i = 0; i < n; ++i)
-                smps[i] = sinf(smps[i] * ws) / tmpv;
+                smps[i] = fast_sin(smps[i] * ws) / tmpv;
             break;
         case 5:
             ws = ws * ws + 0.000001f; //Quantisize
@@ -129,7 +130,7 @@ void waveShapeSmps(int n,
             else
                 tmpv = 1.0f;
             for(i = 0; i < n; ++i)
-                smps[i] = asinf(sinf(smps[i] * ws)) / tmpv;
+                smps[i] = asinf(fast_sin(smps[i] * ws)) / tmpv;
             break;
         case 7:
             ws = powf(2.0f, -ws * ws * 8.0f); //Limiter
@@ -239,7 +240,7 @@ void waveShapeSmps(int n,
                 else
                 if(tmp > 10.0f)
                     tmp = 10.0f;
-                tmp     = 0.5f - 1.0f / (expf(tmp) + 1.0f);
+                tmp     = 0.5f - 1.0f / (fast_exp(tmp) + 1.0f);
                 // calculate the same for offset value
                 float tmpo = offs * ws;
                 if(tmpo < -10.0f)
@@ -247,7 +248,7 @@ void waveShapeSmps(int n,
                 else
                 if(tmpo > 10.0f)
                     tmpo = 10.0f;
-                tmpo     = 0.5f - 1.0f / (expf(tmpo) + 1.0f);
+                tmpo     = 0.5f - 1.0f / (fast_exp(tmpo) + 1.0f);
 
                 smps[i] = tmp / tmpv;
                 smps[i] -= tmpo / tmpv; // subtract offset
@@ -261,8 +262,8 @@ void waveShapeSmps(int n,
             for(i = 0; i < n; ++i) {
                 smps[i] *= ws;// multiply signal to drive it in the saturation of the function
                 smps[i] += offs; // add dc offset
-                smps[i] = smps[i] / powf(1+powf(fabsf(smps[i]), par), 1/par);
-                smps[i] -= offs / powf(1+powf(fabsf(offs), par), 1/par);
+                smps[i] = smps[i] / fast_pow(1+fast_pow(fabsf(smps[i]), par), 1/par);
+                smps[i] -= offs / fast_pow(1+fast_pow(fabsf(offs), par), 1/par);
             }
             break;
         case 16: //cubic distortion
@@ -0,0 +1,187 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  WorkerPool.cpp - Fixed size realtime worker pool
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "WorkerPool.h"
+#include "Util.h"
+#include <cerrno>
+#include <climits>
+#if defined __APPLE__
+#include <dispatch/dispatch.h>
+#elif defined WIN32
+#include <windows.h>
+#else
+#include <semaphore.h>
+#endif
+
+namespace zyn {
+
+//Number of polls of the batch counter before a worker parks itself
+#define WORKER_SPIN_LIMIT (1<<14)
+
+WorkerPool::Wake::Wake(void)
+    :count(0)
+{
+#if defined __APPLE__
+    os = dispatch_semaphore_create(0);
+#elif defined WIN32
+    os = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+#else
+    sem_t *sem = new sem_t;
+    sem_init(sem, 0, 0);
+    os = sem;
+#endif
+}
+
+WorkerPool::Wake::~Wake(void)
+{
+#if defined __APPLE__
+    dispatch_release((dispatch_semaphore_t)os);
+#elif defined WIN32
+    CloseHandle((HANDLE)os);
+#else
+    sem_destroy((sem_t *)os);
+    delete (sem_t *)os;
+#endif
+}
+
+void WorkerPool::Wake::post(void)
+{
+    if(count.fetch_add(1, std::memory_order_release) >= 0)
+        return;
+#if defined __APPLE__
+    dispatch_semaphore_signal((dispatch_semaphore_t)os);
+#elif defined WIN32
+    ReleaseSemaphore((HANDLE)os, 1, NULL);
+#else
+    sem_post((sem_t *)os);
+#endif
+}
+
+void WorkerPool::Wake::wait(void)
+{
+    if(count.fetch_sub(1, std::memory_order_acquire) > 0)
+        return;
+#if defined __APPLE__
+    dispatch_semaphore_wait((dispatch_semaphore_t)os, DISPATCH_TIME_FOREVER);
+#elif defined WIN32
+    WaitForSingleObject((HANDLE)os, INFINITE);
+#else
+    while(sem_wait((sem_t *)os) && errno == EINTR)
+        ;
+#endif
+}
+
+bool WorkerPool::Wake::trywait(void)
+{
+    int c = count.load(std::memory_order_relaxed);
+    while(c > 0)
+        if(count.compare_exchange_weak(c, c - 1, std::memory_order_acquire,
+                                       std::memory_order_relaxed))
+            return true;
+    return false;
+}
+
+WorkerPool::WorkerPool(int nthreads)
+    :workers(nullptr), nworkers(max(nthreads-1, 0)),
+     batch_job(nullptr), batch_ctx(nullptr), batch_size(0),
+     next_job(0), generation(0), quit(false)
+{
+    if(!nworkers)
+        return;
+
+    workers = new Worker[nworkers];
+    for(int i=0; i<nworkers; ++i)
+        workers[i].finished = 0;
+    for(int i=0; i<nworkers; ++i) {
+        Worker &w = workers[i];
+        w.thread = std::thread([this, &w]() {worker(w);});
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    if(!nworkers)
+        return;
+
+    quit = true;
+    generation.fetch_add(1, std::memory_order_release);
+    for(int i=0; i<nworkers; ++i)
+        workers[i].wake.post();
+    for(int i=0; i<nworkers; ++i)
+        workers[i].thread.join();
+    delete [] workers;
+}
+
+void WorkerPool::run(job_t job, void *ctx, int njobs)
+{
+    if(!nworkers || njobs < 2) {
+        for(int i=0; i<njobs; ++i)
+            job(ctx, i);
+        return;
+    }
+
+    batch_job  = job;
+    batch_ctx  = ctx;
+    batch_size = njobs;
+    next_job.store(0, std::memory_order_relaxed);
+
+    //publish the batch and wake any parked workers
+    const unsigned gen = generation.load(std::memory_order_relaxed) + 1;
+    generation.store(gen, std::memory_order_release);
+    for(int i=0; i<nworkers; ++i)
+        workers[i].wake.post();
+
+    work();
+
+    //join
+    for(int i=0; i<nworkers; ++i)
+        while(workers[i].finished.load(std::memory_order_acquire) != gen)
+            ;
+}
+
+void WorkerPool::work(void)
+{
+    int job;
+    while((job = next_job.fetch_add(1, std::memory_order_relaxed)) < batch_size)
+        batch_job(batch_ctx, job);
+}
+
+void WorkerPool::worker(Worker &w)
+{
+    set_realtime();
+
+    unsigned seen = 0;
+    while(true) {
+        unsigned gen;
+        int spins = 0;
+        while((gen = generation.load(std::memory_order_acquire)) == seen) {
+            if(++spins < WORKER_SPIN_LIMIT)
+                continue;
+            w.wake.wait();
+            spins = 0;
+        }
+        seen = gen;
+
+        //Drop the wakeup posted for this batch if it was picked up while
+        //spinning. No wakeup for the next batch can be pending, as run() does
+        //not return before 'finished' is set below.
+        while(w.wake.trywait())
+            ;
+
+        if(quit)
+            return;
+
+        work();
+        w.finished.store(gen, std::memory_order_release);
+    }
+}
+
+}
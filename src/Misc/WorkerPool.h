@@ -0,0 +1,86 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  WorkerPool.h - Fixed size realtime worker pool
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <atomic>
+#include <thread>
+#include "../globals.h"
+
+namespace zyn {
+
+/**
+ * Fixed size pool of worker threads used to split up one block of realtime
+ * work (e.g. rendering the enabled parts) across several cores.
+ *
+ * All threads are created when the pool is constructed and are never
+ * created/destroyed from the realtime thread.
+ * Workers busy wait for a short while after finishing a job batch (so that
+ * the next audio block can be picked up without a wakeup) and then park on a
+ * semaphore. Its count lives in an atomic, so waking a worker never takes a
+ * lock on the realtime thread (ZynSema uses a mutex on macOS and Windows).
+ * The calling thread always takes part in the work and run() only returns
+ * once every job of the batch has completed.
+ */
+class WorkerPool
+{
+    public:
+        typedef void (*job_t)(void *ctx, int job);
+
+        /**Construct a pool which uses nthreads threads including the
+         * calling one (i.e. nthreads-1 workers are spawned)*/
+        WorkerPool(int nthreads) NONREALTIME;
+        WorkerPool(const WorkerPool&) = delete;
+        ~WorkerPool() NONREALTIME;
+
+        /**Run job(ctx, 0..njobs-1) and wait for all of them to finish*/
+        void run(job_t job, void *ctx, int njobs) REALTIME;
+
+        /**number of threads working on a batch (including the caller)*/
+        int threads(void) const { return nworkers + 1; }
+
+    private:
+        //Semaphore which only enters the OS when a worker sleeps on it
+        class Wake
+        {
+            public:
+                Wake(void) NONREALTIME;
+                Wake(const Wake&) = delete;
+                ~Wake(void) NONREALTIME;
+                void post(void) REALTIME;
+                void wait(void);
+                bool trywait(void);
+            private:
+                std::atomic<int> count; //below 0: minus the sleeping waiter
+                void            *os;    //OS semaphore to sleep on
+        };
+
+        struct Worker {
+            std::thread        thread;
+            Wake               wake;
+            std::atomic<unsigned> finished;
+        };
+
+        void worker(Worker &w) NONREALTIME;
+        void work(void) REALTIME;
+
+        Worker   *workers;
+        int       nworkers;
+
+        //current batch
+        job_t             batch_job;
+        void             *batch_ctx;
+        int               batch_size;
+        std::atomic<int>  next_job;
+        std::atomic<unsigned> generation;
+        std::atomic<bool> quit;
+};
+
+}
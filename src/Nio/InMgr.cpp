@@ -17,6 +17,7 @@
 #include "../Misc/MiddleWare.h"
 #include <rtosc/thread-link.h>
 #include <iostream>
+#include <algorithm>
 using namespace std;
 
 extern zyn::MiddleWare *middleware;
@@ -96,7 +97,7 @@ void InMgr::flush(unsigned frameStart, unsigned frameStop)
     MidiEvent ev;
     while(!work.trywait()) {
         queue.peak(ev);
-        if(ev.time < (int)frameStart || ev.time > (int)frameStop) {
+        if(ev.time >= (int)frameStop) {
             //Back out of transaction
             work.post();
             //printf("%d vs [%d..%d]\n",ev.time, frameStart, frameStop);
@@ -105,13 +106,18 @@ void InMgr::flush(unsigned frameStart, unsigned frameStop)
         queue.pop(ev);
         //cout << ev << endl;
 
+        //late events are started at the beginning of the buffer
+        const int offset = max(ev.time - (int)frameStart, 0);
+
         switch(ev.type) {
             case M_NOTE:
-                master->noteOn(ev.channel, ev.num, ev.value);
+                master->noteOn(ev.channel, ev.num, ev.value,
+                               ev.num / 12.0f, offset);
                 break;
 
             case M_FLOAT_NOTE:
-                master->noteOn(ev.channel, ev.num, ev.value, ev.log2_freq);
+                master->noteOn(ev.channel, ev.num, ev.value, ev.log2_freq,
+                               offset);
                 break;
 
             case M_CONTROLLER:
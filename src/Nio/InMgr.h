@@ -33,7 +33,7 @@ struct MidiEvent {
     int type;    //type=1 for note, type=2 for controller
     int num;     //note, controller or program number
     int value;   //velocity or controller value
-    int time;    //time offset of event (used only in jack->jack case at the moment)
+    int time;    //frame offset of event within the current period (jack)
     float log2_freq;   //type=5,6 for logarithmic representation of note/parameter
 };
 
@@ -46,7 +46,9 @@ class InMgr
 
         void putEvent(MidiEvent ev);
 
-        /**Flush the Midi Queue*/
+        /**Flush the Midi Queue up to (not including) frameStop.
+         * Note ons are started at their offset from frameStart within the
+         * next buffer, events before frameStart are applied at its start.*/
         void flush(unsigned frameStart, unsigned frameStop);
 
         bool empty() const;
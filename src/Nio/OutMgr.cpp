@@ -57,7 +57,7 @@ OutMgr::~OutMgr()
 
 /* Sequence of a tick
  * 1) Lets remove old/stale samples
- * 2) Apply appliciable midi events
+ * 2) Apply appliciable midi events (with their offset in the next buffer)
  * 3) Lets see if we need to generate samples
  * 4) Lets generate some
  * 5) Goto 2 if more are needed
@@ -69,10 +69,13 @@ const Stereo<float *> OutMgr::tick(unsigned int frameSize)
     InMgr &midi = InMgr::getInstance();
     //SysEv->execute();
     removeStaleSmps();
+    //samples left from the last tick are played before the new buffers
+    const unsigned leftover = storedSmps();
     int i=0;
     while(frameSize > storedSmps()) {
         if(!midi.empty()) {
-            midi.flush(i*synth.buffersize, (i+1)*synth.buffersize);
+            const unsigned start = leftover + i*synth.buffersize;
+            midi.flush(start, start + synth.buffersize);
         }
         master->AudioOut(outl, outr);
         addSmps(outl, outr);
@@ -153,6 +153,8 @@ static const Ports voicePorts = {
         "Signal Inverter"), //do we really need this??
     rToggle(PAAEnabled,        rShort("enable"), rDefault(false),
         "AntiAliasing Enable"),
+    rOption(PAAType,           rShort("type"), rOptions(sinc, polyphase),
+        rDefault(sinc), "AntiAliasing Interpolator"),
     rParamZyn(PAmpVelocityScaleFunction, rShort("sense"), rDefault(127),
         "Velocity Sensing"),
     rToggle(PAmpEnvelopeEnabled, rShort("enable"), rDefault(false),
@@ -572,6 +574,7 @@ void ADnoteVoiceParam::defaults()
     volume                    = -60.0f* (1.0f - 100.0f / 127.0f);
     PVolumeminus              = 0;
     PAAEnabled                = 0;
+    PAAType                   = AATYPE::SINC;
     PPanning                  = 64; //center
     PDetune                   = 8192; //8192=0
     PCoarseDetune             = 0;
@@ -1068,6 +1071,46 @@ void ADnoteParameters::getfromXML(XMLwrapper& xml)
     }
 }
 
+//Calls f for every oscillator the enabled voices read from
+template<class F>
+static void forUsedOscillators(ADnoteParameters &pars, F f)
+{
+    for(int nvoice = 0; nvoice < NUM_VOICES; ++nvoice) {
+        const ADnoteVoiceParam &voice = pars.VoicePar[nvoice];
+        if(!voice.Enabled)
+            continue;
+
+        const int vc = voice.Pextoscil != -1 ? voice.Pextoscil : nvoice;
+        f(pars.VoicePar[vc].OscilGn);
+
+        if(voice.PFMEnabled != FMTYPE::NONE && voice.PFMVoice < 0) {
+            const int fvc = voice.PextFMoscil != -1 ? voice.PextFMoscil : nvoice;
+            f(pars.VoicePar[fvc].FmGn);
+        }
+    }
+}
+
+void ADnoteParameters::prepareoscillators(void)
+{
+    forUsedOscillators(*this, [](OscilGen *o) {
+            if(o->needPrepare())
+                o->prepare();
+        });
+}
+
+void ADnoteParameters::applyparameters(void)
+{
+    //Master applies instruments concurrently and they share its FFTwrapper,
+    //so the tables are transformed with a private one
+    FFTwrapper *tablefft = NULL;
+    forUsedOscillators(*this, [&tablefft](OscilGen *o) {
+            if(!tablefft)
+                tablefft = new FFTwrapper(o->synth.oscilsize);
+            o->buildTables(*tablefft);
+        });
+    delete tablefft;
+}
+
 void ADnoteParameters::getfromXMLsection(XMLwrapper& xml, int n)
 {
     int nvoice = n;
@@ -23,6 +23,10 @@ enum class FMTYPE {
     NONE, MIX, RING_MOD, PHASE_MOD, FREQ_MOD, PW_MOD
 };
 
+enum class AATYPE {
+    SINC, POLYPHASE
+};
+
 /*****************************************************************/
 /*                    GLOBAL PARAMETERS                          */
 /*****************************************************************/
@@ -222,6 +226,9 @@ struct ADnoteVoiceParam {
     /* if AntiAliasing is enabled */
     bool PAAEnabled;
 
+    /* AntiAliasing interpolator */
+    AATYPE PAAType;
+
     /* Velocity sensing */
     unsigned char PAmpVelocityScaleFunction;
 
@@ -334,6 +341,12 @@ class ADnoteParameters:public PresetsArray
         void add2XMLsection(XMLwrapper& xml, int n) override;
         void getfromXMLsection(XMLwrapper& xml, int n);
 
+        //prepares the oscillators in use (uses the shared FFTwrapper)
+        void prepareoscillators(void) NONREALTIME;
+        //builds the band limited wavetables of the oscillators in use (with
+        //a private FFTwrapper, so several instruments may do it at once)
+        void applyparameters(void) NONREALTIME;
+
         const AbsTime *time;
         int64_t last_update_timestamp;
 
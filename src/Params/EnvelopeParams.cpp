@@ -21,6 +21,7 @@
 #include "EnvelopeParams.h"
 #include "../Misc/Util.h"
 #include "../Misc/Time.h"
+#include "../DSP/FastMath.h"
 
 using namespace rtosc;
 
@@ -495,11 +496,11 @@ void EnvelopeParams::add2XML(XMLwrapper& xml)
 }
 
 float EnvelopeParams::env_dB2rap(float db) {
-    return (powf(10.0f, db / 20.0f) - 0.01)/.99f;
+    return (fast_pow(10.0f, db / 20.0f) - 0.01)/.99f;
 }
 
 float EnvelopeParams::env_rap2dB(float rap) {
-    return 20.0f * log10f(rap * 0.99f + 0.01);
+    return 20.0f * fast_log10(rap * 0.99f + 0.01);
 }
 
 /**
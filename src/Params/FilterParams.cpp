@@ -131,6 +131,9 @@ const rtosc::Ports FilterParams::ports = {
     {"type-svf::i", rProp(parameter) rShort("type")
         rOptions(low, high, band, notch)
             rDoc("Filter Type"), 0, rOptionCb(Ptype)},
+    rToggle(Pramped,            rShort("ramp"), rDefault(false),
+            "State variable filter processing both channels and all stages "
+            "in one pass, with the frequency ramped per block"),
 
     //UI reader
     {"Pvowels:", rDoc("Get Formant Vowels"), NULL,
@@ -384,6 +387,7 @@ void FilterParams::defaults()
     freqtracking = 0.0f;
 
     Pcategory     = 0;
+    Pramped       = false;
 
     Pnumformants     = 3;
     Pformantslowness = 64;
@@ -433,6 +437,7 @@ void FilterParams::getfromFilterParams(const FilterParams *pars)
     freqtracking  = pars->freqtracking;
     gain          = pars->gain;
     Pcategory     = pars->Pcategory;
+    Pramped       = pars->Pramped;
 
     Pnumformants     = pars->Pnumformants;
     Pformantslowness = pars->Pformantslowness;
@@ -555,6 +560,7 @@ void FilterParams::add2XML(XMLwrapper& xml)
     xml.addpar("stages", Pstages);
     xml.addparreal("freq_tracking", freqtracking);
     xml.addparreal("gain",       gain);
+    xml.addparbool("ramped", Pramped);
 
     //formant filter parameters
     if((Pcategory == 1) || (!xml.minimal)) {
@@ -610,6 +616,7 @@ void FilterParams::getfromXML(XMLwrapper& xml)
     Pcategory    = xml.getpar127("category", Pcategory);
     Ptype        = xml.getpar127("type", Ptype);
     Pstages      = xml.getpar127("stages", Pstages);
+    Pramped      = xml.getparbool("ramped", Pramped);
     if(upgrade_3_0_2) {
         int Pfreq = xml.getpar127("freq", 0);
         basefreq  = (Pfreq / 64.0f - 1.0f) * 5.0f;
@@ -668,6 +675,7 @@ void FilterParams::paste(FilterParams &x)
     COPY(Pstages);
     COPY(freqtracking);
     COPY(gain);
+    COPY(Pramped);
 
     COPY(Pnumformants);
     COPY(Pformantslowness);
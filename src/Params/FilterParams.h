@@ -59,6 +59,7 @@ class FilterParams:public PresetsArray
         float    baseq;        //!< Q parameters (resonance or bandwidth)
         float    freqtracking; //!< Tracking of center frequency with note frequency (percentage)
         float    gain;         //!< filter's output gain (dB)
+        bool     Pramped;      //!< StVar: stages together, ramped per block
 
         int Pq;         //dummy
         int Pfreq;      //dummy
@@ -0,0 +1,339 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADCache.cpp - On-disk cache of generated PADsynth samples
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "PADCache.h"
+#include "../Misc/Config.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#ifndef WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace zyn {
+
+/*
+ * File layout (native endianness, the cache is not meant to be shared
+ * between machines):
+ *   Header
+ *   nsamples x Entry
+ *   nsamples x stride floats
+ * The magic is written last, so a set that was not completely written is
+ * never picked up.
+ */
+#define PADCACHE_MAGIC "ZYNPADC1"
+
+struct Header {
+    char     magic[8];
+    uint64_t key;
+    int32_t  nsamples;
+    int32_t  stride;
+};
+
+struct Entry {
+    float   basefreq;
+    int32_t size;
+};
+
+static const Config *cache_config = NULL;
+
+static size_t fileSize(int nsamples, int stride)
+{
+    return sizeof(Header) + nsamples * sizeof(Entry)
+           + (size_t)nsamples * stride * sizeof(float);
+}
+
+static size_t sampleOffset(int nsamples, int stride, int n)
+{
+    return sizeof(Header) + nsamples * sizeof(Entry)
+           + (size_t)n * stride * sizeof(float);
+}
+
+PADCache::Key::Key(void)
+    :hash(14695981039346656037ULL)
+{}
+
+void PADCache::Key::add(const void *data, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    for(size_t i = 0; i < len; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+void PADCache::setConfig(const Config *config)
+{
+    cache_config = config;
+}
+
+std::string PADCache::directory(void)
+{
+    if(!cache_config->cfg.PADCacheDir.empty())
+        return cache_config->cfg.PADCacheDir;
+
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    if(xdg && *xdg)
+        return std::string(xdg) + "/zynaddsubfx/padsynth";
+    const char *home = getenv("HOME");
+    if(home && *home)
+        return std::string(home) + "/.cache/zynaddsubfx/padsynth";
+    return "";
+}
+
+std::string PADCache::path(uint64_t key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.pad", (unsigned long long)key);
+    return directory() + name;
+}
+
+#ifndef WIN32
+
+bool PADCache::enabled(void)
+{
+    return cache_config && cache_config->cfg.PADCacheSize > 0
+           && !directory().empty();
+}
+
+//mkdir -p
+static bool makeDirectory(const std::string &dir)
+{
+    for(size_t pos = 1; pos <= dir.size(); ++pos) {
+        if(pos != dir.size() && dir[pos] != '/')
+            continue;
+        const std::string sub = dir.substr(0, pos);
+        if(mkdir(sub.c_str(), 0755) && errno != EEXIST)
+            return false;
+    }
+    return true;
+}
+
+bool PADCache::load(uint64_t key, int nsamples, int stride,
+                    const PADnoteParameters::callback &cb)
+{
+    if(!enabled())
+        return false;
+
+    const std::string filename = path(key);
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    if(fstat(fd, &st)
+       || (size_t)st.st_size != fileSize(nsamples, stride)) {
+        close(fd);
+        return false;
+    }
+
+    Header header;
+    std::vector<Entry> entry(nsamples);
+    const size_t entrylen = nsamples * sizeof(Entry);
+    bool valid = pread(fd, &header, sizeof(header), 0) == sizeof(header)
+                 && !memcmp(header.magic, PADCACHE_MAGIC, 8)
+                 && header.key == key
+                 && header.nsamples == nsamples
+                 && header.stride == stride
+                 && pread(fd, entry.data(), entrylen, sizeof(Header))
+                    == (ssize_t)entrylen;
+    for(int n = 0; valid && n < nsamples; ++n)
+        valid = entry[n].size > 0 && entry[n].size <= stride;
+
+    //The samples are read straight into the buffers their owners free
+    //with delete[]; all are read before any is passed on
+    std::vector<float *> smps;
+    const size_t len = stride * sizeof(float);
+    for(int n = 0; valid && n < nsamples; ++n) {
+        smps.push_back(new float[stride]);
+        valid = pread(fd, smps.back(), len, sampleOffset(nsamples, stride, n))
+                == (ssize_t)len;
+    }
+    close(fd);
+
+    if(!valid) {
+        for(float *s:smps)
+            delete[] s;
+        return false;
+    }
+
+    for(int n = 0; n < nsamples; ++n) {
+        PADnoteParameters::Sample smp;
+        smp.size     = entry[n].size;
+        smp.basefreq = entry[n].basefreq;
+        smp.smp      = smps[n];
+        cb(n, std::move(smp));
+    }
+    //mark as recently used for the eviction
+    utimes(filename.c_str(), NULL);
+    return true;
+}
+
+PADCache::Writer::Writer(uint64_t key_, int nsamples_, int stride_)
+    :key(key_), nsamples(nsamples_), stride(stride_), fd(-1),
+     added(0), failed(false)
+{
+    if(nsamples <= 0 || !enabled() || !makeDirectory(directory()))
+        return;
+
+    //each writer gets its own file, even for the same key
+    std::vector<char> name(path(key).size() + 8);
+    snprintf(name.data(), name.size(), "%s.XXXXXX", path(key).c_str());
+    fd = mkstemp(name.data());
+    if(fd < 0)
+        return;
+    tmpname = name.data();
+    if(fchmod(fd, 0644) || ftruncate(fd, fileSize(nsamples, stride))) {
+        close(fd);
+        unlink(tmpname.c_str());
+        fd = -1;
+    }
+}
+
+PADCache::Writer::~Writer(void)
+{
+    if(fd < 0)
+        return;
+    close(fd);
+    unlink(tmpname.c_str());
+}
+
+void PADCache::Writer::add(int n, const PADnoteParameters::Sample &smp)
+{
+    if(fd < 0 || n < 0 || n >= nsamples)
+        return;
+
+    const Entry  entry = {smp.basefreq, smp.size};
+    const size_t len   = stride * sizeof(float);
+    if(pwrite(fd, &entry, sizeof(entry),
+              sizeof(Header) + n * sizeof(Entry)) != sizeof(entry)
+       || pwrite(fd, smp.smp, len,
+                 sampleOffset(nsamples, stride, n)) != (ssize_t)len)
+        failed = true;
+    ++added;
+}
+
+void PADCache::Writer::commit(void)
+{
+    if(fd < 0)
+        return;
+
+    Header header;
+    memcpy(header.magic, PADCACHE_MAGIC, 8);
+    header.key      = key;
+    header.nsamples = nsamples;
+    header.stride   = stride;
+
+    const bool ok = !failed && added == nsamples
+                    && pwrite(fd, &header, sizeof(header), 0) == sizeof(header)
+                    && !fsync(fd);
+    close(fd);
+    fd = -1;
+
+    if(!ok || rename(tmpname.c_str(), path(key).c_str())) {
+        unlink(tmpname.c_str());
+        return;
+    }
+    evict();
+}
+
+void PADCache::evict(void)
+{
+    if(!enabled())
+        return;
+
+    const std::string dir = directory();
+    DIR *d = opendir(dir.c_str());
+    if(!d)
+        return;
+
+    struct File {
+        std::string name;
+        time_t      mtime;
+        off_t       size;
+    };
+    std::vector<File> files;
+    const time_t now    = time(NULL);
+    const time_t maxage = cache_config->cfg.PADCacheMaxAge * 24 * 3600;
+    off_t total = 0;
+
+    while(struct dirent *e = readdir(d)) {
+        const size_t len = strlen(e->d_name);
+        if(len < 4 || strcmp(e->d_name + len - 4, ".pad"))
+            continue;
+        File f;
+        f.name = dir + "/" + e->d_name;
+        struct stat st;
+        if(stat(f.name.c_str(), &st) || !S_ISREG(st.st_mode))
+            continue;
+        if(maxage && now - st.st_mtime > maxage) {
+            unlink(f.name.c_str());
+            continue;
+        }
+        f.mtime = st.st_mtime;
+        f.size  = st.st_size;
+        total  += f.size;
+        files.push_back(f);
+    }
+    closedir(d);
+
+    //least recently used first
+    std::sort(files.begin(), files.end(),
+              [](const File &a, const File &b) {return a.mtime < b.mtime;});
+
+    const off_t limit = (off_t)cache_config->cfg.PADCacheSize << 20;
+    for(size_t i = 0; i < files.size() && total > limit; ++i) {
+        unlink(files[i].name.c_str());
+        total -= files[i].size;
+    }
+}
+
+#else
+
+//Disabled on Windows
+bool PADCache::enabled(void)
+{
+    return false;
+}
+
+bool PADCache::load(uint64_t, int, int, const PADnoteParameters::callback &)
+{
+    return false;
+}
+
+PADCache::Writer::Writer(uint64_t key_, int nsamples_, int stride_)
+    :key(key_), nsamples(nsamples_), stride(stride_), fd(-1),
+     added(0), failed(false)
+{}
+
+PADCache::Writer::~Writer(void)
+{}
+
+void PADCache::Writer::add(int, const PADnoteParameters::Sample &)
+{}
+
+void PADCache::Writer::commit(void)
+{}
+
+void PADCache::evict(void)
+{}
+
+#endif
+
+}
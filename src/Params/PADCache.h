@@ -0,0 +1,85 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADCache.h - On-disk cache of generated PADsynth samples
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include "PADnoteParameters.h"
+
+namespace zyn {
+
+class Config;
+
+/**
+ * Content addressed store for the sample sets of PADnoteParameters.
+ *
+ * Each set is one file named after a hash of everything the samples are
+ * computed from. The files hold the raw float tables and are read back
+ * into memory when a set is requested again.
+ * Directory, size limit and maximum age come from the Config set with
+ * setConfig(); without one (e.g. in tests) the cache is disabled.
+ */
+class PADCache
+{
+    public:
+        /**Hash of the generator inputs (64 bit FNV-1a)*/
+        class Key
+        {
+            public:
+                Key(void);
+                void add(const void *data, size_t len);
+                template<class T>
+                void add(const T &v) { add(&v, sizeof(v)); }
+
+                uint64_t hash;
+        };
+
+        /**Collects a new sample set; samples may be added concurrently.
+         * Writing is synchronous: add() writes on the calling generator
+         * thread and commit() syncs the file before it becomes visible.*/
+        class Writer
+        {
+            public:
+                Writer(uint64_t key, int nsamples, int stride);
+                Writer(const Writer&) = delete;
+                ~Writer(void);
+
+                void add(int n, const PADnoteParameters::Sample &smp);
+                void commit(void);
+
+            private:
+                uint64_t    key;
+                int         nsamples, stride;
+                int         fd;
+                std::string tmpname;
+                std::atomic<int>  added;
+                std::atomic<bool> failed;
+        };
+
+        static void setConfig(const Config *config);
+        static bool enabled(void);
+
+        /**Pass each sample of a cached set to cb, false if there is none*/
+        static bool load(uint64_t key, int nsamples, int stride,
+                         const PADnoteParameters::callback &cb);
+
+        /**Remove sets past the age limit, then the least recently used
+         * ones until the cache fits its size limit*/
+        static void evict(void);
+
+    private:
+        static std::string path(uint64_t key);
+        static std::string directory(void);
+};
+
+}
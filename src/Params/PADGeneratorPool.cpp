@@ -0,0 +1,140 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADGeneratorPool.cpp - Persistent worker threads for the PADsynth generator
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "PADGeneratorPool.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+
+namespace zyn {
+
+//Time after which an idle worker releases its buffers
+static const std::chrono::seconds idle_release(5);
+
+PADGeneratorPool::Scratch::Scratch(int samplesize)
+    :fft(samplesize),
+     fftfreqs(new fft_t[samplesize / 2]),
+     spectrum(new float[samplesize / 2])
+{}
+
+PADGeneratorPool::Scratch::~Scratch()
+{
+    delete[] fftfreqs;
+    delete[] spectrum;
+}
+
+PADGeneratorPool &PADGeneratorPool::instance(void)
+{
+    static PADGeneratorPool pool(std::max(1u,
+                                 std::thread::hardware_concurrency()));
+    return pool;
+}
+
+PADGeneratorPool::PADGeneratorPool(unsigned nworkers)
+    :quit(false)
+{
+#ifndef WIN32
+    for(unsigned i = 0; i < nworkers; ++i)
+        workers.push_back(std::thread([this]() {worker();}));
+#else
+    (void)nworkers;
+#endif
+}
+
+PADGeneratorPool::~PADGeneratorPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    work.notify_all();
+    for(auto &w:workers)
+        w.join();
+}
+
+void PADGeneratorPool::run(int samplesize, int njobs, unsigned max_threads,
+                           const job_t &job)
+{
+    if(njobs <= 0)
+        return;
+
+#ifdef WIN32
+    //C++11 threads are broken on mingw cross compilation, so the jobs run
+    //on the calling thread
+    (void)max_threads;
+    Scratch scratch(samplesize);
+    for(int n = 0; n < njobs; ++n)
+        job(n, scratch);
+#else
+    Batch batch;
+    batch.job         = &job;
+    batch.samplesize  = samplesize;
+    batch.njobs       = njobs;
+    batch.next        = 0;
+    batch.done        = 0;
+    batch.active      = 0;
+    batch.max_threads = max_threads ? max_threads : workers.size();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    batches.push_back(&batch);
+    work.notify_all();
+    finished.wait(lock, [&batch]() {return batch.done == batch.njobs;});
+    batches.remove(&batch);
+#endif
+}
+
+//Requires the lock to be held
+PADGeneratorPool::Batch *PADGeneratorPool::pick(void)
+{
+    Batch *best = nullptr;
+    for(Batch *b:batches)
+        if(b->next < b->njobs && b->active < b->max_threads
+           && (!best || b->samplesize > best->samplesize))
+            best = b;
+    return best;
+}
+
+void PADGeneratorPool::worker(void)
+{
+    std::map<int, std::unique_ptr<Scratch>> scratch;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true) {
+        Batch *batch = nullptr;
+        auto ready = [this, &batch]() {return quit || (batch = pick());};
+        if(!work.wait_for(lock, idle_release, ready)) {
+            //nothing to do for a while, give the buffers back
+            lock.unlock();
+            scratch.clear();
+            lock.lock();
+            work.wait(lock, ready);
+        }
+        if(quit)
+            return;
+
+        const int n = batch->next++;
+        batch->active++;
+        lock.unlock();
+
+        std::unique_ptr<Scratch> &s = scratch[batch->samplesize];
+        if(!s)
+            s.reset(new Scratch(batch->samplesize));
+        (*batch->job)(n, *s);
+
+        lock.lock();
+        batch->active--;
+        if(++batch->done == batch->njobs)
+            finished.notify_all();
+    }
+}
+
+}
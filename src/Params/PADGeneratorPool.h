@@ -0,0 +1,84 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADGeneratorPool.h - Persistent worker threads for the PADsynth generator
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../DSP/FFTwrapper.h"
+
+namespace zyn {
+
+/**
+ * Worker threads shared by all PADnoteParameters::sampleGenerator() calls.
+ *
+ * The workers live as long as the process, and each of them keeps an FFT
+ * plan and the spectrum buffers for every sample size it has seen, so
+ * regenerating samples does not pay for thread creation, FFTW planning or
+ * big allocations again. A worker without jobs for a few seconds releases
+ * them.
+ * Several callers may run batches at the same time; pending jobs of the
+ * batch with the biggest samples are picked first.
+ * On Windows there are no workers and the jobs run on the calling thread.
+ */
+class PADGeneratorPool
+{
+    public:
+        /**Buffers of one worker for one sample size*/
+        struct Scratch {
+            Scratch(int samplesize);
+            Scratch(const Scratch&) = delete;
+            ~Scratch();
+
+            FFTwrapper fft;
+            fft_t     *fftfreqs;
+            float     *spectrum;
+        };
+
+        typedef std::function<void(int job, Scratch &scratch)> job_t;
+
+        static PADGeneratorPool &instance(void);
+
+        /**Run job(0..njobs-1) on at most max_threads workers (0 for no
+         * limit) and wait for all of them to finish.
+         * Jobs are started in increasing order, so the most expensive ones
+         * should come first.*/
+        void run(int samplesize, int njobs, unsigned max_threads,
+                 const job_t &job);
+
+        unsigned threads(void) const { return workers.size(); }
+
+    private:
+        PADGeneratorPool(unsigned nworkers);
+        PADGeneratorPool(const PADGeneratorPool&) = delete;
+        ~PADGeneratorPool();
+
+        struct Batch {
+            const job_t *job;
+            int      samplesize;
+            int      njobs, next, done;
+            unsigned active, max_threads;
+        };
+
+        void worker(void);
+        Batch *pick(void);
+
+        std::mutex              mutex;
+        std::condition_variable work, finished;
+        std::list<Batch *>      batches;
+        std::vector<std::thread> workers;
+        bool                    quit;
+};
+
+}
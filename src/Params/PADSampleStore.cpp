@@ -0,0 +1,397 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADSampleStore.cpp - Shared sample tables of PADsynth instruments
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "PADSampleStore.h"
+#include "PADGeneratorPool.h"
+#include "../DSP/FFTwrapper.h"
+#include "../Misc/Config.h"
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace zyn {
+
+typedef std::chrono::steady_clock clock_type;
+
+//Generation state of a lazy table, only accessed with store_mutex held
+struct PADLazySource {
+    FFTwrapper        *fft;
+    PADnoteParameters *pars; //private copy, only used by the worker
+    prng_t             rnd;
+    int                quality;
+    int                home; //first sample, never dropped
+    uint64_t           urgent, pending; //requested samples, neighbours
+    clock_type::time_point lastused[PAD_MAX_SAMPLES];
+};
+
+//Tables are identified by their key and whether they are lazy
+typedef std::pair<uint64_t, bool> table_id;
+
+static std::mutex              store_mutex;
+static std::condition_variable store_changed;
+static std::map<table_id, PADSampleTable *> store;
+static const Config           *store_config = NULL;
+
+static void deleteTable(PADSampleTable *table)
+{
+    for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
+        delete[] table->sample[i].smp.load();
+    if(table->source) {
+        delete table->source->pars;
+        delete table->source->fft;
+        delete table->source;
+    }
+    delete table;
+}
+
+static PADSampleTable *find(table_id id,
+                            const PADSampleStore::generator_t &generate,
+                            const std::function<bool()> &do_abort)
+{
+    std::unique_lock<std::mutex> lock(store_mutex);
+    while(true) {
+        auto it = store.find(id);
+        if(it == store.end())
+            break;
+        if(it->second->ready) {
+            it->second->refs++;
+            return it->second;
+        }
+        //generated by another thread, which may give up on it. It notifies
+        //when it is done, whoever makes do_abort() true calls wakeWaiting()
+        if(do_abort())
+            return NULL;
+        store_changed.wait(lock);
+    }
+
+    PADSampleTable *table = new PADSampleTable;
+    table->key    = id.first;
+    table->num    = 0;
+    table->lazy   = id.second;
+    table->refs   = 1;
+    table->ready  = false;
+    table->source = NULL;
+    for(int i = 0; i < PAD_MAX_SAMPLES; ++i) {
+        table->sample[i].smp      = NULL;
+        table->sample[i].size     = 0;
+        table->sample[i].basefreq = 440.0f;
+        table->wanted[i] = false;
+        table->used[i]   = false;
+    }
+    store[id] = table;
+    lock.unlock();
+
+    const bool done = generate(*table);
+
+    lock.lock();
+    if(done)
+        table->ready = true;
+    else
+        store.erase(id);
+    store_changed.notify_all();
+    lock.unlock();
+
+    if(done)
+        return table;
+    deleteTable(table);
+    return NULL;
+}
+
+PADSampleTable *PADSampleStore::acquire(uint64_t key,
+                                        const generator_t &generate,
+                                        const std::function<bool()> &do_abort)
+{
+    return find(table_id(key, false), generate, do_abort);
+}
+
+/*
+ * Lazy tables
+ *
+ * The realtime side flags the samples which notes asked for (wanted) and
+ * the ones which are played (used). A single worker thread polls these
+ * flags: it generates the wanted samples first, then their neighbours, and
+ * once per second it drops samples which have been idle for too long.
+ * Samples are published by storing their smp pointer (release) after the
+ * data is written, notes load it with acquire. Dropped buffers are only
+ * freed one sweep later, so a note which picked one up just before can
+ * finish its block, and then continues with the nearest sample left.
+ */
+
+//Make a generated sample visible to the realtime side
+static void publish(PADSampleTable &table, int n,
+                    PADnoteParameters::Sample &&s)
+{
+    PADnoteParameters::Sample &entry = table.sample[n];
+    if(entry.smp.load(std::memory_order_relaxed)) {
+        delete[] s.smp.load(std::memory_order_relaxed);
+        return;
+    }
+    entry.size     = s.size;
+    entry.basefreq = s.basefreq;
+    entry.smp.store(s.smp.load(std::memory_order_relaxed),
+                    std::memory_order_release);
+    table.source->lastused[n] = clock_type::now();
+}
+
+//Generate the samples of mask, called without the lock
+static void generateSamples(PADSampleTable &table, uint64_t mask,
+                            const std::function<bool()> &do_abort)
+{
+    PADLazySource &src = *table.source;
+    prng_t rnd = src.rnd;
+    src.pars->sampleGenerator([&table](int n, PADnoteParameters::Sample &&s)
+                              {
+                                  std::lock_guard<std::mutex> lock(store_mutex);
+                                  publish(table, n, std::move(s));
+                              }, do_abort, 0, &rnd, src.quality, mask,
+                              table.key);
+}
+
+class LazyWorker
+{
+    public:
+        LazyWorker(void)
+            :quit(false), thread([this]() {run();})
+        {}
+
+        ~LazyWorker(void)
+        {
+            {
+                std::lock_guard<std::mutex> lock(store_mutex);
+                quit = true;
+            }
+            wake.notify_all();
+            thread.join();
+            for(auto &r:retired)
+                delete[] r.first;
+        }
+
+        static LazyWorker &instance(void)
+        {
+            //The worker generates on the pool, so the pool is created
+            //first. Statics are destroyed in reverse order of construction,
+            //so the worker is joined before the pool goes away.
+            PADGeneratorPool::instance();
+            static LazyWorker worker;
+            return worker;
+        }
+
+    private:
+        //Collect the requests of the realtime side, requires the lock
+        void poll(void)
+        {
+            for(auto &e:store) {
+                PADSampleTable &t = *e.second;
+                if(!t.lazy || !t.ready)
+                    continue;
+                PADLazySource &src = *t.source;
+                for(int n = 0; n < t.num; ++n) {
+                    if(!t.wanted[n].exchange(false))
+                        continue;
+                    src.urgent |= (uint64_t)1 << n;
+                    for(int m = n - 1; m <= n + 1; m += 2)
+                        if(m >= 0 && m < t.num && !t.sample[m].smp)
+                            src.pending |= (uint64_t)1 << m;
+                }
+                src.pending &= ~src.urgent;
+            }
+        }
+
+        //Drop idle samples, requires the lock
+        void sweep(clock_type::time_point now)
+        {
+            for(auto it = retired.begin(); it != retired.end();) {
+                if(now - it->second < std::chrono::seconds(1)) {
+                    ++it;
+                    continue;
+                }
+                delete[] it->first;
+                it = retired.erase(it);
+            }
+
+            const int droptime =
+                store_config ? store_config->cfg.PADLazyDropTime : 0;
+            for(auto &e:store) {
+                PADSampleTable &t = *e.second;
+                if(!t.lazy || !t.ready)
+                    continue;
+                PADLazySource &src = *t.source;
+                for(int n = 0; n < t.num; ++n) {
+                    PADnoteParameters::Sample &s = t.sample[n];
+                    if(!s.smp)
+                        continue;
+                    if(t.used[n].exchange(false) || n == src.home)
+                        src.lastused[n] = now;
+                    else if(droptime > 0 && now - src.lastused[n]
+                                            > std::chrono::seconds(droptime)) {
+                        retired.push_back(std::make_pair(s.smp.load(), now));
+                        s.smp.store(NULL, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+
+        void run(void)
+        {
+            std::unique_lock<std::mutex> lock(store_mutex);
+            clock_type::time_point nextsweep = clock_type::now();
+            while(!quit) {
+                wake.wait_for(lock, std::chrono::milliseconds(10));
+                if(quit)
+                    break;
+                poll();
+
+                const clock_type::time_point now = clock_type::now();
+                if(now >= nextsweep) {
+                    sweep(now);
+                    nextsweep = now + std::chrono::seconds(1);
+                }
+
+                //Requested samples of all tables go before the neighbours
+                PADSampleTable *table = NULL;
+                for(auto &e:store)
+                    if(e.second->lazy && e.second->ready
+                       && e.second->source->urgent) {
+                        table = e.second;
+                        break;
+                    }
+                for(auto &e:store)
+                    if(!table && e.second->lazy && e.second->ready
+                       && e.second->source->pending)
+                        table = e.second;
+                if(!table)
+                    continue;
+
+                PADLazySource &src = *table->source;
+                uint64_t mask = src.urgent ? src.urgent : src.pending;
+                if(src.urgent)
+                    src.urgent = 0;
+                else
+                    src.pending = 0;
+                for(int n = 0; n < table->num; ++n)
+                    if(table->sample[n].smp)
+                        mask &= ~((uint64_t)1 << n);
+                if(!mask)
+                    continue;
+                table->refs++;
+                lock.unlock();
+
+                generateSamples(*table, mask, [this]{return (bool)quit;});
+                PADSampleStore::release(table);
+
+                lock.lock();
+            }
+        }
+
+        std::atomic<bool>       quit;
+        std::condition_variable wake;
+        std::list<std::pair<float *, clock_type::time_point>> retired;
+        std::thread             thread;
+};
+
+//Base frequency closest to A4
+static int homeSample(const float *basefreq, int num)
+{
+    int   home    = 0;
+    float mindist = 0.0f;
+    for(int n = 0; n < num; ++n) {
+        const float dist = fabsf(log2f(basefreq[n] / 440.0f));
+        if(n == 0 || dist < mindist) {
+            home    = n;
+            mindist = dist;
+        }
+    }
+    return home;
+}
+
+PADSampleTable *PADSampleStore::acquireLazy(uint64_t key,
+                                            PADnoteParameters &pars,
+                                            prng_t rnd, int quality)
+{
+    LazyWorker::instance();
+    return find(table_id(key, true), [&pars, rnd, quality]
+                (PADSampleTable &t)
+                {
+                    PADLazySource *src = new PADLazySource;
+                    //the copy gets its own FFT, as it is used by the worker
+                    src->fft  = new FFTwrapper(pars.synth.oscilsize);
+                    src->pars = new PADnoteParameters(pars.synth, src->fft,
+                                                      nullptr);
+                    src->pars->paste(pars);
+                    src->rnd     = rnd;
+                    src->quality = quality;
+                    src->urgent  = 0;
+                    src->pending = 0;
+                    t.source = src;
+
+                    float basefreq[PAD_MAX_SAMPLES];
+                    t.num = src->pars->samplefreqs(basefreq, quality);
+                    for(int n = 0; n < t.num; ++n)
+                        t.sample[n].basefreq = basefreq[n];
+                    src->home = homeSample(basefreq, t.num);
+                    if(t.num > 0)
+                        generateSamples(t, (uint64_t)1 << src->home,
+                                        []{return false;});
+                    return true;
+                }, []{return false;});
+}
+
+void PADSampleStore::release(PADSampleTable *table)
+{
+    if(!table)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(store_mutex);
+        if(--table->refs)
+            return;
+        store.erase(table_id(table->key, table->lazy));
+    }
+    deleteTable(table);
+}
+
+void PADSampleStore::wakeWaiting(void)
+{
+    std::lock_guard<std::mutex> lock(store_mutex);
+    store_changed.notify_all();
+}
+
+int PADSampleStore::tables(void)
+{
+    std::lock_guard<std::mutex> lock(store_mutex);
+    return store.size();
+}
+
+int PADSampleStore::generated(const PADSampleTable *table)
+{
+    std::lock_guard<std::mutex> lock(store_mutex);
+    int n = 0;
+    for(int i = 0; i < table->num; ++i)
+        if(table->sample[i].smp)
+            ++n;
+    return n;
+}
+
+void PADSampleStore::setConfig(const Config *config)
+{
+    store_config = config;
+}
+
+bool PADSampleStore::lazy(void)
+{
+    return store_config && store_config->cfg.PADLazy;
+}
+
+}
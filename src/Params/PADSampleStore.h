@@ -0,0 +1,101 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADSampleStore.h - Shared sample tables of PADsynth instruments
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <atomic>
+#include <functional>
+#include <stdint.h>
+#include "PADnoteParameters.h"
+
+namespace zyn {
+
+class Config;
+struct PADLazySource;
+
+/**Set of generated PADsynth samples
+ *
+ * Complete tables are immutable. Lazy tables start with a single sample
+ * and the others are added (or dropped again) by the worker of
+ * PADSampleStore while they are in use; entries which are not generated
+ * have their basefreq, but no smp.*/
+struct PADSampleTable {
+    uint64_t key;
+    int      num; //!< number of used entries of sample
+    PADnoteParameters::Sample sample[PAD_MAX_SAMPLES];
+
+    bool     lazy;
+    //set by the realtime side of lazy tables
+    std::atomic<bool> wanted[PAD_MAX_SAMPLES]; //!< a note had to fall back
+    std::atomic<bool> used[PAD_MAX_SAMPLES];   //!< played since last sweep
+
+    //owned by PADSampleStore
+    int      refs;
+    bool     ready;
+    PADLazySource *source;
+};
+
+/**
+ * Process wide store of the PADsynth sample tables.
+ *
+ * Tables are looked up by PADnoteParameters::samplekey(), so instruments
+ * with the same harmonic content and phase seed (e.g. one instrument loaded
+ * into several parts or kit items) share one table and only generate it once, even when
+ * they are applied at the same time.
+ * Tables are reference counted and freed with the last release(). The
+ * realtime side never calls into the store: it swaps tables with
+ * PADnoteParameters::swaptable() and hands the old one back through /free.
+ */
+class PADSampleStore
+{
+    public:
+        /**Fills a new table, returns false if it was aborted*/
+        typedef std::function<bool(PADSampleTable &table)> generator_t;
+
+        /**Reference to the table for key, generating it if there is none.
+         * If another thread is generating the same table, its result is
+         * waited for. Returns NULL when aborted, a do_abort which becomes
+         * true during the wait has to be followed by wakeWaiting().*/
+        static PADSampleTable *acquire(uint64_t key,
+                                       const generator_t &generate,
+                                       const std::function<bool()> &do_abort);
+
+        /**Reference to the lazy table for key.
+         * A new table only gets the sample closest to A4 right away, the
+         * others are generated in the background from a copy of pars once
+         * notes ask for them (see PADnoteParameters::findsample()), and
+         * dropped again when they have not been played for
+         * Config::cfg.PADLazyDropTime seconds.
+         * @param rnd State the phases are drawn from
+         * @param quality Sample size to use instead of Pquality.samplesize,
+         *                or -1*/
+        static PADSampleTable *acquireLazy(uint64_t key,
+                                           PADnoteParameters &pars,
+                                           prng_t rnd, int quality = -1);
+
+        /**Makes threads waiting in acquire() check their do_abort again*/
+        static void wakeWaiting(void);
+
+        /**Drop a reference (NULL is ignored), not realtime safe*/
+        static void release(PADSampleTable *table);
+
+        /**Number of tables in the store*/
+        static int tables(void);
+
+        /**Number of generated samples of a table*/
+        static int generated(const PADSampleTable *table);
+
+        static void setConfig(const Config *config);
+
+        /**Whether new tables should be lazy (Config::cfg.PADLazy)*/
+        static bool lazy(void);
+};
+
+}
@@ -10,9 +10,11 @@
   as published by the Free Software Foundation; either version 2
   of the License, or (at your option) any later version.
 */
-#include <limits>
 #include <cmath>
 #include "PADnoteParameters.h"
+#include "PADCache.h"
+#include "PADGeneratorPool.h"
+#include "PADSampleStore.h"
 #include "FilterParams.h"
 #include "EnvelopeParams.h"
 #include "LFOParams.h"
@@ -21,7 +23,6 @@
 #include "../Misc/WavFile.h"
 #include "../Misc/Time.h"
 #include <cstdio>
-#include <thread>
 
 #include <rtosc/ports.h>
 #include <rtosc/port-sugar.h>
@@ -84,19 +85,18 @@ static const rtosc::Ports realtime_ports =
             rOptions(L35cents, L10cents, E100cents, E1200cents),
             rDefault(L10cents), "Magnitude of Detune"),
 
-    {"sample#64:ifb", rProp(internal) rDoc("Nothing to see here"), 0,
+    {"samples:b", rProp(internal) rDoc("Nothing to see here"), 0,
         [](const char *m, rtosc::RtData &d)
         {
-            // MiddleWare calls this to send the generated sample buffers to us
+            // MiddleWare calls this to send the generated sample table to us,
+            // the replaced one goes back to be released
             PADnoteParameters *p = (PADnoteParameters*)d.obj;
-            const char *mm = m;
-            while(!isdigit(*mm))++mm;
-            int n = atoi(mm);
-            p->sample[n].size     = rtosc_argument(m,0).i;
-            p->sample[n].basefreq = rtosc_argument(m,1).f;
-            p->sample[n].smp      = *(float**)rtosc_argument(m,2).b.data;
-
-            //XXX TODO memory management (deallocation of smp buffer)
+            PADSampleTable *table =
+                *(PADSampleTable**)rtosc_argument(m,0).b.data;
+            PADSampleTable *old = p->swaptable(table);
+            if(old)
+                d.reply("/free", "sb", "PADSampleTable",
+                        sizeof(PADSampleTable*), &old);
         }},
     //weird stuff for PCoarseDetune
     {"detunevalue:", rMap(unit,cents) rDoc("Get detune value"), NULL,
@@ -239,6 +239,8 @@ static const rtosc::Ports non_realtime_ports =
             "Samples per octave"),
     rParamI(Pquality.oct, rShort("octaves"), rLinear(0,7), rDefault(3),
             "Number of octaves to sample (above the first sample"),
+    rParamI(Pphaseseed, rShort("seed"), rLinear(0,65535), rDefault(0),
+            "Seed of the random phases of the samples"),
 
     {"Pbandwidth::i", rShort("bandwidth") rProp(parameter) rLinear(0,1000)
         rDefault(500) rDoc("Bandwidth Of Harmonics"), NULL,
@@ -339,8 +341,8 @@ PADnoteParameters::PADnoteParameters(const SYNTH_T &synth_, FFTwrapper *fft_,
     FilterEnvelope->init(ad_global_filter);
     FilterLfo = new LFOParams(ad_global_filter, time_);
 
-    for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
-        sample[i].smp = NULL;
+    table = NULL;
+    swaptable(NULL);
 
     defaults();
 }
@@ -391,6 +393,7 @@ void PADnoteParameters::defaults()
     Pquality.basenote   = 4;
     Pquality.oct    = 3;
     Pquality.smpoct = 2;
+    Pphaseseed      = 0;
 
     PStereo = 1; //stereo
     /* Frequency Global Parameters */
@@ -426,21 +429,9 @@ void PADnoteParameters::defaults()
     deletesamples();
 }
 
-void PADnoteParameters::deletesample(int n)
-{
-    if((n < 0) || (n >= PAD_MAX_SAMPLES))
-        return;
-
-    delete[] sample[n].smp;
-    sample[n].smp = NULL;
-    sample[n].size     = 0;
-    sample[n].basefreq = 440.0f;
-}
-
 void PADnoteParameters::deletesamples()
 {
-    for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
-        deletesample(i);
+    PADSampleStore::release(swaptable(NULL));
 }
 
 /*
@@ -847,52 +838,105 @@ void PADnoteParameters::applyparameters()
 }
 
 void PADnoteParameters::applyparameters(std::function<bool()> do_abort,
-                                        unsigned max_threads)
+                                        unsigned max_threads,
+                                        prng_t *rnd)
 {
     if(do_abort())
         return;
-    unsigned num = sampleGenerator([this]
-                       (unsigned N, PADnoteParameters::Sample&& smp) {
-                           delete[] sample[N].smp;
-                           sample[N] = std::move(smp);
-                       },
-                       do_abort, max_threads);
-
-    //Delete remaining unused samples
-    for(unsigned i = num; i < PAD_MAX_SAMPLES; ++i)
-        deletesample(i);
+    const uint64_t key = samplekey(-1, rnd);
+    PADSampleTable *newtable;
+    if(PADSampleStore::lazy())
+        newtable = PADSampleStore::acquireLazy(key, *this,
+                                               rnd ? *rnd : phaseseed());
+    else
+        newtable = PADSampleStore::acquire(key,
+            [this, &do_abort, max_threads, rnd, key](PADSampleTable &t) {
+                t.num = sampleGenerator([&t]
+                            (unsigned N, PADnoteParameters::Sample&& smp) {
+                                t.sample[N] = std::move(smp);
+                            },
+                            do_abort, max_threads, rnd, -1, ~(uint64_t)0,
+                            key);
+                return !do_abort();
+            }, do_abort);
+
+    if(newtable)
+        PADSampleStore::release(swaptable(newtable));
 }
 
-//Requires
-// - Pquality.samplesize
-// - Pquality.basenote
-// - Pquality.oct
-// - Pquality.smpoct
-// - spectrum at various frequencies (oodles of data)
-int PADnoteParameters::sampleGenerator(PADnoteParameters::callback cb,
-        std::function<bool()> do_abort,
-        unsigned max_threads)
+static const PADnoteParameters::Sample no_samples[PAD_MAX_SAMPLES] = {};
+
+PADSampleTable *PADnoteParameters::swaptable(PADSampleTable *newtable)
 {
-    if(!max_threads)
-        max_threads = std::numeric_limits<unsigned>::max();
+    sample = newtable ? newtable->sample : no_samples;
+    std::swap(table, newtable);
+    return newtable;
+}
 
-    const int samplesize   = (((int) 1) << (Pquality.samplesize + 14));
-    const int spectrumsize = samplesize / 2;
-    const int profilesize = 512;
+int PADnoteParameters::findsample(float log2freq) const
+{
+    if(!table)
+        return 0;
+
+    int   closest = -1, available = -1;
+    float mindist = 0.0f, minavailable = 0.0f;
+    for(int i = 0; i < table->num; ++i) {
+        const float dist = fabsf(log2freq - log2f(sample[i].basefreq + 0.0001f));
+        if(closest < 0 || dist < mindist) {
+            closest = i;
+            mindist = dist;
+        }
+        if(sample[i].smp.load(std::memory_order_acquire)
+           && (available < 0 || dist < minavailable)) {
+            available    = i;
+            minavailable = dist;
+        }
+    }
 
-    float     profile[profilesize];
+    if(available != closest && table->lazy)
+        table->wanted[closest].store(true, std::memory_order_relaxed);
+    return available < 0 ? 0 : available;
+}
 
+void PADnoteParameters::usesample(int n) const
+{
+    if(table && table->lazy)
+        table->used[n].store(true, std::memory_order_relaxed);
+}
+
+//Sample sizes and frequencies of one sample set
+struct SampleLayout {
+    static const int profilesize = 512;
 
-    const float bwadjust = getprofile(profile, profilesize);
-    float basefreq = 65.406f * powf(2.0f, Pquality.basenote / 2);
-    if(Pquality.basenote % 2 == 1)
-        basefreq *= 1.5f;
+    int   samplesize, spectrumsize, samplemax;
+    float basefreq, bwadjust;
+    float profile[profilesize];
+    //used to compute the frequency relation to the base frequency
+    float adj[PAD_MAX_SAMPLES];
+};
 
-    int samplemax = Pquality.oct + 1;
-    int smpoct    = Pquality.smpoct;
-    if(Pquality.smpoct == 5)
+//Requires
+// - Pquality.samplesize (unless quality is given)
+// - Pquality.basenote
+// - Pquality.oct
+// - Pquality.smpoct
+static void sampleLayout(PADnoteParameters &p, int quality, SampleLayout &l)
+{
+    if(quality < 0)
+        quality = p.Pquality.samplesize;
+    l.samplesize   = (((int) 1) << (quality + 14));
+    l.spectrumsize = l.samplesize / 2;
+
+    l.bwadjust = p.getprofile(l.profile, SampleLayout::profilesize);
+    l.basefreq = 65.406f * powf(2.0f, p.Pquality.basenote / 2);
+    if(p.Pquality.basenote % 2 == 1)
+        l.basefreq *= 1.5f;
+
+    int samplemax = p.Pquality.oct + 1;
+    int smpoct    = p.Pquality.smpoct;
+    if(p.Pquality.smpoct == 5)
         smpoct = 6;
-    if(Pquality.smpoct == 6)
+    if(p.Pquality.smpoct == 6)
         smpoct = 12;
     if(smpoct != 0)
         samplemax *= smpoct;
@@ -903,126 +947,245 @@ int PADnoteParameters::sampleGenerator(PADnoteParameters::callback cb,
 
     if(samplemax > PAD_MAX_SAMPLES)
         samplemax = PAD_MAX_SAMPLES;
+    l.samplemax = samplemax;
 
-    //this is used to compute frequency relation to the base frequency
-    float adj[samplemax];
     for(int nsample = 0; nsample < samplemax; ++nsample)
-        adj[nsample] = (Pquality.oct + 1.0f) * (float)nsample / samplemax;
-    // QtCreator can't capture VLAs (QTCREATORBUG-23722), so this is
-    // a workaround to allow using the IDE
-    float * const adj_ptr = adj;
+        l.adj[nsample] = (p.Pquality.oct + 1.0f) * (float)nsample / samplemax;
+}
 
-    const PADnoteParameters* this_c = this;
+//Add everything the spectra of a sample set are computed from (but not the
+//phases) to key
+static void addSpectrumKey(PADnoteParameters &p, const SampleLayout &l,
+                           PADCache::Key &key)
+{
+    const SYNTH_T &synth = p.synth;
+    const int version = 2;
+    key.add(version);
+    key.add(synth.samplerate);
+    key.add(synth.oscilsize);
+    key.add(l.samplesize);
+    key.add(l.samplemax);
+    key.add(l.basefreq);
+    //the octave spread, layouts with as many samples may differ in it
+    key.add(l.adj, sizeof(float) * l.samplemax);
+    key.add((int)p.Pmode);
+    if(p.Pmode == PADnoteParameters::pad_mode::bandwidth) {
+        key.add(l.bwadjust);
+        key.add(l.profile, sizeof(l.profile));
+        key.add(p.Pbandwidth);
+        key.add(p.Pbwscale);
+    }
+    for(int nh = 1; nh < synth.oscilsize / 2; ++nh) {
+        const float nhr = p.getNhr(nh);
+        key.add(nhr);
+    }
+    const Resonance *resonance = p.resonance;
+    key.add(resonance->Penabled);
+    if(resonance->Penabled) {
+        key.add(resonance->Prespoints, sizeof(resonance->Prespoints));
+        key.add(resonance->PmaxdB);
+        key.add(resonance->Pcenterfreq);
+        key.add(resonance->Poctavesfreq);
+        key.add(resonance->ctlcenter);
+        key.add(resonance->ctlbw);
+    }
+    float harmonics[synth.oscilsize];
+    for(int nsample = 0; nsample < l.samplemax; ++nsample) {
+        const float basefreqadjust =
+            powf(2.0f, l.adj[nsample] - l.adj[l.samplemax - 1] * 0.5f);
+        memset(harmonics, 0, sizeof(float) * synth.oscilsize);
+        p.oscilgen->get(harmonics, l.basefreq * basefreqadjust, false);
+        key.add(harmonics, sizeof(float) * synth.oscilsize);
+    }
+}
 
-    auto thread_cb = [basefreq, bwadjust, &cb, do_abort,
-                      samplesize, samplemax, spectrumsize,
-                      adj_ptr, &profile, this_c](
-                      unsigned nthreads, unsigned threadno)
-    {
-        //prepare a BIG IFFT
-        FFTwrapper *fft      = new FFTwrapper(samplesize);
-        fft_t      *fftfreqs = new fft_t[samplesize / 2];
-        float      *spectrum = new float[spectrumsize];
+uint64_t PADnoteParameters::samplekey(int quality, const prng_t *rnd)
+{
+    if(oscilgen->needPrepare())
+        oscilgen->prepare();
 
-        for(int nsample = 0; nsample < samplemax; ++nsample)
-        if(nsample % nthreads == threadno)
-        {
-            if(do_abort())
-                break;
-            const float basefreqadjust =
-                powf(2.0f, adj_ptr[nsample] - adj_ptr[samplemax - 1] * 0.5f);
-
-            if(this_c->Pmode == pad_mode::bandwidth)
-                this_c->generatespectrum_bandwidthMode(spectrum,
-                                                       spectrumsize,
-                                                       basefreq*basefreqadjust,
-                                                       profile,
-                                                       profilesize,
-                                                       bwadjust);
-            else
-                this_c->generatespectrum_otherModes(spectrum, spectrumsize,
-                                                    basefreq * basefreqadjust);
-
-            //the last samples contain the first samples
-            //(used for linear/cubic interpolation)
-            const int extra_samples = 5;
-            PADnoteParameters::Sample newsample;
-            newsample.smp = new float[samplesize + extra_samples];
-
-            newsample.smp[0] = 0.0f;
-            for(int i = 1; i < spectrumsize; ++i) //randomize the phases
-                fftfreqs[i] = FFTpolar(spectrum[i], (float)RND * 2 * PI);
-            //that's all; here is the only ifft for the whole sample;
-            //no windows are used ;-)
-            fft->freqs2smps(fftfreqs, newsample.smp);
-
-
-            //normalize(rms)
-            float rms = 0.0f;
-            for(int i = 0; i < samplesize; ++i)
-                rms += newsample.smp[i] * newsample.smp[i];
-            rms = sqrtf(rms);
-            if(rms < 0.000001f)
-                rms = 1.0f;
-            rms *= sqrtf(262144.0f / samplesize);//262144=2^18
-            for(int i = 0; i < samplesize; ++i)
-                newsample.smp[i] *= 1.0f / rms * 50.0f;
-
-            //prepare extra samples used by the linear or cubic interpolation
-            for(int i = 0; i < extra_samples; ++i)
-                newsample.smp[i + samplesize] = newsample.smp[i];
-
-            //yield new sample
-            newsample.size     = samplesize;
-            newsample.basefreq = basefreq * basefreqadjust;
-            cb(nsample, std::move(newsample));
-        }
+    SampleLayout layout;
+    sampleLayout(*this, quality, layout);
+    PADCache::Key key;
+    addSpectrumKey(*this, layout, key);
+    key.add(rnd ? *rnd : phaseseed());
+    return key.hash;
+}
 
-        //Cleanup
-        delete (fft);
-        delete[] fftfreqs;
-        delete[] spectrum;
-    };
+prng_t PADnoteParameters::phaseseed(void) const
+{
+    return Pphaseseed * 2654435761u + 1;
+}
+
+int PADnoteParameters::samplefreqs(float *basefreq, int quality)
+{
+    SampleLayout layout;
+    sampleLayout(*this, quality, layout);
+    const int samplemax = layout.samplemax;
+    for(int nsample = 0; nsample < samplemax; ++nsample)
+        basefreq[nsample] = layout.basefreq
+            * powf(2.0f, layout.adj[nsample] - layout.adj[samplemax - 1] * 0.5f);
+    return samplemax;
+}
+
+int PADnoteParameters::sampleGenerator(PADnoteParameters::callback cb,
+        std::function<bool()> do_abort,
+        unsigned max_threads,
+        prng_t *rnd,
+        int quality,
+        uint64_t which,
+        uint64_t key)
+{
+    SampleLayout layout;
+    sampleLayout(*this, quality, layout);
+    const int samplesize   = layout.samplesize;
+    const int spectrumsize = layout.spectrumsize;
+    const int samplemax    = layout.samplemax;
+    const float basefreq   = layout.basefreq;
+    const float bwadjust   = layout.bwadjust;
+    const int profilesize  = SampleLayout::profilesize;
+    const float * const profile = layout.profile;
+    const float * const adj_ptr = layout.adj;
+
+    int selected[PAD_MAX_SAMPLES];
+    int nselected = 0;
+    for(int nsample = 0; nsample < samplemax; ++nsample)
+        if((which >> nsample) & 1)
+            selected[nselected++] = nsample;
+
+    //Only complete sets are cached. The key covers the initial generator
+    //state, so it is taken before the phases are drawn.
+    const bool use_cache = nselected == samplemax && PADCache::enabled();
+    if(use_cache && !key)
+        key = samplekey(quality, rnd);
+
+    //Each sample gets its own random generator state for the phases, so the
+    //result does not depend on the number of threads. The states are drawn
+    //in the same order as a single thread used to consume the generator
+    //(one draw per OscilGen::get(), then the phases).
+    prng_t param_rnd;
+    if(!rnd) {
+        param_rnd = phaseseed();
+        rnd       = &param_rnd;
+    }
+    prng_t &seed_rnd = *rnd;
+    prng_t seeds[samplemax];
+    for(int nsample = 0; nsample < samplemax; ++nsample) {
+        seeds[nsample] = (prng_r(seed_rnd) & 0x7fffffff) + 1;
+        seed_rnd = prng_skip(seeds[nsample], spectrumsize - 1);
+    }
+    prng_t * const seeds_ptr = seeds;
 
     if(oscilgen->needPrepare())
         oscilgen->prepare();
 
-#ifdef WIN32
-    //Temporarily disable multi-threading here as C++11 threads are broken on
-    //mingw cross compilation
-    thread_cb(1,0);
-#else
-    unsigned nthreads = std::min(max_threads,
-                                 std::thread::hardware_concurrency());
-    std::vector<std::thread> threads(nthreads);
-    for(unsigned i = 0; i < nthreads; ++i)
-        threads[i] = std::thread(thread_cb, nthreads, i);
-    for(unsigned i = 0; i < nthreads; ++i)
-        threads[i].join();
-#endif
+    //the last samples contain the first samples
+    //(used for linear/cubic interpolation)
+    const int extra_samples = 5;
+
+    if(use_cache
+       && PADCache::load(key, samplemax, samplesize + extra_samples, cb))
+        return samplemax;
+    PADCache::Writer writer(key, use_cache ? samplemax : 0,
+                            samplesize + extra_samples);
+    PADCache::Writer * const writer_ptr = &writer;
+
+    const PADnoteParameters* this_c = this;
+
+    //One job per sample. The lowest samples have the most harmonics within
+    //the spectrum, so starting with them balances the load best.
+    auto sample_cb = [basefreq, bwadjust, &cb, do_abort,
+                      samplesize, samplemax, spectrumsize,
+                      adj_ptr, seeds_ptr, profile, writer_ptr, this_c](
+                      int nsample, PADGeneratorPool::Scratch &scratch)
+    {
+        if(do_abort())
+            return;
+        float * const spectrum = scratch.spectrum;
+        fft_t * const fftfreqs = scratch.fftfreqs;
+        const float basefreqadjust =
+            powf(2.0f, adj_ptr[nsample] - adj_ptr[samplemax - 1] * 0.5f);
+
+        if(this_c->Pmode == pad_mode::bandwidth)
+            this_c->generatespectrum_bandwidthMode(spectrum,
+                                                   spectrumsize,
+                                                   basefreq*basefreqadjust,
+                                                   profile,
+                                                   profilesize,
+                                                   bwadjust);
+        else
+            this_c->generatespectrum_otherModes(spectrum, spectrumsize,
+                                                basefreq * basefreqadjust);
+
+        float *smp = new float[samplesize + extra_samples];
+
+        smp[0] = 0.0f;
+        prng_t rnd_state = seeds_ptr[nsample];
+        for(int i = 1; i < spectrumsize; ++i) //randomize the phases
+            fftfreqs[i] = FFTpolar(spectrum[i], rnd_r(rnd_state) * 2 * PI);
+        //that's all; here is the only ifft for the whole sample;
+        //no windows are used ;-)
+        scratch.fft.freqs2smps(fftfreqs, smp);
+
+
+        //normalize(rms)
+        float rms = 0.0f;
+        for(int i = 0; i < samplesize; ++i)
+            rms += smp[i] * smp[i];
+        rms = sqrtf(rms);
+        if(rms < 0.000001f)
+            rms = 1.0f;
+        rms *= sqrtf(262144.0f / samplesize);//262144=2^18
+        for(int i = 0; i < samplesize; ++i)
+            smp[i] *= 1.0f / rms * 50.0f;
+
+        //prepare extra samples used by the linear or cubic interpolation
+        for(int i = 0; i < extra_samples; ++i)
+            smp[i + samplesize] = smp[i];
+
+        //yield new sample
+        PADnoteParameters::Sample newsample;
+        newsample.smp      = smp;
+        newsample.size     = samplesize;
+        newsample.basefreq = basefreq * basefreqadjust;
+        writer_ptr->add(nsample, newsample);
+        cb(nsample, std::move(newsample));
+    };
+
+    PADGeneratorPool::instance().run(samplesize, nselected, max_threads,
+            [&sample_cb, &selected](int job, PADGeneratorPool::Scratch &scratch)
+            {
+                sample_cb(selected[job], scratch);
+            });
+
+    if(!do_abort())
+        writer.commit();
 
     return samplemax;
 }
 
 void PADnoteParameters::export2wav(std::string basefilename)
 {
-    applyparameters();
+    //The samples are generated here rather than taken from the table, which
+    //may be lazy
     basefilename += "_PADsynth_";
-    for(int k = 0; k < PAD_MAX_SAMPLES; ++k) {
-        if(sample[k].smp == NULL)
-            continue;
-        char tmpstr[20];
-        snprintf(tmpstr, 20, "_%02d", k + 1);
-        std::string filename = basefilename + std::string(tmpstr) + ".wav";
-        WavFile     wav(filename, synth.samplerate, 1);
-        if(wav.good()) {
-            int nsmps = sample[k].size;
-            short int *smps = new short int[nsmps];
-            for(int i = 0; i < nsmps; ++i)
-                smps[i] = (short int)(sample[k].smp[i] * 32767.0f);
-            wav.writeMonoSamples(nsmps, smps);
-        }
-    }
+    sampleGenerator([&basefilename, this](int k, PADnoteParameters::Sample &&s)
+        {
+            char tmpstr[20];
+            snprintf(tmpstr, 20, "_%02d", k + 1);
+            std::string filename = basefilename + std::string(tmpstr) + ".wav";
+            WavFile     wav(filename, synth.samplerate, 1);
+            if(wav.good()) {
+                int nsmps = s.size;
+                const float *smp = s.smp;
+                short int *smps = new short int[nsmps];
+                for(int i = 0; i < nsmps; ++i)
+                    smps[i] = (short int)(smp[i] * 32767.0f);
+                wav.writeMonoSamples(nsmps, smps);
+                delete[] smps;
+            }
+            delete[] s.smp;
+        }, []{return false;});
 }
 
 void PADnoteParameters::add2XML(XMLwrapper& xml)
@@ -1069,6 +1232,7 @@ void PADnoteParameters::add2XML(XMLwrapper& xml)
     xml.addpar("basenote", Pquality.basenote);
     xml.addpar("octaves", Pquality.oct);
     xml.addpar("samples_per_octave", Pquality.smpoct);
+    xml.addpar("phase_seed", Pphaseseed);
     xml.endbranch();
 
     xml.beginbranch("AMPLITUDE_PARAMETERS");
@@ -1181,6 +1345,7 @@ void PADnoteParameters::getfromXML(XMLwrapper& xml)
         Pquality.oct    = xml.getpar127("octaves", Pquality.oct);
         Pquality.smpoct = xml.getpar127("samples_per_octave",
                                          Pquality.smpoct);
+        Pphaseseed = xml.getpar("phase_seed", Pphaseseed, 0, 65535);
         xml.exitbranch();
     }
 
@@ -1278,6 +1443,7 @@ void PADnoteParameters::paste(PADnoteParameters &x)
     COPY(Pquality.basenote);
     COPY(Pquality.oct);
     COPY(Pquality.smpoct);
+    COPY(Pphaseseed);
 
     oscilgen->paste(*x.oscilgen);
     resonance->paste(*x.resonance);
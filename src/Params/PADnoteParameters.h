@@ -17,11 +17,15 @@
 #include "../globals.h"
 
 #include "Presets.h"
+#include "../Misc/Util.h"
+#include <atomic>
 #include <string>
 #include <functional>
 
 namespace zyn {
 
+struct PADSampleTable;
+
 /**
  * Parameters for PAD synthesis
  *
@@ -99,6 +103,9 @@ class PADnoteParameters:public Presets
             unsigned char basenote, oct, smpoct;
         } Pquality;
 
+        //seed of the random phases of the samples (see phaseseed())
+        unsigned short int Pphaseseed;
+
         //frequency parameters
         //If the base frequency is fixed to 440 Hz
         unsigned char Pfixedfreq;
@@ -158,23 +165,74 @@ class PADnoteParameters:public Presets
         float getNhr(int n) const;
 
         void applyparameters(void);
-        //! Compute the #sample array from the other parameters.
+        //! Compute the #sample array from the other parameters, or share
+        //! the table of an instrument which already did (see PADSampleStore).
+        //! In lazy mode (PADSampleStore::lazy()) most samples are only
+        //! computed once they are played.
         //! For the function's parameters, see sampleGenerator()
         void applyparameters(std::function<bool()> do_abort,
-                             unsigned max_threads = 0);
+                             unsigned max_threads = 0,
+                             prng_t *rnd = NULL);
         void export2wav(std::string basefilename);
 
         OscilGen  *oscilgen;
         Resonance *resonance;
 
         struct Sample {
+            Sample(void) :size(0), basefreq(0.0f), smp(NULL) {}
+            Sample(Sample &&s)
+                :size(s.size), basefreq(s.basefreq),
+                 smp(s.smp.load(std::memory_order_relaxed)) {}
+            Sample &operator=(Sample &&s)
+            {
+                size     = s.size;
+                basefreq = s.basefreq;
+                smp.store(s.smp.load(std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+                return *this;
+            }
+
             int    size;
             float  basefreq;
-            float *smp;
+            //Entries of lazy tables are set (release, after size and
+            //basefreq) and cleared by a worker while notes play, the
+            //realtime side loads it with acquire before using the others
+            std::atomic<float *> smp;
         };
 
-        //! RT sample data
-        Sample sample[PAD_MAX_SAMPLES];
+        //! RT sample data (the entries of #table)
+        const Sample *sample;
+
+        //! Install a sample table, taking over the reference of the caller.
+        //! Realtime safe; the previous table is returned and has to be
+        //! released with PADSampleStore::release() outside of the RT thread.
+        PADSampleTable *swaptable(PADSampleTable *newtable);
+
+        //! Hash of everything the samples are computed from, including the
+        //! state the phases are drawn from. It identifies a table in
+        //! PADSampleStore and a set in PADCache, so it is stable across
+        //! reloads of the same parameters.
+        //! @param quality Sample size to use instead of Pquality.samplesize,
+        //!                or -1
+        //! @param rnd Generator the phases are drawn from, or NULL for
+        //!            phaseseed()
+        uint64_t samplekey(int quality = -1, const prng_t *rnd = NULL);
+
+        //! Generator state of the random phases, derived from Pphaseseed
+        //! only, so equal parameters get equal samples (at any quality)
+        prng_t phaseseed(void) const;
+
+        //! Base frequencies of the samples sampleGenerator() computes
+        //! @return number of samples
+        int samplefreqs(float *basefreq, int quality = -1);
+
+        //! Index of the sample to play at log2freq. If the closest one is
+        //! missing from a lazy table, the closest generated one is used
+        //! instead and the missing one is requested. Realtime safe.
+        int findsample(float log2freq) const;
+
+        //! Mark a sample as played, so a lazy table keeps it. Realtime safe.
+        void usesample(int n) const;
 
         //! callback type for sampleGenerator
         typedef std::function<void(int,PADnoteParameters::Sample&&)> callback;
@@ -190,9 +248,21 @@ class PADnoteParameters:public Presets
         //!                 user)
         //! @param max_threads Maximum number of threads for computation, or
         //!                    zero if no maximum shall be set
+        //! @param rnd Generator the phases are drawn from, or NULL for one
+        //!            seeded with phaseseed()
+        //! @param quality Sample size to use instead of Pquality.samplesize
+        //!                (e.g. for a quick preview), or -1
+        //! @param which Bit mask of the samples to compute (the phases do
+        //!              not depend on it)
+        //! @param key samplekey(quality, rnd) if the caller has it already,
+        //!            or 0
         int sampleGenerator(PADnoteParameters::callback cb,
                             std::function<bool()> do_abort,
-                            unsigned max_threads = 0);
+                            unsigned max_threads = 0,
+                            prng_t *rnd = NULL,
+                            int quality = -1,
+                            uint64_t which = ~(uint64_t)0,
+                            uint64_t key = 0);
 
         const AbsTime *time;
         int64_t last_update_timestamp;
@@ -212,7 +282,9 @@ class PADnoteParameters:public Presets
                                          int size,
                                          float basefreq) const;
         void deletesamples();
-        void deletesample(int n);
+
+        //! Shared table the samples belong to
+        PADSampleTable *table;
 
     public:
         const SYNTH_T &synth;
@@ -82,6 +82,9 @@ static const rtosc::Ports SUBnotePorts = {
         "Pitch bend adjustment"),
     rParamZyn(POffsetHz,    rShort("+ Hz"),       rDefault(64),
         "Voice constant offset"),
+    rParamZyn(PCoefTolerance, rShort("coef. tol."), rDefault(0),
+        "Frequency and bandwidth change (in 0.1 cents) below which the "
+        "filter coefficients are not recomputed (0 recomputes on any change)"),
 #undef rChangeCb
 #define rChangeCb obj->updateFrequencyMultipliers(); if (obj->time) { \
     obj->last_update_timestamp = obj->time->time(); }
@@ -308,6 +311,7 @@ void SUBnoteParameters::defaults()
     PfixedfreqET = 0;
     PBendAdjust = 88; // 64 + 24
     POffsetHz = 64;
+    PCoefTolerance = 0;
     Pnumstages   = 2;
     Pbandwidth   = 40;
     Phmagtype    = 0;
@@ -390,6 +394,7 @@ void SUBnoteParameters::add2XML(XMLwrapper& xml)
     xml.addpar("fixed_freq_et", PfixedfreqET);
     xml.addpar("bend_adjust", PBendAdjust);
     xml.addpar("offset_hz", POffsetHz);
+    xml.addpar("coefficient_tolerance", PCoefTolerance);
 
     xml.addpar("detune", PDetune);
     xml.addpar("coarse_detune", PCoarseDetune);
@@ -512,6 +517,7 @@ void SUBnoteParameters::paste(SUBnoteParameters &sub)
     doPaste(PDetuneType);
     doPaste(PBendAdjust);
     doPaste(POffsetHz);
+    doPaste(PCoefTolerance);
     doPaste(PFreqEnvelopeEnabled);
     doPPaste(FreqEnvelope);
     doPaste(PBandWidthEnvelopeEnabled);
@@ -605,6 +611,8 @@ void SUBnoteParameters::getfromXML(XMLwrapper& xml)
         PfixedfreqET = xml.getpar127("fixed_freq_et", PfixedfreqET);
         PBendAdjust  = xml.getpar127("bend_adjust", PBendAdjust);
         POffsetHz  = xml.getpar127("offset_hz", POffsetHz);
+        PCoefTolerance = xml.getpar127("coefficient_tolerance",
+                                       PCoefTolerance);
 
         PDetune = xml.getpar("detune", PDetune, 0, 16383);
         PCoarseDetune = xml.getpar("coarse_detune", PCoarseDetune, 0, 16383);
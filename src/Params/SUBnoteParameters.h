@@ -60,6 +60,10 @@ class SUBnoteParameters:public Presets
         unsigned char     PBendAdjust;
         unsigned char     POffsetHz;
 
+        //Frequency/bandwidth change (in 0.1 cents) ignored by the filters,
+        //0 (default) keeps the exact behaviour of older patches
+        unsigned char     PCoefTolerance;
+
         //Filter Parameters (Global)
         unsigned char   PGlobalFilterEnabled;
         FilterParams   *GlobalFilter;
@@ -39,8 +39,9 @@ template<class ZynFX>
 class AbstractPluginFX : public Plugin
 {
 public:
-    AbstractPluginFX(const uint32_t params, const uint32_t programs)
-        : Plugin(params-2, programs, 0),
+    AbstractPluginFX(const uint32_t params, const uint32_t programs,
+                     const uint32_t states = 0)
+        : Plugin(params-2, programs, states),
           paramCount(params-2), // volume and pan handled by host
           programCount(programs),
           bufferSize(getBufferSize()),
@@ -227,6 +228,14 @@ protected:
 
     // -------------------------------------------------------------------------------------------------------
 
+   /**
+      The current effect, it is recreated when the buffer size or sample rate change.
+    */
+    ZynFX* getEffect() const noexcept
+    {
+        return static_cast<ZynFX*>(effect);
+    }
+
 private:
     const uint32_t paramCount;
     const uint32_t programCount;
@@ -254,7 +263,7 @@ private:
             delete effect;
         }
 
-        zyn::EffectParams pars(allocator, false, efxoutl, efxoutr, 0, static_cast<uint>(sampleRate), static_cast<int>(bufferSize), filterpar);
+        zyn::EffectParams pars(allocator, false, efxoutl, efxoutr, 0, static_cast<uint>(sampleRate), static_cast<int>(bufferSize), filterpar, false, zyn::prng());
         effect = new ZynFX(pars);
 
         if (firstInit)
@@ -24,7 +24,7 @@ class ChorusPlugin : public AbstractPluginFX<zyn::Chorus>
 {
 public:
     ChorusPlugin()
-        : AbstractPluginFX(12, 10) {}
+        : AbstractPluginFX(13, 12) {}
 
 protected:
    /* --------------------------------------------------------------------------------------------------------
@@ -135,6 +135,13 @@ protected:
             parameter.ranges.def = 0.0f;
             parameter.ranges.max = 1.0f;
             break;
+        case 10:
+            parameter.name   = "Voices";
+            parameter.symbol = "voices";
+            parameter.ranges.def = 1.0f;
+            parameter.ranges.min = 1.0f;
+            parameter.ranges.max = 8.0f;
+            break;
         }
     }
 
@@ -176,6 +183,12 @@ protected:
         case 9:
             programName = "Flange 5";
             break;
+        case 10:
+            programName = "Ensemble 1";
+            break;
+        case 11:
+            programName = "Ensemble 2";
+            break;
         }
     }
 
@@ -0,0 +1,212 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  Convolution.cpp - DPF + Zyn Plugin for Convolution
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+
+// DPF includes
+#include "../AbstractFX.hpp"
+
+// ZynAddSubFX includes
+#include "Effects/Convolution.h"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+
+/* ------------------------------------------------------------------------------------------------------------
+ * Convolution plugin class */
+
+class ConvolutionPlugin : public AbstractPluginFX<zyn::Convolution>
+{
+public:
+    ConvolutionPlugin()
+        : AbstractPluginFX(3, 2, 1),
+          current(nullptr),
+          pending(nullptr),
+          retired(nullptr) {}
+
+    ~ConvolutionPlugin() override
+    {
+        delete current;
+        delete pending.load();
+        delete retired.load();
+    }
+
+protected:
+   /* --------------------------------------------------------------------------------------------------------
+    * Information */
+
+   /**
+      Get the plugin label.
+      This label is a short restricted name consisting of only _, a-z, A-Z and 0-9 characters.
+    */
+    const char* getLabel() const noexcept override
+    {
+        return "Convolution";
+    }
+
+   /**
+      Get an extensive comment/description about the plugin.
+    */
+    const char* getDescription() const noexcept override
+    {
+        return "Convolves the input with the impulse response of a wav file";
+    }
+
+   /**
+      Get the plugin unique Id.
+      This value is used by LADSPA, DSSI and VST plugin formats.
+    */
+    int64_t getUniqueId() const noexcept override
+    {
+        return d_cconst('Z', 'X', 'c', 'v');
+    }
+
+   /* --------------------------------------------------------------------------------------------------------
+    * Init */
+
+   /**
+      Initialize the parameter @a index.
+      This function will be called once, shortly after the plugin is created.
+    */
+    void initParameter(uint32_t index, Parameter& parameter) noexcept override
+    {
+        parameter.hints = kParameterIsInteger|kParameterIsAutomable;
+        parameter.unit  = "";
+        parameter.ranges.min = 0.0f;
+        parameter.ranges.max = 127.0f;
+
+        switch (index)
+        {
+        case 0:
+            parameter.name   = "L/R Cross";
+            parameter.symbol = "lrcross";
+            parameter.ranges.def = 0.0f;
+            break;
+        }
+    }
+
+   /**
+      Set the name of the program @a index.
+      This function will be called once, shortly after the plugin is created.
+    */
+    void initProgramName(uint32_t index, String& programName) noexcept override
+    {
+        switch (index)
+        {
+        case 0:
+            programName = "Stereo";
+            break;
+        case 1:
+            programName = "Mono";
+            break;
+        }
+    }
+
+   /**
+      Set the state key and default value of @a index.
+      This function will be called once, shortly after the plugin is created.
+    */
+    void initState(uint32_t, String& stateKey, String& defaultStateValue) override
+    {
+        stateKey = "irfile";
+        defaultStateValue = "";
+    }
+
+   /* --------------------------------------------------------------------------------------------------------
+    * Internal data */
+
+   /**
+      Change an internal state @a key to @a value.
+      The response is loaded right here and handed over to run() afterwards.
+    */
+    void setState(const char* key, const char* value) override
+    {
+        if (std::strcmp(key, "irfile") != 0)
+            return;
+
+        irfile = value;
+        loadImpulse();
+    }
+
+   /* --------------------------------------------------------------------------------------------------------
+    * Audio/MIDI Processing */
+
+    void run(const float** inputs, float** outputs, uint32_t frames) override
+    {
+        // take over a new response once the previous one has been freed
+        if (retired.load() == nullptr)
+        {
+            if (zyn::ConvolutionIR* const ir = pending.exchange(nullptr))
+            {
+                retired.store(current);
+                current = ir;
+                getEffect()->setimpulse(current);
+            }
+        }
+
+        AbstractPluginFX::run(inputs, outputs, frames);
+    }
+
+   /* --------------------------------------------------------------------------------------------------------
+    * Callbacks (optional) */
+
+    // the effect is recreated, and the response has to be made for the new setup
+    void bufferSizeChanged(uint32_t newBufferSize) override
+    {
+        AbstractPluginFX::bufferSizeChanged(newBufferSize);
+        loadImpulse();
+    }
+
+    void sampleRateChanged(double newSampleRate) override
+    {
+        AbstractPluginFX::sampleRateChanged(newSampleRate);
+        loadImpulse();
+    }
+
+    // -------------------------------------------------------------------------------------------------------
+
+private:
+    std::string irfile;
+
+    // owned by run()
+    zyn::ConvolutionIR* current;
+    // loaded but not yet taken over by run()
+    std::atomic<zyn::ConvolutionIR*> pending;
+    // given back by run(), freed by the next load
+    std::atomic<zyn::ConvolutionIR*> retired;
+
+    void loadImpulse()
+    {
+        delete retired.exchange(nullptr);
+
+        // an empty response (no file or a broken one) silences the effect
+        zyn::ConvolutionIR* const ir = new zyn::ConvolutionIR;
+        if (! irfile.empty())
+            ir->loadfile(irfile, static_cast<uint>(getSampleRate()),
+                         static_cast<int>(getBufferSize()));
+
+        delete pending.exchange(ir);
+    }
+
+    DISTRHO_DECLARE_NON_COPY_CLASS(ConvolutionPlugin)
+};
+
+/* ------------------------------------------------------------------------------------------------------------
+ * Create plugin, entry point */
+
+START_NAMESPACE_DISTRHO
+
+Plugin* createPlugin()
+{
+    return new ConvolutionPlugin();
+}
+
+END_NAMESPACE_DISTRHO
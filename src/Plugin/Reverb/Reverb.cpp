@@ -24,7 +24,7 @@ class ReverbPlugin : public AbstractPluginFX<zyn::Reverb>
 {
 public:
     ReverbPlugin()
-        : AbstractPluginFX(13, 13) {}
+        : AbstractPluginFX(13, 15) {}
 
 protected:
    /* --------------------------------------------------------------------------------------------------------
@@ -123,15 +123,17 @@ protected:
             parameter.name   = "Type";
             parameter.symbol = "type";
             parameter.ranges.def = 1.0f;
-            parameter.ranges.max = 2.0f;
+            parameter.ranges.max = 3.0f;
             /*
             TODO: support for scalePoints in DPF
             scalePoints[0].label = "Random";
             scalePoints[1].label = "Freeverb";
             scalePoints[2].label = "Bandwidth";
+            scalePoints[3].label = "FDN";
             scalePoints[0].value = 0.0f;
             scalePoints[1].value = 1.0f;
             scalePoints[2].value = 2.0f;
+            scalePoints[3].value = 3.0f;
             */
             break;
         case 9:
@@ -195,6 +197,12 @@ protected:
         case 12:
             programName = "Very Long 2";
             break;
+        case 13:
+            programName = "Dense Hall";
+            break;
+        case 14:
+            programName = "Dense Room";
+            break;
         }
     }
 
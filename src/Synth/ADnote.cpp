@@ -26,6 +26,7 @@
 #include "../Containers/NotePool.h"
 #include "ModFilter.h"
 #include "OscilGen.h"
+#include "UnisonKernel.h"
 #include "ADnote.h"
 
 #define LENGTHOF(x) ((int)(sizeof(x)/sizeof(x[0])))
@@ -47,8 +48,6 @@ ADnote::ADnote(ADnoteParameters *pars_, const SynthParams &spars,
     note_log2_freq = spars.note_log2_freq;
     NoteEnabled = ON;
     velocity    = spars.velocity;
-    initial_seed = spars.seed;
-    current_prng_state = spars.seed;
     stereo = pars.GlobalPar.PStereo;
 
     NoteGlobalPar.Detune = getdetune(pars.GlobalPar.PDetuneType,
@@ -108,7 +107,7 @@ void ADnote::setupVoice(int nvoice)
     for (int i = 0; i < 14; i++)
         voice.pinking[i] = 0.0;
 
-    param.OscilGn->newrandseed(prng());
+    param.OscilGn->newrandseed(getRandomUint());
     voice.OscilSmp = NULL;
     voice.FMSmp    = NULL;
     voice.VoiceOut = NULL;
@@ -122,6 +121,8 @@ void ADnote::setupVoice(int nvoice)
     }
     NoteVoicePar[nvoice].AAEnabled =
                 pars.VoicePar[nvoice].PAAEnabled;
+    NoteVoicePar[nvoice].AAType =
+                pars.VoicePar[nvoice].PAAType;
 
     const int BendAdj = pars.VoicePar[nvoice].PBendAdjust - 64;
     if (BendAdj % 24 == 0)
@@ -170,11 +171,12 @@ void ADnote::setupVoice(int nvoice)
     if(pars.VoicePar[nvoice].Pextoscil != -1)
         vc = pars.VoicePar[nvoice].Pextoscil;
     if(!pars.GlobalPar.Hrandgrouping)
-        pars.VoicePar[vc].OscilGn->newrandseed(prng());
+        pars.VoicePar[vc].OscilGn->newrandseed(getRandomUint());
     int oscposhi_start =
         pars.VoicePar[vc].OscilGn->get(NoteVoicePar[nvoice].OscilSmp,
                 getvoicebasefreq(nvoice),
                 pars.VoicePar[nvoice].Presonance);
+    skipOscilRandom();
 
     // This code was planned for biasing the carrier in MOD_RING
     // but that's on hold for the moment.  Disabled 'cos small
@@ -205,7 +207,7 @@ void ADnote::setupVoice(int nvoice)
         voice.oscposhi[k] = kth_start % synth.oscilsize;
         //put random starting point for other subvoices
         kth_start      = oscposhi_start +
-            (int)(RND * pars.VoicePar[nvoice].Unison_phase_randomness /
+            (int)(getRandomFloat() * pars.VoicePar[nvoice].Unison_phase_randomness /
                     127.0f * (synth.oscilsize - 1));
     }
 
@@ -286,7 +288,7 @@ int ADnote::setupVoiceUnison(int nvoice)
             float min = -1e-6f, max = 1e-6f;
             for(int k = 0; k < true_unison; ++k) {
                 float step = (k / (float) (true_unison - 1)) * 2.0f - 1.0f; //this makes the unison spread more uniform
-                float val  = step + (RND * 2.0f - 1.0f) / (true_unison - 1);
+                float val  = step + (getRandomFloat() * 2.0f - 1.0f) / (true_unison - 1);
                 unison_values[k] = val;
                 if (min > val) {
                     min = val;
@@ -327,12 +329,12 @@ int ADnote::setupVoiceUnison(int nvoice)
     const float vib_speed = pars.VoicePar[nvoice].Unison_vibratto_speed / 127.0f;
     const float vibratto_base_period  = 0.25f * powf(2.0f, (1.0f - vib_speed) * 4.0f);
     for(int k = 0; k < unison; ++k) {
-        voice.unison_vibratto.position[k] = RND * 1.8f - 0.9f;
+        voice.unison_vibratto.position[k] = getRandomFloat() * 1.8f - 0.9f;
         //make period to vary randomly from 50% to 200% vibratto base period
         const float vibratto_period = vibratto_base_period
-            * powf(2.0f, RND * 2.0f - 1.0f);
+            * powf(2.0f, getRandomFloat() * 2.0f - 1.0f);
 
-        const float m = (RND < 0.5f ? -1.0f : 1.0f) *
+        const float m = (getRandomFloat() < 0.5f ? -1.0f : 1.0f) *
             4.0f / (vibratto_period * increments_per_second);
         voice.unison_vibratto.step[k] = m;
 
@@ -369,7 +371,7 @@ int ADnote::setupVoiceUnison(int nvoice)
                 break;
             case 1:
                 for(int k = 0; k < unison; ++k)
-                    voice.unison_invert_phase[k] = (RND > 0.5f);
+                    voice.unison_invert_phase[k] = (getRandomFloat() > 0.5f);
                 break;
             default:
                 for(int k = 0; k < unison; ++k)
@@ -435,7 +437,7 @@ void ADnote::setupVoiceMod(int nvoice, bool first_run)
 
     //Triggers when a user enables modulation on a running voice
     if(!first_run && voice.FMEnabled != FMTYPE::NONE && voice.FMSmp == NULL && voice.FMVoice < 0) {
-        param.FmGn->newrandseed(prng());
+        param.FmGn->newrandseed(getRandomUint());
         voice.FMSmp = memory.valloc<float>(synth.oscilsize + OSCIL_SMP_EXTRA_SAMPLES);
         memset(voice.FMSmp, 0, sizeof(float)*(synth.oscilsize + OSCIL_SMP_EXTRA_SAMPLES));
         int vc = nvoice;
@@ -449,13 +451,15 @@ void ADnote::setupVoiceMod(int nvoice, bool first_run)
             tmp = getFMvoicebasefreq(nvoice);
 
         if(!pars.GlobalPar.Hrandgrouping)
-            pars.VoicePar[vc].FmGn->newrandseed(prng());
+            pars.VoicePar[vc].FmGn->newrandseed(getRandomUint());
 
-        for(int k = 0; k < voice.unison_size; ++k)
+        for(int k = 0; k < voice.unison_size; ++k) {
             voice.oscposhiFM[k] = (voice.oscposhi[k]
                     + pars.VoicePar[vc].FmGn->get(
                         voice.FMSmp, tmp))
                 % synth.oscilsize;
+            skipOscilRandom();
+        }
 
         for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
             voice.FMSmp[synth.oscilsize + i] = voice.FMSmp[i];
@@ -503,7 +507,9 @@ SynthNote *ADnote::cloneLegato(void)
     SynthParams sp{memory, ctl, synth, time, velocity,
                 (bool)portamento, legato.param.note_log2_freq, true,
                 initial_seed };
-    return memory.alloc<ADnote>(&pars, sp);
+    SynthNote *note = memory.alloc<ADnote>(&pars, sp);
+    note->setStartOffset(start_offset);
+    return note;
 }
 
 // ADlegatonote: This function is (mostly) a copy of ADnote(...) and
@@ -676,6 +682,8 @@ void ADnote::legatonote(const LegatoParams &lpars)
 
         NoteVoicePar[nvoice].AAEnabled =
                 pars.VoicePar[nvoice].PAAEnabled;
+        NoteVoicePar[nvoice].AAType =
+                pars.VoicePar[nvoice].PAAType;
 
         if(pars.VoicePar[nvoice].PPanning == 0) {
             NoteVoicePar[nvoice].Panning = getRandomFloat();
@@ -702,7 +710,7 @@ void ADnote::legatonote(const LegatoParams &lpars)
         /* Voice Modulation Parameters Init */
         if((NoteVoicePar[nvoice].FMEnabled != FMTYPE::NONE)
            && (NoteVoicePar[nvoice].FMVoice < 0)) {
-            pars.VoicePar[nvoice].FmGn->newrandseed(prng());
+            pars.VoicePar[nvoice].FmGn->newrandseed(getRandomUint());
 
             //Perform Anti-aliasing only on MIX or RING MODULATION
 
@@ -711,7 +719,7 @@ void ADnote::legatonote(const LegatoParams &lpars)
                 vc = pars.VoicePar[nvoice].PextFMoscil;
 
             if(!pars.GlobalPar.Hrandgrouping)
-                pars.VoicePar[vc].FmGn->newrandseed(prng());
+                pars.VoicePar[vc].FmGn->newrandseed(getRandomUint());
 
             for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
                 NoteVoicePar[nvoice].FMSmp[synth.oscilsize + i] =
@@ -808,7 +816,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
     NoteGlobalPar.initparameters(pars.GlobalPar, synth,
                                  time,
                                  memory, basefreq, velocity,
-                                 stereo, wm, prefix);
+                                 stereo, wm, prefix, &current_prng_state);
 
     NoteGlobalPar.AmpEnvelope->envout_dB(); //discard the first envelope output
     globalnewamplitude = NoteGlobalPar.Volume
@@ -854,7 +862,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
 
         if(param.PAmpLfoEnabled) {
             vce.AmpLfo = memory.alloc<LFO>(*param.AmpLfo, basefreq, time, wm,
-                    (pre+"VoicePar"+nvoice+"/AmpLfo/").c_str);
+                    (pre+"VoicePar"+nvoice+"/AmpLfo/").c_str, &current_prng_state);
             vce.newamplitude *= vce.AmpLfo->amplfoout();
         }
 
@@ -866,7 +874,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
 
         if(param.PFreqLfoEnabled)
             vce.FreqLfo = memory.alloc<LFO>(*param.FreqLfo, basefreq, time, wm,
-                    (pre+"VoicePar"+nvoice+"/FreqLfo/").c_str);
+                    (pre+"VoicePar"+nvoice+"/FreqLfo/").c_str, &current_prng_state);
 
         /* Voice Filter Parameters Init */
         if(param.PFilterEnabled) {
@@ -886,14 +894,14 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
 
             if(param.PFilterLfoEnabled) {
                 vce.FilterLfo = memory.alloc<LFO>(*param.FilterLfo, basefreq, time, wm,
-                        (pre+"VoicePar"+nvoice+"/FilterLfo/").c_str);
+                        (pre+"VoicePar"+nvoice+"/FilterLfo/").c_str, &current_prng_state);
                 vce.Filter->addMod(*vce.FilterLfo);
             }
         }
 
         /* Voice Modulation Parameters Init */
         if((vce.FMEnabled != FMTYPE::NONE) && (vce.FMVoice < 0)) {
-            param.FmGn->newrandseed(prng());
+            param.FmGn->newrandseed(getRandomUint());
             vce.FMSmp = memory.valloc<float>(synth.oscilsize + OSCIL_SMP_EXTRA_SAMPLES);
 
             //Perform Anti-aliasing only on MIX or RING MODULATION
@@ -909,13 +917,15 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
                 tmp = getFMvoicebasefreq(nvoice);
 
             if(!pars.GlobalPar.Hrandgrouping)
-                pars.VoicePar[vc].FmGn->newrandseed(prng());
+                pars.VoicePar[vc].FmGn->newrandseed(getRandomUint());
 
-            for(int k = 0; k < vce.unison_size; ++k)
+            for(int k = 0; k < vce.unison_size; ++k) {
                 vce.oscposhiFM[k] = (vce.oscposhi[k]
                                          + pars.VoicePar[vc].FmGn->get(
                                              vce.FMSmp, tmp))
                                         % synth.oscilsize;
+                skipOscilRandom();
+            }
 
             for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
                 vce.FMSmp[synth.oscilsize + i] = vce.FMSmp[i];
@@ -1219,28 +1229,12 @@ inline void ADnote::fadein(float *smps) const
 inline void ADnote::ComputeVoiceOscillator_LinearInterpolation(int nvoice)
 {
     Voice& vce = NoteVoicePar[nvoice];
-    for(int k = 0; k < vce.unison_size; ++k) {
-        int    poshi  = vce.oscposhi[k];
-        // convert floating point fractional part (sample interval phase)
-        // with range [0.0 ... 1.0] to fixed point with 1 digit is 2^-24
-        // by multiplying with precalculated 2^24 and casting to integer:
-        int    poslo  = (int)(vce.oscposlo[k] * 16777216.0f);
-        int    freqhi = vce.oscfreqhi[k];
-        // same for phase increment:
-        int    freqlo = (int)(vce.oscfreqlo[k] * 16777216.0f);
-        float *smps   = NoteVoicePar[nvoice].OscilSmp;
-        float *tw     = tmpwave_unison[k];
+    for(int k = 0; k < vce.unison_size; ++k)
         assert(vce.oscfreqlo[k] < 1.0f);
-        for(int i = 0; i < synth.buffersize; ++i) {
-            tw[i]  = (smps[poshi] * (0x01000000 - poslo) + smps[poshi + 1] * poslo)/(16777216.0f);
-            poslo += freqlo;                // increment fractional part (sample interval phase)
-            poshi += freqhi + (poslo>>24);  // add overflow over 24 bits in poslo to poshi
-            poslo &= 0xffffff;              // remove overflow from poslo
-            poshi &= synth.oscilsize - 1;   // remove overflow
-        }
-        vce.oscposhi[k] = poshi;
-        vce.oscposlo[k] = poslo/(16777216.0f);
-    }
+    //unisonLinearScalar() is the reference for the vector kernels
+    unisonLinear(vce.OscilSmp, synth.oscilsize, vce.oscposhi, vce.oscposlo,
+                 vce.oscfreqhi, vce.oscfreqlo, tmpwave_unison,
+                 vce.unison_size, synth.buffersize);
 }
 
 
@@ -1339,6 +1333,24 @@ inline void ADnote::ComputeVoiceOscillator_SincInterpolation(int nvoice)
 }
 
 
+/*
+ * Computes the Oscillator (Without Modulation) - polyphase sinc Interpolation
+ *
+ * Same purpose as the windowed sinc version above, but the kernel works on
+ * the wavetable itself with coefficients precomputed per fractional phase.
+ * The oscillator is band limited to the note (see OscilGen::get()), so
+ * removing the interpolation images is sufficient for any step, including
+ * steps of several table samples.
+ */
+inline void ADnote::ComputeVoiceOscillator_PolyphaseInterpolation(int nvoice)
+{
+    Voice& vce = NoteVoicePar[nvoice];
+    unisonPolyphase(vce.OscilSmp, synth.oscilsize, vce.oscposhi, vce.oscposlo,
+                    vce.oscfreqhi, vce.oscfreqlo, tmpwave_unison,
+                    vce.unison_size, synth.buffersize);
+}
+
+
 /*
  * Computes the Oscillator (Mixing)
  */
@@ -1593,8 +1605,9 @@ inline void ADnote::ComputeVoiceWhiteNoise(int nvoice)
 {
     for(int k = 0; k < NoteVoicePar[nvoice].unison_size; ++k) {
         float *tw = tmpwave_unison[k];
+        rnd_fill(current_prng_state, tw, synth.buffersize);
         for(int i = 0; i < synth.buffersize; ++i)
-            tw[i] = RND * 2.0f - 1.0f;
+            tw[i] = tw[i] * 2.0f - 1.0f;
     }
 }
 
@@ -1604,8 +1617,9 @@ inline void ADnote::ComputeVoicePinkNoise(int nvoice)
     for(int k = 0; k < vce.unison_size; ++k) {
         float *tw = tmpwave_unison[k];
         float *f = &vce.pinking[k > 0 ? 7 : 0];
+        rnd_fill(current_prng_state, tw, synth.buffersize);
         for(int i = 0; i < synth.buffersize; ++i) {
-            float white = (RND-0.5f)/4.0f;
+            float white = (tw[i]-0.5f)/4.0f;
             f[0] = 0.99886f*f[0]+white*0.0555179f;
             f[1] = 0.99332f*f[1]+white*0.0750759f;
             f[2] = 0.96900f*f[2]+white*0.1538520f;
@@ -1675,8 +1689,9 @@ int ADnote::noteout(float *outl, float *outr)
                                                                   NoteVoicePar[nvoice].FMEnabled);
                         break;
                     default:
-                        if(NoteVoicePar[nvoice].AAEnabled) ComputeVoiceOscillator_SincInterpolation(nvoice);
-                        else ComputeVoiceOscillator_LinearInterpolation(nvoice);
+                        if(!NoteVoicePar[nvoice].AAEnabled) ComputeVoiceOscillator_LinearInterpolation(nvoice);
+                        else if(NoteVoicePar[nvoice].AAType == AATYPE::POLYPHASE) ComputeVoiceOscillator_PolyphaseInterpolation(nvoice);
+                        else ComputeVoiceOscillator_SincInterpolation(nvoice);
                         //if (config.cfg.Interpolation) ComputeVoiceOscillator_CubicInterpolation(nvoice);
                 }
                 break;
@@ -2015,18 +2030,19 @@ void ADnote::Global::initparameters(const ADnoteGlobalParam &param,
                                     float basefreq, float velocity,
                                     bool stereo,
                                     WatchManager *wm,
-                                    const char *prefix)
+                                    const char *prefix,
+                                    prng_t *rnd)
 {
     ScratchString pre = prefix;
     FreqEnvelope = memory.alloc<Envelope>(*param.FreqEnvelope, basefreq,
             synth.dt(), wm, (pre+"GlobalPar/FreqEnvelope/").c_str);
     FreqLfo      = memory.alloc<LFO>(*param.FreqLfo, basefreq, time, wm,
-                   (pre+"GlobalPar/FreqLfo/").c_str);
+                   (pre+"GlobalPar/FreqLfo/").c_str, rnd);
 
     AmpEnvelope = memory.alloc<Envelope>(*param.AmpEnvelope, basefreq,
             synth.dt(), wm, (pre+"GlobalPar/AmpEnvelope/").c_str);
     AmpLfo      = memory.alloc<LFO>(*param.AmpLfo, basefreq, time, wm,
-                   (pre+"GlobalPar/AmpLfo/").c_str);
+                   (pre+"GlobalPar/AmpLfo/").c_str, rnd);
 
     Volume = dB2rap(param.Volume)
              * VelF(velocity, param.PAmpVelocityScaleFunction);     //sensing
@@ -2037,7 +2053,7 @@ void ADnote::Global::initparameters(const ADnoteGlobalParam &param,
     FilterEnvelope = memory.alloc<Envelope>(*param.FilterEnvelope, basefreq,
             synth.dt(), wm, (pre+"GlobalPar/FilterEnvelope/").c_str);
     FilterLfo      = memory.alloc<LFO>(*param.FilterLfo, basefreq, time, wm,
-                   (pre+"GlobalPar/FilterLfo/").c_str);
+                   (pre+"GlobalPar/FilterLfo/").c_str, rnd);
 
     Filter->addMod(*FilterEnvelope);
     Filter->addMod(*FilterLfo);
@@ -26,7 +26,8 @@
 /**FM amplitude tune*/
 #define FM_AMP_MULTIPLIER 14.71280603f
 
-#define OSCIL_SMP_EXTRA_SAMPLES 5
+//wrapped around samples after the oscillator, enough for UNISON_POLYPHASE_TAPS
+#define OSCIL_SMP_EXTRA_SAMPLES 32
 
 namespace zyn {
 
@@ -58,6 +59,11 @@ class ADnote:public SynthNote
         int  setupVoiceUnison(int nvoice);
         void setupVoiceDetune(int nvoice);
         void setupVoiceMod(int nvoice, bool first_run = true);
+        /**Reseeds the note's generator after OscilGen::get(), so the
+         * randomness after every oscillator is independent of how much of
+         * the stream that oscillator used. The random phases of a note
+         * follow from its seed and differ from the old global sequence.*/
+        void skipOscilRandom(void) { current_prng_state = getRandomUint() + 1; }
         VecWatchPoint watch_be4_add,watch_after_add, watch_punch, watch_legato;
         /**Changes the frequency of an oscillator.
          * @param nvoice voice to run computations on
@@ -87,6 +93,9 @@ class ADnote:public SynthNote
          * Affects tmpwave_unison and updates oscposhi/oscposlo
          * @todo remove this declaration if it is commented out*/
         inline void ComputeVoiceOscillator_SincInterpolation(int nvoice);
+        /**Compute the Oscillator's samples with the polyphase interpolator.
+         * Affects tmpwave_unison and updates oscposhi/oscposlo*/
+        inline void ComputeVoiceOscillator_PolyphaseInterpolation(int nvoice);
         /**Compute the Oscillator's samples.
          * Affects tmpwave_unison and updates oscposhi/oscposlo
          * @todo remove this declaration if it is commented out*/
@@ -133,7 +142,8 @@ class ADnote:public SynthNote
                                 float basefreq, float velocity,
                                 bool stereo,
                                 WatchManager *wm,
-                                const char *prefix);
+                                const char *prefix,
+                                prng_t *rnd);
             /******************************************
             *     FREQUENCY GLOBAL PARAMETERS        *
             ******************************************/
@@ -179,6 +189,7 @@ class ADnote:public SynthNote
 
             /* if AntiAliasing is enabled */
             bool AAEnabled;
+            AATYPE AAType;
 
             /* Voice Type (sound/noise)*/
             int noisetype;
@@ -14,6 +14,7 @@
 #include "LFO.h"
 #include "../Params/LFOParams.h"
 #include "../Misc/Util.h"
+#include "../DSP/FastMath.h"
 
 #include <cstdlib>
 #include <cstdio>
@@ -22,11 +23,13 @@
 namespace zyn {
 
 LFO::LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManager *m,
-        const char *watch_prefix)
+        const char *watch_prefix, prng_t *rnd_)
     :first_half(-1),
     delayTime(t, lfopars.delay), //0..4 sec
     waveShape(lfopars.PLFOtype),
     deterministic(!lfopars.Pfreqrand),
+    own_rnd(0x1234),
+    rnd(rnd_ ? rnd_ : &own_rnd),
     dt_(t.dt()),
     lfopars_(lfopars), 
     basefreq_(basefreq),
@@ -44,7 +47,7 @@ LFO::LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManage
 
     if(!lfopars.Pcontinous) {
         if(lfopars.Pstartphase == 0)
-            phase = RND;
+            phase = rnd_r(*rnd);
         else
             phase = fmod((lfopars.Pstartphase - 64.0f) / 127.0f + 1.0f, 1.0f);
     }
@@ -80,8 +83,8 @@ LFO::LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManage
     rampUp = 0.0f;
     rampDown = 1.0f;
 
-    amp1     = (1 - lfornd) + lfornd * RND;
-    amp2     = (1 - lfornd) + lfornd * RND;
+    amp1     = (1 - lfornd) + lfornd * rnd_r(*rnd);
+    amp2     = (1 - lfornd) + lfornd * rnd_r(*rnd);
     incrnd   = nextincrnd = 1.0f;
     computeNextFreqRnd();
     computeNextFreqRnd(); //twice because I want incrnd & nextincrnd to be random
@@ -114,17 +117,17 @@ float LFO::baseOut(const char waveShape, const float phase)
             break;
         case LFO_RAMPUP:    return (phase - 0.5f) * 2.0f;
         case LFO_RAMPDOWN:  return (0.5f - phase) * 2.0f;
-        case LFO_EXP_DOWN1: return powf(0.05f, phase) * 2.0f - 1.0f;
-        case LFO_EXP_DOWN2: return powf(0.001f, phase) * 2.0f - 1.0f;
+        case LFO_EXP_DOWN1: return fast_pow(0.05f, phase) * 2.0f - 1.0f;
+        case LFO_EXP_DOWN2: return fast_pow(0.001f, phase) * 2.0f - 1.0f;
         case LFO_RANDOM:
             if ((phase < 0.5) != first_half) {
                 first_half = phase < 0.5;
-                last_random = 2*RND-1;
+                last_random = 2*rnd_r(*rnd)-1;
             }
             return biquad(last_random);
             break;
         default:
-            return cosf(phase * 2.0f * PI); //LFO_SINE
+            return fast_cos(phase * 2.0f * PI); //LFO_SINE
     }
 }
 
@@ -278,7 +281,7 @@ float LFO::lfoout()
     if(phase >= 1) {
         phase    = fmod(phase, 1.0f);
         amp1 = amp2;
-        amp2 = (1 - lfornd) + lfornd * RND;
+        amp2 = (1 - lfornd) + lfornd * rnd_r(*rnd);
 
         computeNextFreqRnd();
     }
@@ -303,7 +306,7 @@ void LFO::computeNextFreqRnd()
     if(deterministic)
         return;
     incrnd     = nextincrnd;
-    nextincrnd = powf(0.5f, lfofreqrnd) + RND * (powf(2.0f, lfofreqrnd) - 1.0f);
+    nextincrnd = powf(0.5f, lfofreqrnd) + rnd_r(*rnd) * (powf(2.0f, lfofreqrnd) - 1.0f);
 }
 
 }
@@ -16,6 +16,7 @@
 
 #include "../globals.h"
 #include "../Misc/Time.h"
+#include "../Misc/Util.h"
 #include "WatchPoint.h"
 
 
@@ -30,9 +31,11 @@ class LFO
          *
          * @param lfopars pointer to a LFOParams object
          * @param basefreq base frequency of LFO
+         * @param rnd random generator state shared with the owning note
+         *            (if NULL the LFO uses a private, fixed seed state)
          */
         LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManager *m=0,
-                const char *watch_prefix=0);
+                const char *watch_prefix=0, prng_t *rnd=0);
         ~LFO();
 
         float lfoout();
@@ -90,6 +93,10 @@ class LFO
         //If After initialization there are no calls to random number gen.
         bool  deterministic;
 
+        //Random generator state (points to own_rnd if none was passed)
+        prng_t  own_rnd;
+        prng_t *rnd;
+
         const float     dt_;
         const LFOParams &lfopars_;
         const float basefreq_;
@@ -27,10 +27,11 @@ ModFilter::ModFilter(const FilterParams &pars_,
                      const SYNTH_T      &synth_,
                      const AbsTime      &time_,
                            Allocator    &alloc_,
-                           bool         stereo,
+                           bool         stereo_,
                            float        notefreq)
     :pars(pars_), synth(synth_), time(time_), alloc(alloc_),
     noteFreq(notefreq),
+    stereo(stereo_),
     left(nullptr),
     right(nullptr),
     env(nullptr),
@@ -40,10 +41,26 @@ ModFilter::ModFilter(const FilterParams &pars_,
     baseQ    = pars.getq();
     baseFreq = pars.getfreq();
 
+    generate();
+}
+
+//Analog and ramped state variable filters process stereo pairs in one
+//pass, so only the other filters need a second instance for the right channel
+static bool stereopass(Filter *f)
+{
+    if(dynamic_cast<AnalogFilter*>(f))
+        return true;
+    if(auto *sv = dynamic_cast<SVFilter*>(f))
+        return sv->isramped();
+    return false;
+}
+
+void ModFilter::generate(void)
+{
     left = Filter::generate(alloc, &pars,
             synth.samplerate, synth.buffersize);
 
-    if(stereo)
+    if(stereo && !stereopass(left))
         right = Filter::generate(alloc, &pars,
                 synth.samplerate, synth.buffersize);
 }
@@ -64,13 +81,34 @@ void ModFilter::addMod(Envelope &env_)
     env = &env_;
 }
 
+static int current_category(Filter *f)
+{
+    if(dynamic_cast<AnalogFilter*>(f))
+        return 0;
+    else if(dynamic_cast<FormantFilter*>(f))
+        return 1;
+    else if(dynamic_cast<SVFilter*>(f))
+        return 2;
+
+    assert(false);
+    return -1;
+}
+
 //Recompute Filter Parameters
 void ModFilter::update(float relfreq, float relq)
 {
     if(pars.last_update_timestamp == time.time()) {
-        paramUpdate(left);
-        if(right)
-            paramUpdate(right);
+        auto *sv = dynamic_cast<SVFilter*>(left);
+        if(current_category(left) != pars.Pcategory
+                || (sv && sv->isramped() != pars.Pramped)) {
+            alloc.dealloc(left);
+            alloc.dealloc(right);
+            generate();
+        } else {
+            paramUpdate(left);
+            if(right)
+                paramUpdate(right);
+        }
 
         baseFreq = pars.getfreq();
         baseQ    = pars.getq();
@@ -110,38 +148,21 @@ void ModFilter::updateSense(float velocity, uint8_t scale,
 
 void ModFilter::filter(float *l, float *r)
 {
+    if(stereo && !right && l && r) {
+        if(auto *sv = dynamic_cast<SVFilter*>(left))
+            sv->filterout(l, r);
+        else
+            static_cast<AnalogFilter*>(left)->filterout(l, r);
+        return;
+    }
     if(left && l)
         left->filterout(l);
     if(right && r)
         right->filterout(r);
 }
 
-static int current_category(Filter *f)
+void ModFilter::paramUpdate(Filter *f)
 {
-    if(dynamic_cast<AnalogFilter*>(f))
-        return 0;
-    else if(dynamic_cast<FormantFilter*>(f))
-        return 1;
-    else if(dynamic_cast<SVFilter*>(f))
-        return 2;
-
-    assert(false);
-    return -1;
-}
-
-void ModFilter::paramUpdate(Filter *&f)
-{
-    //Common parameters
-    baseQ    = pars.getq();
-    baseFreq = pars.getfreq();
-
-    if(current_category(f) != pars.Pcategory) {
-        alloc.dealloc(f);
-        f = Filter::generate(alloc, &pars,
-                synth.samplerate, synth.buffersize);
-        return;
-    }
-
     if(auto *sv = dynamic_cast<SVFilter*>(f))
         svParamUpdate(*sv);
     else if(auto *an = dynamic_cast<AnalogFilter*>(f))
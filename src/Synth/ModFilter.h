@@ -42,7 +42,8 @@ class ModFilter
         //filter stereo/mono signal(s) in-place
         void filter(float *l, float *r);
     private:
-        void paramUpdate(Filter *&f);
+        void generate(void);
+        void paramUpdate(Filter *f);
         void svParamUpdate(SVFilter &sv);
         void anParamUpdate(AnalogFilter &an);
 
@@ -60,7 +61,8 @@ class ModFilter
         smooth_float sense;    //shift due to note velocity
 
 
-        Filter       *left; //left  channel filter
+        bool          stereo;
+        Filter       *left; //left  channel filter (both for analog filters)
         Filter       *right;//right channel filter
         Envelope     *env;  //center freq envelope
         LFO          *lfo;  //center freq lfo
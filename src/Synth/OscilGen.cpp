@@ -22,6 +22,7 @@
 #include <cmath>
 #include <cstdio>
 #include <cstddef>
+#include <cstring>
 #include <complex>
 
 #include <unistd.h>
@@ -31,6 +32,26 @@
 
 namespace zyn {
 
+//Prepare the spectrum and its band limited tables on the non-realtime
+//thread and pass both to the realtime one (path ends with "prepare")
+static void sendPrepared(OscilGen &o, rtosc::RtData &d, const char *path)
+{
+    fft_t *data = new fft_t[o.synth.oscilsize / 2];
+    o.prepare(data);
+    // fprintf(stderr, "sending '%p' of fft data\n", data);
+    d.chain(path, "b", sizeof(fft_t*), &data);
+    o.pendingfreqs = data;
+
+    if(o.ADvsPAD) //PADsynth never uses the tables
+        return;
+    //the oscillator's FFTwrapper may be in use by the realtime thread
+    FFTwrapper   fft(o.synth.oscilsize);
+    OscilTables *tables = o.makeTables(data, fft);
+    char  repath[128];
+    strcpy(repath, path);
+    strcpy(strrchr(repath, '/')+1, "tables");
+    d.chain(repath, "b", sizeof(OscilTables*), &tables);
+}
 
 #define rObject OscilGen
 const rtosc::Ports OscilGen::non_realtime_ports = {
@@ -116,12 +137,7 @@ const rtosc::Ports OscilGen::non_realtime_ports = {
                 strcpy(repath, d.loc);
                 char *edit   = strrchr(repath, '/')+1;
                 strcpy(edit, "prepare");
-                OscilGen &o = *((OscilGen*)d.obj);
-                fft_t *data = new fft_t[o.synth.oscilsize / 2];
-                o.prepare(data);
-                // fprintf(stderr, "sending '%p' of fft data\n", data);
-                d.chain(repath, "b", sizeof(fft_t*), &data);
-                o.pendingfreqs = data;
+                sendPrepared(*(OscilGen*)d.obj, d, repath);
                 d.broadcast(d.loc, "i", phase);
             }
         }},
@@ -143,12 +159,7 @@ const rtosc::Ports OscilGen::non_realtime_ports = {
                 strcpy(repath, d.loc);
                 char *edit   = strrchr(repath, '/')+1;
                 strcpy(edit, "prepare");
-                OscilGen &o = *((OscilGen*)d.obj);
-                fft_t *data = new fft_t[o.synth.oscilsize / 2];
-                o.prepare(data);
-                // fprintf(stderr, "sending '%p' of fft data\n", data);
-                d.chain(repath, "b", sizeof(fft_t*), &data);
-                o.pendingfreqs = data;
+                sendPrepared(*(OscilGen*)d.obj, d, repath);
                 d.broadcast(d.loc, "i", mag);
             }
         }},
@@ -175,12 +186,7 @@ const rtosc::Ports OscilGen::non_realtime_ports = {
     {"prepare:", rProp(non-realtime) rDoc("Performs setup operation to oscillator"),
         NULL, [](const char *, rtosc::RtData &d) {
             //fprintf(stderr, "prepare: got a message from '%s'\n", m);
-            OscilGen &o = *(OscilGen*)d.obj;
-            fft_t *data = new fft_t[o.synth.oscilsize / 2];
-            o.prepare(data);
-            // fprintf(stderr, "sending '%p' of fft data\n", data);
-            d.chain(d.loc, "b", sizeof(fft_t*), &data);
-            o.pendingfreqs = data;
+            sendPrepared(*(OscilGen*)d.obj, d, d.loc);
         }},
     {"convert2sine:", rProp(non-realtime) rDoc("Translates waveform into FS"),
         NULL, [](const char *, rtosc::RtData &d) {
@@ -256,6 +262,13 @@ const rtosc::Ports OscilGen::realtime_ports{
             assert(o.oscilFFTfreqs !=*(fft_t**)rtosc_argument(m,0).b.data);
             o.oscilFFTfreqs = *(fft_t**)rtosc_argument(m,0).b.data;
         }},
+    {"tables:b", rProp(internal) rProp(realtime) rProp(pointer) rDoc("Sets band limited tables"),
+        NULL, [](const char *m, rtosc::RtData &d) {
+            OscilGen &o = *(OscilGen*)d.obj;
+            assert(rtosc_argument(m,0).b.len == sizeof(void*));
+            d.reply("/free", "sb", "OscilTables", sizeof(void*), &o.tables);
+            o.tables = *(OscilTables**)rtosc_argument(m,0).b.data;
+        }},
 
 };
 
@@ -338,6 +351,71 @@ void rmsNormalize(fft_t *freqs, int oscilsize)
         freqs[i] *= gain;
 }
 
+OscilTables::OscilTables(const SYNTH_T &synth, const fft_t *freqs_,
+                         FFTwrapper &fft)
+    :freqs(freqs_), size(synth.oscilsize)
+{
+    //harmonic limits: none, then OSCIL_TABLES_PER_OCTAVE steps per octave
+    //and finally all the harmonics get() may ever use
+    const int maxharmonics = synth.oscilsize / 2 - 2;
+    limit = new int[3 + (int)(OSCIL_TABLES_PER_OCTAVE * log2f(maxharmonics + 1))];
+    count = 0;
+    limit[count++] = 0;
+    for(int k = 0; ; ++k) {
+        const int l = (int)ceilf(powf(2.0f, k / (float)OSCIL_TABLES_PER_OCTAVE));
+        if(l >= maxharmonics)
+            break;
+        if(l != limit[count - 1])
+            limit[count++] = l;
+    }
+    limit[count++] = maxharmonics;
+
+    //same steps as OscilGen::get() for the deterministic case
+    fft_t *spectrum = new fft_t[synth.oscilsize / 2];
+    smps = new float[count * size];
+    for(int t = 0; t < count; ++t) {
+        float *table = smps + t * size;
+
+        //no harmonics added since the previous table: it is the same one
+        bool empty = true;
+        for(int i = t ? limit[t - 1] + 1 : 1; i <= limit[t]; ++i)
+            empty &= freqs[i] == fft_t(0.0f, 0.0f);
+        if(empty) {
+            if(t)
+                memcpy(table, table - size, size * sizeof(float));
+            else
+                memset(table, 0, size * sizeof(float));
+            continue;
+        }
+
+        clearAll(spectrum, synth.oscilsize);
+        for(int i = 1; i <= limit[t]; ++i)
+            spectrum[i] = freqs[i];
+        rmsNormalize(spectrum, synth.oscilsize);
+
+        fft.freqs2smps(spectrum, table);
+        for(int i = 0; i < size; ++i)
+            table[i] *= 0.25f;
+    }
+    delete[] spectrum;
+}
+
+OscilTables::~OscilTables()
+{
+    delete[] limit;
+    delete[] smps;
+}
+
+const float *OscilTables::get(int harmonics) const
+{
+    //largest table without harmonics above the requested ones, so nothing
+    //aliases (the top quarter octave below nyquist may be missing)
+    int t = 0;
+    while(t < count - 1 && limit[t + 1] <= harmonics)
+        ++t;
+    return smps + t * size;
+}
+
 #define DIFF(par) (old ## par != P ## par)
 
 OscilGen::OscilGen(const SYNTH_T &synth_, FFTwrapper *fft_, Resonance *res_)
@@ -360,6 +438,7 @@ OscilGen::OscilGen(const SYNTH_T &synth_, FFTwrapper *fft_, Resonance *res_)
 
     randseed = 1;
     ADvsPAD  = false;
+    tables   = NULL;
 
     defaults();
 }
@@ -371,6 +450,7 @@ OscilGen::~OscilGen()
     delete[] basefuncFFTfreqs;
     delete[] oscilFFTfreqs;
     delete[] cachedbasefunc;
+    delete tables;
 }
 
 
@@ -818,6 +898,22 @@ void OscilGen::shiftharmonics(fft_t *freqs)
 void OscilGen::prepare(void)
 {
     prepare(oscilFFTfreqs);
+    //the spectrum changed in place, so the tables are outdated
+    if(tables)
+        tables->freqs = NULL;
+}
+
+void OscilGen::buildTables(FFTwrapper &tablefft)
+{
+    if(needPrepare())
+        prepare();
+    delete tables;
+    tables = makeTables(oscilFFTfreqs, tablefft);
+}
+
+OscilTables *OscilGen::makeTables(const fft_t *freqs, FFTwrapper &tablefft)
+{
+    return new OscilTables(synth, freqs, tablefft);
 }
 
 void OscilGen::prepare(fft_t *freqs)
@@ -1049,23 +1145,32 @@ short int OscilGen::get(float *smps, float freqHz, int resonance)
 
     fft_t *input = freqHz > 0.0f ? oscilFFTfreqs : pendingfreqs;
 
-    unsigned int realrnd = prng();
-    sprng(randseed);
+    //private generator, the result only depends on randseed and the
+    //global generator is left untouched
+    prng_t rnd_state = randseed;
 
     int outpos =
-        (int)((RND * 2.0f
+        (int)((rnd_r(rnd_state) * 2.0f
                - 1.0f) * synth.oscilsize_f * (Prand - 64.0f) / 64.0f);
     outpos = (outpos + 2 * synth.oscilsize) % synth.oscilsize;
 
-
-    clearAll(outoscilFFTfreqs, synth.oscilsize);
-
     int nyquist = (int)(0.5f * synth.samplerate_f / fabsf(freqHz)) + 2;
     if(ADvsPAD)
         nyquist = (int)(synth.oscilsize / 2);
     if(nyquist > synth.oscilsize / 2)
         nyquist = synth.oscilsize / 2;
 
+    //Output independent of the note apart from the band limit: use a table
+    const bool deterministic = !ADvsPAD && freqHz > 0.1f && Prand <= 64
+        && !Padaptiveharmonics && !Pamprandtype
+        && !(resonance && res && res->Penabled);
+    if(deterministic && tables && tables->freqs == oscilFFTfreqs) {
+        memcpy(smps, tables->get(nyquist - 2), synth.oscilsize * sizeof(float));
+        return Prand < 64 ? outpos : 0;
+    }
+
+    clearAll(outoscilFFTfreqs, synth.oscilsize);
+
     //Process harmonics
     {
         int realnyquist = nyquist;
@@ -1092,7 +1197,7 @@ short int OscilGen::get(float *smps, float freqHz, int resonance)
         const float rnd = PI * powf((Prand - 64.0f) / 64.0f, 2.0f);
         for(int i = 1; i < nyquist - 1; ++i) //to Nyquist only for AntiAliasing
             outoscilFFTfreqs[i] *=
-                FFTpolar<fftw_real>(1.0f, (float)(rnd * i * RND));
+                FFTpolar<fftw_real>(1.0f, (float)(rnd * i * rnd_r(rnd_state)));
     }
 
     //Harmonic Amplitude Randomness
@@ -1105,12 +1210,12 @@ short int OscilGen::get(float *smps, float freqHz, int resonance)
                 power = power * 2.0f - 0.5f;
                 power = powf(15.0f, power);
                 for(int i = 1; i < nyquist - 1; ++i)
-                    outoscilFFTfreqs[i] *= powf(RND, power) * normalize;
+                    outoscilFFTfreqs[i] *= powf(rnd_r(rnd_state), power) * normalize;
                 break;
             case 2:
                 power = power * 2.0f - 0.5f;
                 power = powf(15.0f, power) * 2.0f;
-                float rndfreq = 2 * PI * RND;
+                float rndfreq = 2 * PI * rnd_r(rnd_state);
                 for(int i = 1; i < nyquist - 1; ++i)
                     outoscilFFTfreqs[i] *= powf(fabsf(sinf(i * rndfreq)), power)
                                            * normalize;
@@ -1132,8 +1237,6 @@ short int OscilGen::get(float *smps, float freqHz, int resonance)
             smps[i] *= 0.25f;                     //correct the amplitude
     }
 
-    sprng(realrnd + 1);
-
     if(Prand < 64)
         return outpos;
     else
@@ -20,6 +20,29 @@
 
 namespace zyn {
 
+/**Band limited renderings of an oscillator spectrum (a mipmap with
+ * OSCIL_TABLES_PER_OCTAVE tables per octave of harmonic count).
+ * They are computed off the realtime thread, so that OscilGen::get() only
+ * needs to copy a table when the output does not depend on the note
+ * (no phase/amplitude randomness, adaptive harmonics or resonance).*/
+#define OSCIL_TABLES_PER_OCTAVE 4
+struct OscilTables
+{
+    OscilTables(const SYNTH_T &synth, const fft_t *freqs,
+                FFTwrapper &fft) NONREALTIME;
+    ~OscilTables();
+
+    //Table with the most harmonics, but at most the given number (the
+    //harmonics below nyquist)
+    const float *get(int harmonics) const;
+
+    const fft_t *freqs; //spectrum the tables were made of (NULL if stale)
+    int    count;       //number of tables
+    int   *limit;       //number of harmonics in each table (increasing)
+    int    size;        //samples per table
+    float *smps;        //count * size samples
+};
+
 class OscilGen:public Presets
 {
     public:
@@ -117,6 +140,17 @@ class OscilGen:public Presets
         fft_t *oscilFFTfreqs;
 
         fft_t *pendingfreqs;
+
+        /**Band limited tables of oscilFFTfreqs used by get() (may be NULL)*/
+        OscilTables *tables;
+        /**Recompute the tables from the current spectrum; only for
+         * instances which are not in use by the realtime thread.
+         * The tables are transformed with tablefft, which must not be used
+         * by any other thread meanwhile*/
+        void buildTables(FFTwrapper &tablefft) NONREALTIME;
+        /**New band limited tables of the given prepared spectrum*/
+        OscilTables *makeTables(const fft_t *freqs,
+                                FFTwrapper &tablefft) NONREALTIME;
     private:
         //This array stores some temporary data and it has OSCIL_SIZE elements
         float *tmpsmps;
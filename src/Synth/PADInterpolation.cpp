@@ -0,0 +1,443 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADInterpolation.cpp - Sample interpolation of PADnote
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "PADInterpolation.h"
+
+#ifdef ZYN_SIMD_SSE2
+#include <immintrin.h>
+#endif
+#ifdef ZYN_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace zyn {
+
+//Output samples whose positions are computed in one go
+#define PAD_INTERPOLATION_BLOCK 64
+
+/*
+ * The positions depend on each other through the accumulated fraction, so
+ * the vector kernels first compute them for a block of samples (with the
+ * same operations as the scalar code), then gather the taps of several
+ * output samples at once and evaluate the interpolation polynomials side by
+ * side. The arithmetic of each output sample is done in the same order as
+ * in the scalar code.
+ */
+
+static inline void advance(int size, int &poshi_l, int &poshi_r,
+                           float &poslo, int freqhi, float freqlo)
+{
+    poshi_l += freqhi;
+    poshi_r += freqhi;
+    poslo   += freqlo;
+    if(poslo >= 1.0f) {
+        poshi_l += 1;
+        poshi_r += 1;
+        poslo   -= 1.0f;
+    }
+    if(poshi_l >= size)
+        poshi_l %= size;
+    if(poshi_r >= size)
+        poshi_r %= size;
+}
+
+static inline float linear(const float *smps, int pos, float frac)
+{
+    return smps[pos] * (1.0f - frac) + smps[pos + 1] * frac;
+}
+
+static inline float cubic(const float *smps, int pos, float frac)
+{
+    const float xm1 = smps[pos];
+    const float x0  = smps[pos + 1];
+    const float x1  = smps[pos + 2];
+    const float x2  = smps[pos + 3];
+    const float a   = (3.0f * (x0 - x1) - xm1 + x2) * 0.5f;
+    const float b   = 2.0f * x1 + xm1 - (5.0f * x0 + x2) * 0.5f;
+    const float c   = (x1 - xm1) * 0.5f;
+    return (((a * frac) + b) * frac + c) * frac + x0;
+}
+
+void padLinearScalar(const float *smps, int size, int &poshi_l, int &poshi_r,
+                     float &poslo, int freqhi, float freqlo,
+                     float *outl, float *outr, int buffersize)
+{
+    for(int i = 0; i < buffersize; ++i) {
+        advance(size, poshi_l, poshi_r, poslo, freqhi, freqlo);
+        outl[i] = linear(smps, poshi_l, poslo);
+        outr[i] = linear(smps, poshi_r, poslo);
+    }
+}
+
+void padCubicScalar(const float *smps, int size, int &poshi_l, int &poshi_r,
+                    float &poslo, int freqhi, float freqlo,
+                    float *outl, float *outr, int buffersize)
+{
+    for(int i = 0; i < buffersize; ++i) {
+        advance(size, poshi_l, poshi_r, poslo, freqhi, freqlo);
+        outl[i] = cubic(smps, poshi_l, poslo);
+        outr[i] = cubic(smps, poshi_r, poslo);
+    }
+}
+
+//Positions of the next n output samples
+struct Positions {
+    alignas(32) int   l[PAD_INTERPOLATION_BLOCK];
+    alignas(32) int   r[PAD_INTERPOLATION_BLOCK];
+    alignas(32) float frac[PAD_INTERPOLATION_BLOCK];
+
+    void compute(int size, int &poshi_l, int &poshi_r, float &poslo,
+                 int freqhi, float freqlo, int n)
+    {
+        for(int i = 0; i < n; ++i) {
+            advance(size, poshi_l, poshi_r, poslo, freqhi, freqlo);
+            l[i]    = poshi_l;
+            r[i]    = poshi_r;
+            frac[i] = poslo;
+        }
+    }
+};
+
+static inline int blockLength(int start, int buffersize)
+{
+    return buffersize - start < PAD_INTERPOLATION_BLOCK ?
+           buffersize - start : PAD_INTERPOLATION_BLOCK;
+}
+
+#ifdef ZYN_SIMD_SSE2
+//The taps of one output sample are adjacent, so they are loaded together
+//and transposed into one vector per tap
+static inline void tapsSSE2(const float *smps, const int *pos,
+                            __m128 &xm1, __m128 &x0, __m128 &x1, __m128 &x2)
+{
+    xm1 = _mm_loadu_ps(smps + pos[0]);
+    x0  = _mm_loadu_ps(smps + pos[1]);
+    x1  = _mm_loadu_ps(smps + pos[2]);
+    x2  = _mm_loadu_ps(smps + pos[3]);
+    _MM_TRANSPOSE4_PS(xm1, x0, x1, x2);
+}
+
+static inline void tapsSSE2(const float *smps, const int *pos,
+                            __m128 &x0, __m128 &x1)
+{
+    const __m128 z = _mm_setzero_ps();
+    const __m128 a = _mm_loadl_pi(z, (const __m64 *)(smps + pos[0]));
+    const __m128 b = _mm_loadl_pi(z, (const __m64 *)(smps + pos[1]));
+    const __m128 c = _mm_loadl_pi(z, (const __m64 *)(smps + pos[2]));
+    const __m128 d = _mm_loadl_pi(z, (const __m64 *)(smps + pos[3]));
+    const __m128 ab = _mm_unpacklo_ps(a, b); //a0 b0 a1 b1
+    const __m128 cd = _mm_unpacklo_ps(c, d); //c0 d0 c1 d1
+    x0 = _mm_movelh_ps(ab, cd);
+    x1 = _mm_movehl_ps(cd, ab);
+}
+
+static inline __m128 linearSSE2(const float *smps, const int *pos, __m128 p)
+{
+    __m128 x0, x1;
+    tapsSSE2(smps, pos, x0, x1);
+    const __m128 q = _mm_sub_ps(_mm_set1_ps(1.0f), p);
+    return _mm_add_ps(_mm_mul_ps(x0, q), _mm_mul_ps(x1, p));
+}
+
+static inline __m128 cubicSSE2(const float *smps, const int *pos, __m128 p)
+{
+    __m128 xm1, x0, x1, x2;
+    tapsSSE2(smps, pos, xm1, x0, x1, x2);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 a = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(
+                     _mm_mul_ps(_mm_set1_ps(3.0f), _mm_sub_ps(x0, x1)), xm1),
+                     x2), half);
+    const __m128 b = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.0f), x1),
+                     xm1), _mm_mul_ps(_mm_add_ps(_mm_mul_ps(
+                     _mm_set1_ps(5.0f), x0), x2), half));
+    const __m128 c = _mm_mul_ps(_mm_sub_ps(x1, xm1), half);
+    return _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(
+           _mm_mul_ps(a, p), b), p), c), p), x0);
+}
+
+static void padLinearSSE2(const float *smps, int size, int &poshi_l,
+                          int &poshi_r, float &poslo, int freqhi,
+                          float freqlo, float *outl, float *outr,
+                          int buffersize)
+{
+    Positions pos;
+    for(int start = 0; start < buffersize; start += PAD_INTERPOLATION_BLOCK) {
+        const int n = blockLength(start, buffersize);
+        pos.compute(size, poshi_l, poshi_r, poslo, freqhi, freqlo, n);
+        int i = 0;
+        for(; i + 4 <= n; i += 4) {
+            const __m128 p = _mm_load_ps(pos.frac + i);
+            _mm_storeu_ps(outl + start + i, linearSSE2(smps, pos.l + i, p));
+            _mm_storeu_ps(outr + start + i, linearSSE2(smps, pos.r + i, p));
+        }
+        for(; i < n; ++i) {
+            outl[start + i] = linear(smps, pos.l[i], pos.frac[i]);
+            outr[start + i] = linear(smps, pos.r[i], pos.frac[i]);
+        }
+    }
+}
+
+static void padCubicSSE2(const float *smps, int size, int &poshi_l,
+                         int &poshi_r, float &poslo, int freqhi,
+                         float freqlo, float *outl, float *outr,
+                         int buffersize)
+{
+    Positions pos;
+    for(int start = 0; start < buffersize; start += PAD_INTERPOLATION_BLOCK) {
+        const int n = blockLength(start, buffersize);
+        pos.compute(size, poshi_l, poshi_r, poslo, freqhi, freqlo, n);
+        int i = 0;
+        for(; i + 4 <= n; i += 4) {
+            const __m128 p = _mm_load_ps(pos.frac + i);
+            _mm_storeu_ps(outl + start + i, cubicSSE2(smps, pos.l + i, p));
+            _mm_storeu_ps(outr + start + i, cubicSSE2(smps, pos.r + i, p));
+        }
+        for(; i < n; ++i) {
+            outl[start + i] = cubic(smps, pos.l[i], pos.frac[i]);
+            outr[start + i] = cubic(smps, pos.r[i], pos.frac[i]);
+        }
+    }
+}
+#endif
+
+#ifdef ZYN_SIMD_AVX2
+//Same loads as tapsSSE2(), for two groups of four output samples
+ZYN_TARGET_AVX2
+static inline void tapsAVX2(const float *smps, const int *pos,
+                            __m256 &xm1, __m256 &x0, __m256 &x1, __m256 &x2)
+{
+    __m256 a = _mm256_castps128_ps256(_mm_loadu_ps(smps + pos[0]));
+    __m256 b = _mm256_castps128_ps256(_mm_loadu_ps(smps + pos[1]));
+    __m256 c = _mm256_castps128_ps256(_mm_loadu_ps(smps + pos[2]));
+    __m256 d = _mm256_castps128_ps256(_mm_loadu_ps(smps + pos[3]));
+    a = _mm256_insertf128_ps(a, _mm_loadu_ps(smps + pos[4]), 1);
+    b = _mm256_insertf128_ps(b, _mm_loadu_ps(smps + pos[5]), 1);
+    c = _mm256_insertf128_ps(c, _mm_loadu_ps(smps + pos[6]), 1);
+    d = _mm256_insertf128_ps(d, _mm_loadu_ps(smps + pos[7]), 1);
+    const __m256 ab_lo = _mm256_unpacklo_ps(a, b);
+    const __m256 ab_hi = _mm256_unpackhi_ps(a, b);
+    const __m256 cd_lo = _mm256_unpacklo_ps(c, d);
+    const __m256 cd_hi = _mm256_unpackhi_ps(c, d);
+    xm1 = _mm256_shuffle_ps(ab_lo, cd_lo, _MM_SHUFFLE(1, 0, 1, 0));
+    x0  = _mm256_shuffle_ps(ab_lo, cd_lo, _MM_SHUFFLE(3, 2, 3, 2));
+    x1  = _mm256_shuffle_ps(ab_hi, cd_hi, _MM_SHUFFLE(1, 0, 1, 0));
+    x2  = _mm256_shuffle_ps(ab_hi, cd_hi, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+ZYN_TARGET_AVX2
+static inline __m256 linearAVX2(const float *smps, const int *pos, __m256 p)
+{
+    const __m256 q = _mm256_sub_ps(_mm256_set1_ps(1.0f), p);
+    const __m256i idx = _mm256_load_si256((const __m256i *)pos);
+    return _mm256_add_ps(_mm256_mul_ps(_mm256_i32gather_ps(smps, idx, 4), q),
+                         _mm256_mul_ps(_mm256_i32gather_ps(smps + 1, idx, 4),
+                                       p));
+}
+
+ZYN_TARGET_AVX2
+static inline __m256 cubicAVX2(const float *smps, const int *pos, __m256 p)
+{
+    __m256 xm1, x0, x1, x2;
+    tapsAVX2(smps, pos, xm1, x0, x1, x2);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 a = _mm256_mul_ps(_mm256_add_ps(_mm256_sub_ps(
+                     _mm256_mul_ps(_mm256_set1_ps(3.0f), _mm256_sub_ps(x0, x1)),
+                     xm1), x2), half);
+    const __m256 b = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(
+                     _mm256_set1_ps(2.0f), x1), xm1), _mm256_mul_ps(
+                     _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(5.0f), x0), x2),
+                     half));
+    const __m256 c = _mm256_mul_ps(_mm256_sub_ps(x1, xm1), half);
+    return _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(
+           _mm256_add_ps(_mm256_mul_ps(a, p), b), p), c), p), x0);
+}
+
+ZYN_TARGET_AVX2
+static void padLinearAVX2(const float *smps, int size, int &poshi_l,
+                          int &poshi_r, float &poslo, int freqhi,
+                          float freqlo, float *outl, float *outr,
+                          int buffersize)
+{
+    Positions pos;
+    for(int start = 0; start < buffersize; start += PAD_INTERPOLATION_BLOCK) {
+        const int n = blockLength(start, buffersize);
+        pos.compute(size, poshi_l, poshi_r, poslo, freqhi, freqlo, n);
+        int i = 0;
+        for(; i + 8 <= n; i += 8) {
+            const __m256 p = _mm256_load_ps(pos.frac + i);
+            _mm256_storeu_ps(outl + start + i, linearAVX2(smps, pos.l + i, p));
+            _mm256_storeu_ps(outr + start + i, linearAVX2(smps, pos.r + i, p));
+        }
+        for(; i < n; ++i) {
+            outl[start + i] = linear(smps, pos.l[i], pos.frac[i]);
+            outr[start + i] = linear(smps, pos.r[i], pos.frac[i]);
+        }
+    }
+}
+
+ZYN_TARGET_AVX2
+static void padCubicAVX2(const float *smps, int size, int &poshi_l,
+                         int &poshi_r, float &poslo, int freqhi,
+                         float freqlo, float *outl, float *outr,
+                         int buffersize)
+{
+    Positions pos;
+    for(int start = 0; start < buffersize; start += PAD_INTERPOLATION_BLOCK) {
+        const int n = blockLength(start, buffersize);
+        pos.compute(size, poshi_l, poshi_r, poslo, freqhi, freqlo, n);
+        int i = 0;
+        for(; i + 8 <= n; i += 8) {
+            const __m256 p = _mm256_load_ps(pos.frac + i);
+            _mm256_storeu_ps(outl + start + i, cubicAVX2(smps, pos.l + i, p));
+            _mm256_storeu_ps(outr + start + i, cubicAVX2(smps, pos.r + i, p));
+        }
+        for(; i < n; ++i) {
+            outl[start + i] = cubic(smps, pos.l[i], pos.frac[i]);
+            outr[start + i] = cubic(smps, pos.r[i], pos.frac[i]);
+        }
+    }
+}
+#endif
+
+#ifdef ZYN_SIMD_NEON
+static inline float32x4_t gatherNEON(const float *smps, const int *pos, int k)
+{
+    float32x4_t v = vdupq_n_f32(0.0f);
+    v = vsetq_lane_f32(smps[pos[0] + k], v, 0);
+    v = vsetq_lane_f32(smps[pos[1] + k], v, 1);
+    v = vsetq_lane_f32(smps[pos[2] + k], v, 2);
+    v = vsetq_lane_f32(smps[pos[3] + k], v, 3);
+    return v;
+}
+
+//Multiplies and adds are separate intrinsics in the order of the scalar code,
+//but the compiler may still contract them (-ffast-math), so results agree
+//with the scalar kernel within rounding only
+static inline float32x4_t linearNEON(const float *smps, const int *pos,
+                                     float32x4_t p)
+{
+    const float32x4_t q = vsubq_f32(vdupq_n_f32(1.0f), p);
+    return vaddq_f32(vmulq_f32(gatherNEON(smps, pos, 0), q),
+                     vmulq_f32(gatherNEON(smps, pos, 1), p));
+}
+
+static inline float32x4_t cubicNEON(const float *smps, const int *pos,
+                                    float32x4_t p)
+{
+    const float32x4_t xm1  = gatherNEON(smps, pos, 0);
+    const float32x4_t x0   = gatherNEON(smps, pos, 1);
+    const float32x4_t x1   = gatherNEON(smps, pos, 2);
+    const float32x4_t x2   = gatherNEON(smps, pos, 3);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t a = vmulq_f32(vaddq_f32(vsubq_f32(
+                          vmulq_f32(vdupq_n_f32(3.0f), vsubq_f32(x0, x1)), xm1),
+                          x2), half);
+    const float32x4_t b = vsubq_f32(vaddq_f32(vmulq_f32(vdupq_n_f32(2.0f), x1),
+                          xm1), vmulq_f32(vaddq_f32(vmulq_f32(
+                          vdupq_n_f32(5.0f), x0), x2), half));
+    const float32x4_t c = vmulq_f32(vsubq_f32(x1, xm1), half);
+    return vaddq_f32(vmulq_f32(vaddq_f32(vmulq_f32(vaddq_f32(
+           vmulq_f32(a, p), b), p), c), p), x0);
+}
+
+static void padLinearNEON(const float *smps, int size, int &poshi_l,
+                          int &poshi_r, float &poslo, int freqhi,
+                          float freqlo, float *outl, float *outr,
+                          int buffersize)
+{
+    Positions pos;
+    for(int start = 0; start < buffersize; start += PAD_INTERPOLATION_BLOCK) {
+        const int n = blockLength(start, buffersize);
+        pos.compute(size, poshi_l, poshi_r, poslo, freqhi, freqlo, n);
+        int i = 0;
+        for(; i + 4 <= n; i += 4) {
+            const float32x4_t p = vld1q_f32(pos.frac + i);
+            vst1q_f32(outl + start + i, linearNEON(smps, pos.l + i, p));
+            vst1q_f32(outr + start + i, linearNEON(smps, pos.r + i, p));
+        }
+        for(; i < n; ++i) {
+            outl[start + i] = linear(smps, pos.l[i], pos.frac[i]);
+            outr[start + i] = linear(smps, pos.r[i], pos.frac[i]);
+        }
+    }
+}
+
+static void padCubicNEON(const float *smps, int size, int &poshi_l,
+                         int &poshi_r, float &poslo, int freqhi,
+                         float freqlo, float *outl, float *outr,
+                         int buffersize)
+{
+    Positions pos;
+    for(int start = 0; start < buffersize; start += PAD_INTERPOLATION_BLOCK) {
+        const int n = blockLength(start, buffersize);
+        pos.compute(size, poshi_l, poshi_r, poslo, freqhi, freqlo, n);
+        int i = 0;
+        for(; i + 4 <= n; i += 4) {
+            const float32x4_t p = vld1q_f32(pos.frac + i);
+            vst1q_f32(outl + start + i, cubicNEON(smps, pos.l + i, p));
+            vst1q_f32(outr + start + i, cubicNEON(smps, pos.r + i, p));
+        }
+        for(; i < n; ++i) {
+            outl[start + i] = cubic(smps, pos.l[i], pos.frac[i]);
+            outr[start + i] = cubic(smps, pos.r[i], pos.frac[i]);
+        }
+    }
+}
+#endif
+
+PADInterpolationKernel padLinearKernel(SimdLevel level)
+{
+    if(!simdSupported(level))
+        return padLinearScalar;
+    switch(level) {
+#ifdef ZYN_SIMD_SSE2
+        case SimdLevel::SSE2:
+            return padLinearSSE2;
+#endif
+#ifdef ZYN_SIMD_AVX2
+        case SimdLevel::AVX2:
+            return padLinearAVX2;
+#endif
+#ifdef ZYN_SIMD_NEON
+        case SimdLevel::NEON:
+            return padLinearNEON;
+#endif
+        default:
+            return padLinearScalar;
+    }
+}
+
+PADInterpolationKernel padCubicKernel(SimdLevel level)
+{
+    if(!simdSupported(level))
+        return padCubicScalar;
+    switch(level) {
+#ifdef ZYN_SIMD_SSE2
+        case SimdLevel::SSE2:
+            return padCubicSSE2;
+#endif
+#ifdef ZYN_SIMD_AVX2
+        case SimdLevel::AVX2:
+            return padCubicAVX2;
+#endif
+#ifdef ZYN_SIMD_NEON
+        case SimdLevel::NEON:
+            return padCubicNEON;
+#endif
+        default:
+            return padCubicScalar;
+    }
+}
+
+const PADInterpolationKernel padLinear = padLinearKernel(simdLevel());
+const PADInterpolationKernel padCubic  = padCubicKernel(simdLevel());
+
+}
@@ -0,0 +1,46 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADInterpolation.h - Sample interpolation of PADnote
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include "../DSP/SIMD.h"
+
+namespace zyn {
+
+/**
+ * Reads buffersize samples of both channels from smps, which holds size
+ * samples followed by the wrapped around ones needed by the interpolation.
+ * The channels start at poshi_l and poshi_r and share the fractional
+ * position poslo; every output sample advances them by freqhi + freqlo
+ * (the positions are updated).
+ */
+typedef void (*PADInterpolationKernel)(const float *smps, int size,
+                                       int &poshi_l, int &poshi_r,
+                                       float &poslo, int freqhi, float freqlo,
+                                       float *outl, float *outr,
+                                       int buffersize);
+
+/**Reference implementations, all others match them within float rounding*/
+void padLinearScalar(const float *smps, int size, int &poshi_l, int &poshi_r,
+                     float &poslo, int freqhi, float freqlo,
+                     float *outl, float *outr, int buffersize);
+void padCubicScalar(const float *smps, int size, int &poshi_l, int &poshi_r,
+                    float &poslo, int freqhi, float freqlo,
+                    float *outl, float *outr, int buffersize);
+
+/**Kernels for the given instruction set (scalar ones if unsupported)*/
+PADInterpolationKernel padLinearKernel(SimdLevel level);
+PADInterpolationKernel padCubicKernel(SimdLevel level);
+
+/**Fastest kernels for the running CPU*/
+extern const PADInterpolationKernel padLinear;
+extern const PADInterpolationKernel padCubic;
+
+}
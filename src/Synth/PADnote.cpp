@@ -14,6 +14,7 @@
 #include <cmath>
 #include "PADnote.h"
 #include "ModFilter.h"
+#include "PADInterpolation.h"
 #include "../Misc/Config.h"
 #include "../Misc/Allocator.h"
 #include "../Params/PADnoteParameters.h"
@@ -87,18 +88,7 @@ void PADnote::setup(float velocity_,
 
     //find out the closest note
     const float log2freq = note_log2_freq + NoteGlobalPar.Detune / 1200.0f;
-    float mindist = fabsf(log2freq - log2f(pars.sample[0].basefreq + 0.0001f));
-    nsample = 0;
-    for(int i = 1; i < PAD_MAX_SAMPLES; ++i) {
-        if(pars.sample[i].smp == NULL)
-            break;
-        const float dist = fabsf(log2freq - log2f(pars.sample[i].basefreq + 0.0001f));
-
-        if(dist < mindist) {
-            nsample = i;
-            mindist = dist;
-        }
-    }
+    nsample = pars.findsample(log2freq);
 
     int size = pars.sample[nsample].size;
     if(size == 0)
@@ -106,7 +96,7 @@ void PADnote::setup(float velocity_,
 
 
     if(!legato) { //not sure
-        poshi_l = (int)(RND * (size - 1));
+        poshi_l = (int)(getRandomFloat() * (size - 1));
         if(pars.PStereo)
             poshi_r = (poshi_l + size / 2) % size;
         else
@@ -118,7 +108,7 @@ void PADnote::setup(float velocity_,
     if(pars.PPanning)
         NoteGlobalPar.Panning = pars.PPanning / 128.0f;
     else if(!legato)
-        NoteGlobalPar.Panning = RND;
+        NoteGlobalPar.Panning = getRandomFloat();
 
     if(!legato) {
         NoteGlobalPar.Fadein_adjustment =
@@ -148,14 +138,14 @@ void PADnote::setup(float velocity_,
                     wm, (pre+"FreqEnvelope/").c_str);
         NoteGlobalPar.FreqLfo      =
             memory.alloc<LFO>(*pars.FreqLfo, basefreq, time,
-                    wm, (pre+"FreqLfo/").c_str);
+                    wm, (pre+"FreqLfo/").c_str, &current_prng_state);
 
         NoteGlobalPar.AmpEnvelope =
             memory.alloc<Envelope>(*pars.AmpEnvelope, basefreq, synth.dt(),
                     wm, (pre+"AmpEnvelope/").c_str);
         NoteGlobalPar.AmpLfo      =
             memory.alloc<LFO>(*pars.AmpLfo, basefreq, time,
-                    wm, (pre+"AmpLfo/").c_str);
+                    wm, (pre+"AmpLfo/").c_str, &current_prng_state);
     }
 
     NoteGlobalPar.Volume = 4.0f
@@ -182,7 +172,7 @@ void PADnote::setup(float velocity_,
         env = memory.alloc<Envelope>(*pars.FilterEnvelope, basefreq,
                 synth.dt(), wm, (pre+"FilterEnvelope/").c_str);
         lfo = memory.alloc<LFO>(*pars.FilterLfo, basefreq, time,
-                wm, (pre+"FilterLfo/").c_str);
+                wm, (pre+"FilterLfo/").c_str, &current_prng_state);
         flt->addMod(*env);
         flt->addMod(*lfo);
     }
@@ -204,7 +194,9 @@ SynthNote *PADnote::cloneLegato(void)
 {
     SynthParams sp{memory, ctl, synth, time, velocity,
                    (bool)portamento, legato.param.note_log2_freq, true, legato.param.seed};
-    return memory.alloc<PADnote>(&pars, sp, interpolation);
+    SynthNote *note = memory.alloc<PADnote>(&pars, sp, interpolation);
+    note->setStartOffset(start_offset);
+    return note;
 }
 
 void PADnote::legatonote(const LegatoParams &pars)
@@ -279,82 +271,24 @@ void PADnote::computecurrentparameters()
 }
 
 
-int PADnote::Compute_Linear(float *outl,
+int PADnote::Compute_Linear(const float *smps,
+                            float *outl,
                             float *outr,
                             int freqhi,
                             float freqlo)
 {
-    const float *smps = pars.sample[nsample].smp;
-    if(smps == NULL) {
-        finished_ = true;
-        return 1;
-    }
-    int size = pars.sample[nsample].size;
-    for(int i = 0; i < synth.buffersize; ++i) {
-        poshi_l += freqhi;
-        poshi_r += freqhi;
-        poslo   += freqlo;
-        if(poslo >= 1.0f) {
-            poshi_l += 1;
-            poshi_r += 1;
-            poslo   -= 1.0f;
-        }
-        if(poshi_l >= size)
-            poshi_l %= size;
-        if(poshi_r >= size)
-            poshi_r %= size;
-
-        outl[i] = smps[poshi_l] * (1.0f - poslo) + smps[poshi_l + 1] * poslo;
-        outr[i] = smps[poshi_r] * (1.0f - poslo) + smps[poshi_r + 1] * poslo;
-    }
+    padLinear(smps, pars.sample[nsample].size, poshi_l, poshi_r, poslo,
+              freqhi, freqlo, outl, outr, synth.buffersize);
     return 1;
 }
-int PADnote::Compute_Cubic(float *outl,
+int PADnote::Compute_Cubic(const float *smps,
+                           float *outl,
                            float *outr,
                            int freqhi,
                            float freqlo)
 {
-    float *smps = pars.sample[nsample].smp;
-    if(smps == NULL) {
-        finished_ = true;
-        return 1;
-    }
-    int   size = pars.sample[nsample].size;
-    float xm1, x0, x1, x2, a, b, c;
-    for(int i = 0; i < synth.buffersize; ++i) {
-        poshi_l += freqhi;
-        poshi_r += freqhi;
-        poslo   += freqlo;
-        if(poslo >= 1.0f) {
-            poshi_l += 1;
-            poshi_r += 1;
-            poslo   -= 1.0f;
-        }
-        if(poshi_l >= size)
-            poshi_l %= size;
-        if(poshi_r >= size)
-            poshi_r %= size;
-
-
-        //left
-        xm1     = smps[poshi_l];
-        x0      = smps[poshi_l + 1];
-        x1      = smps[poshi_l + 2];
-        x2      = smps[poshi_l + 3];
-        a       = (3.0f * (x0 - x1) - xm1 + x2) * 0.5f;
-        b       = 2.0f * x1 + xm1 - (5.0f * x0 + x2) * 0.5f;
-        c       = (x1 - xm1) * 0.5f;
-        outl[i] = (((a * poslo) + b) * poslo + c) * poslo + x0;
-        //right
-        xm1     = smps[poshi_r];
-        x0      = smps[poshi_r + 1];
-        x1      = smps[poshi_r + 2];
-        x2      = smps[poshi_r + 3];
-        a       = (3.0f * (x0 - x1) - xm1 + x2) * 0.5f;
-        b       = 2.0f * x1 + xm1 - (5.0f * x0 + x2) * 0.5f;
-        c       = (x1 - xm1) * 0.5f;
-        outr[i] = (((a * poslo) + b) * poslo + c) * poslo + x0;
-    }
+    padCubic(smps, pars.sample[nsample].size, poshi_l, poshi_r, poslo,
+             freqhi, freqlo, outl, outr, synth.buffersize);
     return 1;
 }
 
@@ -362,14 +296,25 @@ int PADnote::Compute_Cubic(float *outl,
 int PADnote::noteout(float *outl, float *outr)
 {
     computecurrentparameters();
-    float *smps = pars.sample[nsample].smp;
+    const float *smps = pars.sample[nsample].smp.load(std::memory_order_acquire);
     if(smps == NULL) {
-        for(int i = 0; i < synth.buffersize; ++i) {
-            outl[i] = 0.0f;
-            outr[i] = 0.0f;
+        //the sample was dropped from a lazy table, continue with the
+        //nearest one which is left
+        nsample = pars.findsample(note_log2_freq
+                                  + NoteGlobalPar.Detune / 1200.0f);
+        smps    = pars.sample[nsample].smp.load(std::memory_order_acquire);
+        if(smps == NULL) { //no samples at all
+            for(int i = 0; i < synth.buffersize; ++i) {
+                outl[i] = 0.0f;
+                outr[i] = 0.0f;
+            }
+            finished_ = true;
+            return 1;
         }
-        return 1;
+        poshi_l %= pars.sample[nsample].size;
+        poshi_r %= pars.sample[nsample].size;
     }
+    pars.usesample(nsample);
     float smpfreq = pars.sample[nsample].basefreq;
 
 
@@ -379,9 +324,9 @@ int PADnote::noteout(float *outl, float *outr)
 
 
     if(interpolation)
-        Compute_Cubic(outl, outr, freqhi, freqlo);
+        Compute_Cubic(smps, outl, outr, freqhi, freqlo);
     else
-        Compute_Linear(outl, outr, freqhi, freqlo);
+        Compute_Linear(smps, outl, outr, freqhi, freqlo);
 
     watch_int(outl,synth.buffersize);
 
@@ -56,11 +56,13 @@ class PADnote:public SynthNote
 
         int nsample, portamento;
 
-        int Compute_Linear(float *outl,
+        int Compute_Linear(const float *smps,
+                           float *outl,
                            float *outr,
                            int freqhi,
                            float freqlo);
-        int Compute_Cubic(float *outl,
+        int Compute_Cubic(const float *smps,
+                          float *outl,
                           float *outr,
                           int freqhi,
                           float freqlo);
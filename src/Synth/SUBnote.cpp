@@ -14,7 +14,6 @@
 #include <cmath>
 #include <cstdlib>
 #include <cstdio>
-#include <cassert>
 #include <iostream>
 #include "../globals.h"
 #include "SUBnote.h"
@@ -48,6 +47,8 @@ SUBnote::SUBnote(const SUBnoteParameters *parameters, const SynthParams &spars,
     GlobalFilterEnvelope(nullptr),
     NoteEnabled(true),
     lfilter(nullptr), rfilter(nullptr),
+    lbank(nullptr), rbank(nullptr),
+    coefupdates(0),
     filterupdate(false)
 {
     setup(spars.velocity, spars.portamento, spars.note_log2_freq, false, wm, prefix);
@@ -78,14 +79,23 @@ float SUBnote::setupFilters(float basefreq, int *pos, bool automation)
             float amp = 1.0f;
             if(nph == 0)
                 amp = gain;
-            initfilter(lfilter[nph + n * numstages], freq + OffsetHz, bw,
-                       amp, hgain, automation);
+            initfilter(lfilter[nph + n * numstages],
+                       SubFilterLane(lbank, numstages, n, nph),
+                       freq + OffsetHz, bw, amp, hgain, automation);
             if(stereo)
-                initfilter(rfilter[nph + n * numstages], freq + OffsetHz, bw,
-                           amp, hgain, automation);
+                initfilter(rfilter[nph + n * numstages],
+                           SubFilterLane(rbank, numstages, n, nph),
+                           freq + OffsetHz, bw, amp, hgain, automation);
         }
     }
 
+    if(!automation)
+        coefenvfreq = coefenvbw = 1.0f;
+
+    //unused lanes of the last group of filters
+    for(int n = numharmonics; n % SUB_FILTER_LANES; ++n)
+        overtone_rolloff[n] = 0.0f;
+
     if(reduceamp < 0.001f)
         reduceamp = 1.0f;
 
@@ -107,7 +117,7 @@ void SUBnote::setup(float velocity_,
     if(pars.PPanning != 0)
         panning = pars.PPanning / 127.0f;
     else if (!legato)
-        panning = RND;
+        panning = getRandomFloat();
 
     if(!legato) { //normal note
         numstages = pars.Pnumstages;
@@ -170,11 +180,8 @@ void SUBnote::setup(float velocity_,
     }
 
 
-    if(!legato) { //normal note
-        lfilter = memory.valloc<bpfilter>(numstages * numharmonics);
-        if(stereo)
-            rfilter = memory.valloc<bpfilter>(numstages * numharmonics);
-    }
+    if(!legato) //normal note
+        allocfilters();
 
     //how much the amplitude is normalised (because the harmonics)
     const float reduceamp = setupFilters(basefreq, pos, legato);
@@ -183,6 +190,7 @@ void SUBnote::setup(float velocity_,
 
     oldpitchwheel = 0;
     oldbandwidth  = 64;
+    coeftolerance = powf(2.0f, pars.PCoefTolerance / 12000.0f);
 
     const float freq = powf(2.0f, note_log2_freq_);
     if(!legato) { //normal note
@@ -208,7 +216,9 @@ SynthNote *SUBnote::cloneLegato(void)
 {
     SynthParams sp{memory, ctl, synth, time, velocity,
                    portamento, legato.param.note_log2_freq, true, legato.param.seed};
-    return memory.alloc<SUBnote>(&pars, sp);
+    SynthNote *note = memory.alloc<SUBnote>(&pars, sp);
+    note->setStartOffset(start_offset);
+    return note;
 }
 
 void SUBnote::legatonote(const LegatoParams &pars)
@@ -236,9 +246,7 @@ SUBnote::~SUBnote()
 void SUBnote::KillNote()
 {
     if(NoteEnabled) {
-        memory.devalloc(numstages * numharmonics, lfilter);
-        if(stereo)
-            memory.devalloc(numstages * numharmonics, rfilter);
+        freefilters();
         memory.dealloc(AmpEnvelope);
         memory.dealloc(FreqEnvelope);
         memory.dealloc(BandWidthEnvelope);
@@ -249,10 +257,75 @@ void SUBnote::KillNote()
 }
 
 
+void SUBnote::allocfilters(void)
+{
+    const int banksize = subFilterBankSize(numharmonics, numstages);
+    lfilter = memory.valloc<bpfilter>(numstages * numharmonics);
+    lbank   = memory.valloc<float>(banksize);
+    if(stereo) {
+        rfilter = memory.valloc<bpfilter>(numstages * numharmonics);
+        rbank   = memory.valloc<float>(banksize);
+    }
+}
+
+void SUBnote::freefilters(void)
+{
+    memory.devalloc(lfilter);
+    memory.devalloc(lbank);
+    memory.devalloc(rfilter);
+    memory.devalloc(rbank);
+}
+
+/*
+ * sin() over one period, for the filter coefficients.
+ * An angle is split into the nearest table point and a remainder below
+ * PI/SUB_SINCOS_SIZE, whose sin and cos are given by their Taylor series, so
+ * the results stay within float precision even for the low harmonics.
+ */
+#define SUB_SINCOS_SIZE 1024
+
+static struct SinCosTable {
+    float smps[SUB_SINCOS_SIZE];
+
+    SinCosTable() NONREALTIME {
+        for(int i = 0; i < SUB_SINCOS_SIZE; ++i)
+            smps[i] = sin(2.0 * M_PI * i / SUB_SINCOS_SIZE);
+    }
+} sincos_table;
+
+static inline void tableSinCos(float x, float &sn, float &cs)
+{
+    const float pos = x * (SUB_SINCOS_SIZE / (2.0f * PI));
+    const float k   = floorf(pos + 0.5f);
+    const float b   = (pos - k) * (2.0f * PI / SUB_SINCOS_SIZE);
+    const int   i   = (int)k & (SUB_SINCOS_SIZE - 1);
+    const float sa  = sincos_table.smps[i];
+    const float ca  = sincos_table.smps[(i + SUB_SINCOS_SIZE / 4)
+                                        & (SUB_SINCOS_SIZE - 1)];
+    const float b2  = b * b;
+    const float sb  = b * (1.0f - b2 / 6.0f);
+    const float cb  = 1.0f - b2 / 2.0f;
+    sn = sa * cb + ca * sb;
+    cs = ca * cb - sa * sb;
+}
+
+//sinh() without the cancellation of exp(x)-exp(-x) for small arguments
+static inline float fastSinh(float x)
+{
+    if(fabsf(x) < 0.5f) {
+        const float x2 = x * x;
+        return x * (1.0f + x2 / 6.0f * (1.0f + x2 / 20.0f
+                                        * (1.0f + x2 / 42.0f)));
+    }
+    const float e = expf(x);
+    return 0.5f * (e - 1.0f / e);
+}
+
 /*
  * Compute the filters coefficients
  */
-void SUBnote::computefiltercoefs(bpfilter &filter,
+void SUBnote::computefiltercoefs(const bpfilter &filter,
+                                 SubFilterLane lane,
                                  float freq,
                                  float bw,
                                  float gain)
@@ -262,19 +335,19 @@ void SUBnote::computefiltercoefs(bpfilter &filter,
 
 
     float omega = 2.0f * PI * freq / synth.samplerate_f;
-    float sn    = sinf(omega);
-    float cs    = cosf(omega);
-    float alpha = sn * sinh(LOG_2 / 2.0f * bw * omega / sn);
+    float sn, cs;
+    tableSinCos(omega, sn, cs);
+    float alpha = sn * fastSinh(LOG_2 / 2.0f * bw * omega / sn);
 
     if(alpha > 1)
         alpha = 1;
     if(alpha > bw)
         alpha = bw;
 
-    filter.b0 = alpha / (1.0f + alpha) * filter.amp * gain;
-    filter.b2 = -alpha / (1.0f + alpha) * filter.amp * gain;
-    filter.a1 = -2.0f * cs / (1.0f + alpha);
-    filter.a2 = (1.0f - alpha) / (1.0f + alpha);
+    lane[SUB_B0]  = alpha / (1.0f + alpha) * filter.amp * gain;
+    lane[SUB_B2]  = -alpha / (1.0f + alpha) * filter.amp * gain;
+    lane[SUB_NA1] = 2.0f * cs / (1.0f + alpha);
+    lane[SUB_NA2] = -(1.0f - alpha) / (1.0f + alpha);
 }
 
 
@@ -282,6 +355,7 @@ void SUBnote::computefiltercoefs(bpfilter &filter,
  * Initialise the filters
  */
 void SUBnote::initfilter(bpfilter &filter,
+                         SubFilterLane lane,
                          float freq,
                          float bw,
                          float amp,
@@ -289,26 +363,26 @@ void SUBnote::initfilter(bpfilter &filter,
                          bool automation)
 {
     if(!automation) {
-        filter.xn1 = 0.0f;
-        filter.xn2 = 0.0f;
+        lane[SUB_XN1] = 0.0f;
+        lane[SUB_XN2] = 0.0f;
 
         if(start == 0) {
-            filter.yn1 = 0.0f;
-            filter.yn2 = 0.0f;
+            lane[SUB_YN1] = 0.0f;
+            lane[SUB_YN2] = 0.0f;
         }
         else {
             float a = 0.1f * mag; //empirically
-            float p = RND * 2.0f * PI;
+            float p = getRandomFloat() * 2.0f * PI;
             if(start == 1)
-                a *= RND;
-            filter.yn1 = a * cosf(p);
-            filter.yn2 = a * cosf(p + freq * 2.0f * PI / synth.samplerate_f);
+                a *= getRandomFloat();
+            lane[SUB_YN1] = a * cosf(p);
+            lane[SUB_YN2] = a * cosf(p + freq * 2.0f * PI / synth.samplerate_f);
 
             //correct the error of computation the start amplitude
             //at very high frequencies
             if(freq > synth.samplerate_f * 0.96f) {
-                filter.yn1 = 0.0f;
-                filter.yn2 = 0.0f;
+                lane[SUB_YN1] = 0.0f;
+                lane[SUB_YN2] = 0.0f;
             }
         }
     }
@@ -318,53 +392,11 @@ void SUBnote::initfilter(bpfilter &filter,
     filter.bw   = bw;
 
     if (!automation)
-        computefiltercoefs(filter, freq, bw, 1.0f);
+        computefiltercoefs(filter, lane, freq, bw, 1.0f);
     else
         filterupdate = true;
 }
 
-/*
- * Do the filtering
- */
-
-inline void SubFilterA(const float coeff[4], float &src, float work[4])
-{
-    work[3] = src*coeff[0]+work[1]*coeff[1]+work[2]*coeff[2]+work[3]*coeff[3];
-    work[1] = src;
-    src     = work[3];
-}
-
-inline void SubFilterB(const float coeff[4], float &src, float work[4])
-{
-    work[2] = src*coeff[0]+work[0]*coeff[1]+work[3]*coeff[2]+work[2]*coeff[3];
-    work[0] = src;
-    src     = work[2];
-}
-
-//This dance is designed to minimize unneeded memory operations which can result
-//in quite a bit of wasted time
-void SUBnote::filter(bpfilter &filter, float *smps)
-{
-    assert(synth.buffersize % 8 == 0);
-    float coeff[4] = {filter.b0, filter.b2,  -filter.a1, -filter.a2};
-    float work[4]  = {filter.xn1, filter.xn2, filter.yn1, filter.yn2};
-
-    for(int i = 0; i < synth.buffersize; i += 8) {
-        SubFilterA(coeff, smps[i + 0], work);
-        SubFilterB(coeff, smps[i + 1], work);
-        SubFilterA(coeff, smps[i + 2], work);
-        SubFilterB(coeff, smps[i + 3], work);
-        SubFilterA(coeff, smps[i + 4], work);
-        SubFilterB(coeff, smps[i + 5], work);
-        SubFilterA(coeff, smps[i + 6], work);
-        SubFilterB(coeff, smps[i + 7], work);
-    }
-    filter.xn1 = work[0];
-    filter.xn2 = work[1];
-    filter.yn1 = work[2];
-    filter.yn2 = work[3];
-}
-
 /*
  * Init Parameters
  */
@@ -434,13 +466,9 @@ void SUBnote::computecurrentparameters()
 
         bool delta_harmonics = (harmonics != numharmonics);
         if(delta_harmonics) {
-            memory.devalloc(lfilter);
-            memory.devalloc(rfilter);
-
+            freefilters();
             firstnumharmonics = numharmonics = harmonics;
-            lfilter = memory.valloc<bpfilter>(numstages * numharmonics);
-            if(stereo)
-                rfilter = memory.valloc<bpfilter>(numstages * numharmonics);
+            allocfilters();
         }
 
         const float basefreq = powf(2.0f, note_log2_freq);
@@ -479,18 +507,23 @@ void SUBnote::computecurrentparameters()
 
         envbw *= ctl.bandwidth.relbw; //bandwidth controller
 
+        if(coefsOutdated(envfreq, envbw)) {
+            //Recompute High Frequency Dampening Terms
+            for(int n = 0; n < numharmonics; ++n)
+                overtone_rolloff[n] =
+                    computerolloff(overtone_freq[n] * envfreq);
 
-        //Recompute High Frequency Dampening Terms
-        for(int n = 0; n < numharmonics; ++n)
-            overtone_rolloff[n] = computerolloff(overtone_freq[n] * envfreq);
 
+            //Recompute Filter Coefficients
+            float tmpgain = 1.0f / sqrt(envbw * envfreq);
+            computeallfiltercoefs(lfilter, lbank, envfreq, envbw, tmpgain);
+            if(stereo)
+                computeallfiltercoefs(rfilter, rbank, envfreq, envbw, tmpgain);
 
-        //Recompute Filter Coefficients
-        float tmpgain = 1.0f / sqrt(envbw * envfreq);
-        computeallfiltercoefs(lfilter, envfreq, envbw, tmpgain);
-        if(stereo)
-            computeallfiltercoefs(rfilter, envfreq, envbw, tmpgain);
-
+            coefenvfreq = envfreq;
+            coefenvbw   = envbw;
+            ++coefupdates;
+        }
 
         oldbandwidth  = ctl.bandwidth.data;
         oldpitchwheel = ctl.pitchwheel.data;
@@ -505,38 +538,44 @@ void SUBnote::computecurrentparameters()
     }
 }
 
-void SUBnote::computeallfiltercoefs(bpfilter *filters, float envfreq,
-        float envbw, float gain)
+/*
+ * Whether the frequency or the bandwidth moved past the tolerance since the
+ * coefficients were computed
+ */
+bool SUBnote::coefsOutdated(float envfreq, float envbw) const
+{
+    return filterupdate
+           || envfreq > coefenvfreq * coeftolerance
+           || envfreq * coeftolerance < coefenvfreq
+           || envbw > coefenvbw * coeftolerance
+           || envbw * coeftolerance < coefenvbw;
+}
+
+void SUBnote::computeallfiltercoefs(const bpfilter *filters, float *bank,
+        float envfreq, float envbw, float gain)
 {
     for(int n = 0; n < numharmonics; ++n)
         for(int nph = 0; nph < numstages; ++nph)
             computefiltercoefs(filters[nph + n * numstages],
+                    SubFilterLane(bank, numstages, n, nph),
                     filters[nph + n * numstages].freq * envfreq,
                     filters[nph + n * numstages].bw * envbw,
                     nph == 0 ? gain : 1.0);
 }
 
-void SUBnote::chanOutput(float *out, bpfilter *bp, int buffer_size)
+void SUBnote::chanOutput(float *out, float *bank, int buffer_size)
 {
     float tmprnd[buffer_size];
-    float tmpsmp[buffer_size];
 
     //Initialize Random Input
+    rnd_fill(current_prng_state, tmprnd, buffer_size);
     for(int i = 0; i < buffer_size; ++i)
-        tmprnd[i] = RND * 2.0f - 1.0f;
+        tmprnd[i] = tmprnd[i] * 2.0f - 1.0f;
 
     //For each harmonic apply the filter on the random input stream
     //Sum the filter outputs to obtain the output signal
-    for(int n = 0; n < numharmonics; ++n) {
-        float rolloff = overtone_rolloff[n];
-        memcpy(tmpsmp, tmprnd, synth.bufferbytes);
-
-        for(int nph = 0; nph < numstages; ++nph)
-            filter(bp[nph + n * numstages], tmpsmp);
-
-        for(int i = 0; i < synth.buffersize; ++i)
-            out[i] += tmpsmp[i] * rolloff;
-    }
+    subFilterBank(bank, numharmonics, numstages, overtone_rolloff, tmprnd, out,
+                  buffer_size);
 }
 
 /*
@@ -551,14 +590,14 @@ int SUBnote::noteout(float *outl, float *outr)
         return 0;
 
     if(stereo) {
-        chanOutput(outl, lfilter, synth.buffersize);
-        chanOutput(outr, rfilter, synth.buffersize);
+        chanOutput(outl, lbank, synth.buffersize);
+        chanOutput(outr, rbank, synth.buffersize);
 
         if(GlobalFilter)
             GlobalFilter->filter(outl, outr);
 
     } else {
-        chanOutput(outl, lfilter, synth.buffersize);
+        chanOutput(outl, lbank, synth.buffersize);
 
         if(GlobalFilter)
             GlobalFilter->filter(outl, 0);
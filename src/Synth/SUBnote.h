@@ -17,6 +17,7 @@
 #include "SynthNote.h"
 #include "../globals.h"
 #include "WatchPoint.h"
+#include "SubFilterBank.h"
 
 namespace zyn {
 
@@ -33,6 +34,8 @@ class SUBnote:public SynthNote
         int noteout(float *outl, float *outr); //note output,return 0 if the note is finished
         void releasekey();
         bool finished() const;
+        //number of times the filter coefficients were recomputed
+        int coefficientUpdates(void) const { return coefupdates; }
         void entomb(void);
     private:
 
@@ -76,32 +79,41 @@ class SUBnote:public SynthNote
 
         struct bpfilter {
             float freq, bw, amp; //filter parameters
-            float a1, a2, b0, b2; //filter coefs. b1=0
-            float xn1, xn2, yn1, yn2; //filter internal values
         };
 
-        void chanOutput(float *out, bpfilter *bp, int buffer_size);
+        void chanOutput(float *out, float *bank, int buffer_size);
 
         void initfilter(bpfilter &filter,
+                        SubFilterLane lane,
                         float freq,
                         float bw,
                         float amp,
                         float mag,
                         bool automation);
         float computerolloff(float freq);
-        void computeallfiltercoefs(bpfilter *filters, float envfreq, float envbw, float gain);
-        void computefiltercoefs(bpfilter &filter,
+        void computeallfiltercoefs(const bpfilter *filters, float *bank,
+                                   float envfreq, float envbw, float gain);
+        void computefiltercoefs(const bpfilter &filter,
+                                SubFilterLane lane,
                                 float freq,
                                 float bw,
                                 float gain);
-        inline void filter(bpfilter &filter, float *smps);
+        bool coefsOutdated(float envfreq, float envbw) const;
+        void allocfilters(void);
+        void freefilters(void);
 
         bpfilter *lfilter, *rfilter;
+        //coefficients and state of the filters (see SubFilterBank.h)
+        float    *lbank, *rbank;
 
         float overtone_rolloff[MAX_SUB_HARMONICS];
         float overtone_freq[MAX_SUB_HARMONICS];
 
         int   oldpitchwheel, oldbandwidth;
+        //envelope values the coefficients were computed for, and the ratio
+        //by which they may change before the coefficients are recomputed
+        float coefenvfreq, coefenvbw, coeftolerance;
+        int   coefupdates;
         float velocity;
         bool filterupdate;
 };
@@ -0,0 +1,336 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  SubFilterBank.cpp - Band pass filter banks of SUBnote
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cstring>
+#include "SubFilterBank.h"
+
+#ifdef ZYN_SIMD_SSE2
+#include <immintrin.h>
+#endif
+#ifdef ZYN_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace zyn {
+
+//Samples processed per pass over the bank, the working buffers of a pass
+//stay in the L1 cache
+#define SUB_FILTER_BLOCK 32
+
+typedef float LaneBuffer[SUB_FILTER_BLOCK][SUB_FILTER_LANES];
+
+/*
+ * Every kernel processes the buffer in blocks: for each group of harmonics
+ * the input is copied into all lanes, run through the stages one after the
+ * other and accumulated per lane. The lanes are summed up at the end of the
+ * block in a fixed order.
+ * Each filter computes y = ((x*b0 + x2*b2) + y1*na1) + y2*na2, in the same
+ * order as the former per harmonic code.
+ */
+
+//Sum of the lanes, in the same order for every kernel
+static inline void sumLanes(const LaneBuffer acc, float *out, int n)
+{
+    for(int i = 0; i < n; ++i) {
+        const float *a = acc[i];
+        out[i] += ((a[0] + a[1]) + (a[2] + a[3]))
+                  + ((a[4] + a[5]) + (a[6] + a[7]));
+    }
+}
+
+void subFilterBankScalar(float *bank, int numharmonics, int numstages,
+                         const float *gain, const float *in, float *out,
+                         int buffersize)
+{
+    const int groups = (numharmonics + SUB_FILTER_LANES - 1) / SUB_FILTER_LANES;
+    LaneBuffer tmp, acc;
+
+    for(int start = 0; start < buffersize; start += SUB_FILTER_BLOCK) {
+        const int n = buffersize - start < SUB_FILTER_BLOCK ?
+                      buffersize - start : SUB_FILTER_BLOCK;
+        memset(acc, 0, sizeof(acc));
+
+        for(int g = 0; g < groups; ++g) {
+            for(int i = 0; i < n; ++i)
+                for(int l = 0; l < SUB_FILTER_LANES; ++l)
+                    tmp[i][l] = in[start + i];
+
+            for(int s = 0; s < numstages; ++s) {
+                float *f = bank + (g * numstages + s) * SUB_FILTER_FIELDS
+                                  * SUB_FILTER_LANES;
+                for(int l = 0; l < SUB_FILTER_LANES; ++l) {
+                    const float b0  = f[SUB_B0  * SUB_FILTER_LANES + l];
+                    const float b2  = f[SUB_B2  * SUB_FILTER_LANES + l];
+                    const float na1 = f[SUB_NA1 * SUB_FILTER_LANES + l];
+                    const float na2 = f[SUB_NA2 * SUB_FILTER_LANES + l];
+                    float x1 = f[SUB_XN1 * SUB_FILTER_LANES + l];
+                    float x2 = f[SUB_XN2 * SUB_FILTER_LANES + l];
+                    float y1 = f[SUB_YN1 * SUB_FILTER_LANES + l];
+                    float y2 = f[SUB_YN2 * SUB_FILTER_LANES + l];
+                    for(int i = 0; i < n; ++i) {
+                        const float x = tmp[i][l];
+                        const float y = ((x * b0 + x2 * b2) + y1 * na1)
+                                        + y2 * na2;
+                        x2 = x1;
+                        x1 = x;
+                        y2 = y1;
+                        y1 = y;
+                        tmp[i][l] = y;
+                    }
+                    f[SUB_XN1 * SUB_FILTER_LANES + l] = x1;
+                    f[SUB_XN2 * SUB_FILTER_LANES + l] = x2;
+                    f[SUB_YN1 * SUB_FILTER_LANES + l] = y1;
+                    f[SUB_YN2 * SUB_FILTER_LANES + l] = y2;
+                }
+            }
+
+            const float *w = gain + g * SUB_FILTER_LANES;
+            for(int i = 0; i < n; ++i)
+                for(int l = 0; l < SUB_FILTER_LANES; ++l)
+                    acc[i][l] += tmp[i][l] * w[l];
+        }
+
+        sumLanes(acc, out + start, n);
+    }
+}
+
+#ifdef ZYN_SIMD_SSE2
+//Each group is handled as two independent halves of four lanes
+static void subFilterBankSSE2(float *bank, int numharmonics, int numstages,
+                              const float *gain, const float *in, float *out,
+                              int buffersize)
+{
+    const int groups = (numharmonics + SUB_FILTER_LANES - 1) / SUB_FILTER_LANES;
+    alignas(16) LaneBuffer tmp, acc;
+
+    for(int start = 0; start < buffersize; start += SUB_FILTER_BLOCK) {
+        const int n = buffersize - start < SUB_FILTER_BLOCK ?
+                      buffersize - start : SUB_FILTER_BLOCK;
+        for(int i = 0; i < n; ++i) {
+            _mm_store_ps(acc[i],     _mm_setzero_ps());
+            _mm_store_ps(acc[i] + 4, _mm_setzero_ps());
+        }
+
+        for(int g = 0; g < groups; ++g) {
+            for(int i = 0; i < n; ++i) {
+                const __m128 x = _mm_set1_ps(in[start + i]);
+                _mm_store_ps(tmp[i],     x);
+                _mm_store_ps(tmp[i] + 4, x);
+            }
+
+            for(int s = 0; s < numstages; ++s) {
+                float *f = bank + (g * numstages + s) * SUB_FILTER_FIELDS
+                                  * SUB_FILTER_LANES;
+#define LOAD(field, h) _mm_loadu_ps(f + field * SUB_FILTER_LANES + 4 * h)
+#define STORE(field, h, v) _mm_storeu_ps(f + field * SUB_FILTER_LANES + 4 * h, v)
+                const __m128 b0a = LOAD(SUB_B0, 0),  b0b = LOAD(SUB_B0, 1);
+                const __m128 b2a = LOAD(SUB_B2, 0),  b2b = LOAD(SUB_B2, 1);
+                const __m128 n1a = LOAD(SUB_NA1, 0), n1b = LOAD(SUB_NA1, 1);
+                const __m128 n2a = LOAD(SUB_NA2, 0), n2b = LOAD(SUB_NA2, 1);
+                __m128 x1a = LOAD(SUB_XN1, 0), x1b = LOAD(SUB_XN1, 1);
+                __m128 x2a = LOAD(SUB_XN2, 0), x2b = LOAD(SUB_XN2, 1);
+                __m128 y1a = LOAD(SUB_YN1, 0), y1b = LOAD(SUB_YN1, 1);
+                __m128 y2a = LOAD(SUB_YN2, 0), y2b = LOAD(SUB_YN2, 1);
+                for(int i = 0; i < n; ++i) {
+                    const __m128 xa = _mm_load_ps(tmp[i]);
+                    const __m128 xb = _mm_load_ps(tmp[i] + 4);
+                    const __m128 ya = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                                    _mm_mul_ps(xa, b0a), _mm_mul_ps(x2a, b2a)),
+                                    _mm_mul_ps(y1a, n1a)), _mm_mul_ps(y2a, n2a));
+                    const __m128 yb = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                                    _mm_mul_ps(xb, b0b), _mm_mul_ps(x2b, b2b)),
+                                    _mm_mul_ps(y1b, n1b)), _mm_mul_ps(y2b, n2b));
+                    x2a = x1a; x1a = xa; y2a = y1a; y1a = ya;
+                    x2b = x1b; x1b = xb; y2b = y1b; y1b = yb;
+                    _mm_store_ps(tmp[i],     ya);
+                    _mm_store_ps(tmp[i] + 4, yb);
+                }
+                STORE(SUB_XN1, 0, x1a); STORE(SUB_XN1, 1, x1b);
+                STORE(SUB_XN2, 0, x2a); STORE(SUB_XN2, 1, x2b);
+                STORE(SUB_YN1, 0, y1a); STORE(SUB_YN1, 1, y1b);
+                STORE(SUB_YN2, 0, y2a); STORE(SUB_YN2, 1, y2b);
+#undef LOAD
+#undef STORE
+            }
+
+            const __m128 wa = _mm_loadu_ps(gain + g * SUB_FILTER_LANES);
+            const __m128 wb = _mm_loadu_ps(gain + g * SUB_FILTER_LANES + 4);
+            for(int i = 0; i < n; ++i) {
+                _mm_store_ps(acc[i], _mm_add_ps(_mm_load_ps(acc[i]),
+                             _mm_mul_ps(_mm_load_ps(tmp[i]), wa)));
+                _mm_store_ps(acc[i] + 4, _mm_add_ps(_mm_load_ps(acc[i] + 4),
+                             _mm_mul_ps(_mm_load_ps(tmp[i] + 4), wb)));
+            }
+        }
+
+        sumLanes(acc, out + start, n);
+    }
+}
+#endif
+
+#ifdef ZYN_SIMD_AVX2
+ZYN_TARGET_AVX2
+static void subFilterBankAVX2(float *bank, int numharmonics, int numstages,
+                              const float *gain, const float *in, float *out,
+                              int buffersize)
+{
+    const int groups = (numharmonics + SUB_FILTER_LANES - 1) / SUB_FILTER_LANES;
+    alignas(32) LaneBuffer tmp, acc;
+
+    for(int start = 0; start < buffersize; start += SUB_FILTER_BLOCK) {
+        const int n = buffersize - start < SUB_FILTER_BLOCK ?
+                      buffersize - start : SUB_FILTER_BLOCK;
+        for(int i = 0; i < n; ++i)
+            _mm256_store_ps(acc[i], _mm256_setzero_ps());
+
+        for(int g = 0; g < groups; ++g) {
+            for(int i = 0; i < n; ++i)
+                _mm256_store_ps(tmp[i], _mm256_set1_ps(in[start + i]));
+
+            for(int s = 0; s < numstages; ++s) {
+                float *f = bank + (g * numstages + s) * SUB_FILTER_FIELDS
+                                  * SUB_FILTER_LANES;
+#define FIELD(field) (f + field * SUB_FILTER_LANES)
+                const __m256 b0  = _mm256_loadu_ps(FIELD(SUB_B0));
+                const __m256 b2  = _mm256_loadu_ps(FIELD(SUB_B2));
+                const __m256 na1 = _mm256_loadu_ps(FIELD(SUB_NA1));
+                const __m256 na2 = _mm256_loadu_ps(FIELD(SUB_NA2));
+                __m256 x1 = _mm256_loadu_ps(FIELD(SUB_XN1));
+                __m256 x2 = _mm256_loadu_ps(FIELD(SUB_XN2));
+                __m256 y1 = _mm256_loadu_ps(FIELD(SUB_YN1));
+                __m256 y2 = _mm256_loadu_ps(FIELD(SUB_YN2));
+                for(int i = 0; i < n; ++i) {
+                    const __m256 x = _mm256_load_ps(tmp[i]);
+                    const __m256 y = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+                                    _mm256_mul_ps(x, b0), _mm256_mul_ps(x2, b2)),
+                                    _mm256_mul_ps(y1, na1)), _mm256_mul_ps(y2, na2));
+                    x2 = x1; x1 = x; y2 = y1; y1 = y;
+                    _mm256_store_ps(tmp[i], y);
+                }
+                _mm256_storeu_ps(FIELD(SUB_XN1), x1);
+                _mm256_storeu_ps(FIELD(SUB_XN2), x2);
+                _mm256_storeu_ps(FIELD(SUB_YN1), y1);
+                _mm256_storeu_ps(FIELD(SUB_YN2), y2);
+#undef FIELD
+            }
+
+            const __m256 w = _mm256_loadu_ps(gain + g * SUB_FILTER_LANES);
+            for(int i = 0; i < n; ++i)
+                _mm256_store_ps(acc[i], _mm256_add_ps(_mm256_load_ps(acc[i]),
+                                _mm256_mul_ps(_mm256_load_ps(tmp[i]), w)));
+        }
+
+        sumLanes(acc, out + start, n);
+    }
+}
+#endif
+
+#ifdef ZYN_SIMD_NEON
+//Multiplies and adds are separate intrinsics in the order of the scalar code,
+//but the compiler may still contract them (-ffast-math), so results agree
+//with the scalar kernel within rounding only
+static void subFilterBankNEON(float *bank, int numharmonics, int numstages,
+                              const float *gain, const float *in, float *out,
+                              int buffersize)
+{
+    const int groups = (numharmonics + SUB_FILTER_LANES - 1) / SUB_FILTER_LANES;
+    alignas(16) LaneBuffer tmp, acc;
+
+    for(int start = 0; start < buffersize; start += SUB_FILTER_BLOCK) {
+        const int n = buffersize - start < SUB_FILTER_BLOCK ?
+                      buffersize - start : SUB_FILTER_BLOCK;
+        for(int i = 0; i < n; ++i) {
+            vst1q_f32(acc[i],     vdupq_n_f32(0.0f));
+            vst1q_f32(acc[i] + 4, vdupq_n_f32(0.0f));
+        }
+
+        for(int g = 0; g < groups; ++g) {
+            for(int i = 0; i < n; ++i) {
+                const float32x4_t x = vdupq_n_f32(in[start + i]);
+                vst1q_f32(tmp[i],     x);
+                vst1q_f32(tmp[i] + 4, x);
+            }
+
+            for(int s = 0; s < numstages; ++s) {
+                float *f = bank + (g * numstages + s) * SUB_FILTER_FIELDS
+                                  * SUB_FILTER_LANES;
+#define LOAD(field, h) vld1q_f32(f + field * SUB_FILTER_LANES + 4 * h)
+#define STORE(field, h, v) vst1q_f32(f + field * SUB_FILTER_LANES + 4 * h, v)
+                const float32x4_t b0a = LOAD(SUB_B0, 0),  b0b = LOAD(SUB_B0, 1);
+                const float32x4_t b2a = LOAD(SUB_B2, 0),  b2b = LOAD(SUB_B2, 1);
+                const float32x4_t n1a = LOAD(SUB_NA1, 0), n1b = LOAD(SUB_NA1, 1);
+                const float32x4_t n2a = LOAD(SUB_NA2, 0), n2b = LOAD(SUB_NA2, 1);
+                float32x4_t x1a = LOAD(SUB_XN1, 0), x1b = LOAD(SUB_XN1, 1);
+                float32x4_t x2a = LOAD(SUB_XN2, 0), x2b = LOAD(SUB_XN2, 1);
+                float32x4_t y1a = LOAD(SUB_YN1, 0), y1b = LOAD(SUB_YN1, 1);
+                float32x4_t y2a = LOAD(SUB_YN2, 0), y2b = LOAD(SUB_YN2, 1);
+                for(int i = 0; i < n; ++i) {
+                    const float32x4_t xa = vld1q_f32(tmp[i]);
+                    const float32x4_t xb = vld1q_f32(tmp[i] + 4);
+                    const float32x4_t ya = vaddq_f32(vaddq_f32(vaddq_f32(
+                                    vmulq_f32(xa, b0a), vmulq_f32(x2a, b2a)),
+                                    vmulq_f32(y1a, n1a)), vmulq_f32(y2a, n2a));
+                    const float32x4_t yb = vaddq_f32(vaddq_f32(vaddq_f32(
+                                    vmulq_f32(xb, b0b), vmulq_f32(x2b, b2b)),
+                                    vmulq_f32(y1b, n1b)), vmulq_f32(y2b, n2b));
+                    x2a = x1a; x1a = xa; y2a = y1a; y1a = ya;
+                    x2b = x1b; x1b = xb; y2b = y1b; y1b = yb;
+                    vst1q_f32(tmp[i],     ya);
+                    vst1q_f32(tmp[i] + 4, yb);
+                }
+                STORE(SUB_XN1, 0, x1a); STORE(SUB_XN1, 1, x1b);
+                STORE(SUB_XN2, 0, x2a); STORE(SUB_XN2, 1, x2b);
+                STORE(SUB_YN1, 0, y1a); STORE(SUB_YN1, 1, y1b);
+                STORE(SUB_YN2, 0, y2a); STORE(SUB_YN2, 1, y2b);
+#undef LOAD
+#undef STORE
+            }
+
+            const float32x4_t wa = vld1q_f32(gain + g * SUB_FILTER_LANES);
+            const float32x4_t wb = vld1q_f32(gain + g * SUB_FILTER_LANES + 4);
+            for(int i = 0; i < n; ++i) {
+                vst1q_f32(acc[i], vaddq_f32(vld1q_f32(acc[i]),
+                          vmulq_f32(vld1q_f32(tmp[i]), wa)));
+                vst1q_f32(acc[i] + 4, vaddq_f32(vld1q_f32(acc[i] + 4),
+                          vmulq_f32(vld1q_f32(tmp[i] + 4), wb)));
+            }
+        }
+
+        sumLanes(acc, out + start, n);
+    }
+}
+#endif
+
+SubFilterKernel subFilterBankKernel(SimdLevel level)
+{
+    if(!simdSupported(level))
+        return subFilterBankScalar;
+    switch(level) {
+#ifdef ZYN_SIMD_SSE2
+        case SimdLevel::SSE2:
+            return subFilterBankSSE2;
+#endif
+#ifdef ZYN_SIMD_AVX2
+        case SimdLevel::AVX2:
+            return subFilterBankAVX2;
+#endif
+#ifdef ZYN_SIMD_NEON
+        case SimdLevel::NEON:
+            return subFilterBankNEON;
+#endif
+        default:
+            return subFilterBankScalar;
+    }
+}
+
+const SubFilterKernel subFilterBank = subFilterBankKernel(simdLevel());
+
+}
@@ -0,0 +1,81 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  SubFilterBank.h - Band pass filter banks of SUBnote
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include "../DSP/SIMD.h"
+
+namespace zyn {
+
+/**Number of harmonics which are filtered side by side*/
+#define SUB_FILTER_LANES 8
+
+/**Fields of one filter stage: coefficients (b1 is always 0 and the a
+ * coefficients are stored negated) followed by the state*/
+enum SubFilterField {
+    SUB_B0, SUB_B2, SUB_NA1, SUB_NA2,
+    SUB_XN1, SUB_XN2, SUB_YN1, SUB_YN2,
+    SUB_FILTER_FIELDS
+};
+
+/*
+ * The filters of a channel are stored as a structure of arrays: harmonics
+ * are put in groups of SUB_FILTER_LANES, and for each group and stage every
+ * field holds one float per harmonic of the group.
+ * Lanes past the last harmonic are zero, so they output silence.
+ */
+
+/**Number of floats of a bank*/
+inline int subFilterBankSize(int numharmonics, int numstages)
+{
+    const int groups = (numharmonics + SUB_FILTER_LANES - 1) / SUB_FILTER_LANES;
+    return groups * numstages * SUB_FILTER_FIELDS * SUB_FILTER_LANES;
+}
+
+/**Access to the fields of one filter within a bank*/
+class SubFilterLane
+{
+    public:
+        SubFilterLane(float *bank, int numstages, int harmonic, int stage)
+            :p(bank + ((harmonic / SUB_FILTER_LANES) * numstages + stage)
+                      * SUB_FILTER_FIELDS * SUB_FILTER_LANES
+                    + harmonic % SUB_FILTER_LANES)
+        {}
+
+        float &operator[](SubFilterField field) const
+        {
+            return p[field * SUB_FILTER_LANES];
+        }
+
+    private:
+        float *p;
+};
+
+/**
+ * Filters the input through every harmonic's chain of numstages band pass
+ * filters and adds the outputs, weighted by gain[harmonic], to out.
+ * gain holds one entry per lane of the bank (zero for unused ones).
+ */
+typedef void (*SubFilterKernel)(float *bank, int numharmonics, int numstages,
+                                const float *gain, const float *in,
+                                float *out, int buffersize);
+
+/**Reference implementation, all others match it within float rounding*/
+void subFilterBankScalar(float *bank, int numharmonics, int numstages,
+                         const float *gain, const float *in, float *out,
+                         int buffersize);
+
+/**Kernel for the given instruction set (scalar one if unsupported)*/
+SubFilterKernel subFilterBankKernel(SimdLevel level);
+
+/**Fastest kernel for the running CPU*/
+extern const SubFilterKernel subFilterBank;
+
+}
@@ -12,6 +12,7 @@
 #include "SynthNote.h"
 #include "../Params/Controller.h"
 #include "../Misc/Util.h"
+#include "../Misc/Allocator.h"
 #include "../globals.h"
 #include <cstring>
 #include <new>
@@ -22,9 +23,72 @@ namespace zyn {
 SynthNote::SynthNote(const SynthParams &pars)
     :memory(pars.memory),
     legato(pars.synth, pars.velocity, pars.portamento,
-            pars.note_log2_freq, pars.quiet, pars.seed), ctl(pars.ctl), synth(pars.synth), time(pars.time)
+            pars.note_log2_freq, pars.quiet, pars.seed),
+    initial_seed(pars.seed), current_prng_state(pars.seed),
+    ctl(pars.ctl), synth(pars.synth), time(pars.time),
+    start_offset(0), offsetl(NULL), offsetr(NULL), offsetflushed(false)
 {}
 
+SynthNote::~SynthNote()
+{
+    memory.devalloc(offsetl);
+    memory.devalloc(offsetr);
+}
+
+void SynthNote::setStartOffset(int frames)
+{
+    if(frames <= 0 || frames >= synth.buffersize || start_offset)
+        return;
+    try {
+        offsetl = memory.valloc<float>(frames);
+        offsetr = memory.valloc<float>(frames);
+    } catch(std::bad_alloc &) {
+        //start on the buffer boundary instead
+        memory.devalloc(offsetl);
+        return;
+    }
+    memset(offsetl, 0, frames * sizeof(float));
+    memset(offsetr, 0, frames * sizeof(float));
+    start_offset = frames;
+}
+
+void SynthNote::applyStartOffset(float *outl, float *outr)
+{
+    if(!start_offset)
+        return;
+
+    const int n    = start_offset;
+    const int keep = synth.buffersize - n;
+    float tmp[n];
+
+    //the tail goes out with the next buffer, the previous tail goes first
+    memcpy(tmp, outl + keep, n * sizeof(float));
+    memmove(outl + n, outl, keep * sizeof(float));
+    memcpy(outl, offsetl, n * sizeof(float));
+    memcpy(offsetl, tmp, n * sizeof(float));
+
+    memcpy(tmp, outr + keep, n * sizeof(float));
+    memmove(outr + n, outr, keep * sizeof(float));
+    memcpy(outr, offsetr, n * sizeof(float));
+    memcpy(offsetr, tmp, n * sizeof(float));
+}
+
+void SynthNote::offsetnoteout(float *outl, float *outr)
+{
+    if(start_offset && finished()) {
+        memset(outl, 0, synth.bufferbytes);
+        memset(outr, 0, synth.bufferbytes);
+        offsetflushed = true;
+    } else
+        noteout(outl, outr);
+    applyStartOffset(outl, outr);
+}
+
+bool SynthNote::offsetfinished() const
+{
+    return finished() && (!start_offset || offsetflushed);
+}
+
 SynthNote::Legato::Legato(const SYNTH_T &synth_, float vel, int port,
                           float note_log2_freq, bool quiet, prng_t seed)
     :synth(synth_)
@@ -193,12 +257,11 @@ float SynthNote::getFilterCutoffRelFreq(void)
 }
 
 float SynthNote::getRandomFloat() {
-    return (getRandomUint() / (INT32_MAX_FLOAT * 1.0f));
+    return rnd_r(current_prng_state);
 }
 
 prng_t SynthNote::getRandomUint() {
-    current_prng_state = prng_r(current_prng_state);
-    return current_prng_state;
+    return prng_r(current_prng_state) & 0x7fffffff;
 }
 
 }
@@ -46,7 +46,7 @@ class SynthNote
 {
     public:
         SynthNote(const SynthParams &pars);
-        virtual ~SynthNote() {}
+        virtual ~SynthNote();
 
         /**Compute Output Samples
          * @return 0 if note is finished*/
@@ -67,6 +67,23 @@ class SynthNote
 
         virtual SynthNote *cloneLegato(void) = 0;
 
+        /**Start the note the given number of samples into the first buffer
+         * (sample accurate note on). The whole output of the note is delayed
+         * by this amount, so envelopes and LFOs still run on full buffers.
+         * @param frames offset within [0, buffersize)*/
+        void setStartOffset(int frames);
+
+        /**Apply the start offset to a buffer produced by noteout()*/
+        void applyStartOffset(float *outl, float *outr);
+
+        /**noteout() with the start offset applied. Once the note finished
+         * only the carried over samples are left, they are played out in
+         * one more buffer*/
+        void offsetnoteout(float *outl, float *outr);
+
+        /**finished() and the carried over samples have been played*/
+        bool offsetfinished() const;
+
         /* For polyphonic aftertouch needed */
         void setVelocity(float velocity_);
 
@@ -77,7 +94,10 @@ class SynthNote
         void setFilterCutoff(float);
         float getFilterCutoffRelFreq(void);
 
-        /* Random numbers with own seed */
+        /* Random numbers with own seed (same ranges as RND/prng()).
+         * Notes must use these instead of the global generator, so that a
+         * note renders the same no matter what other notes, parts or threads
+         * consumed random numbers before it. */
         float getRandomFloat();
         prng_t getRandomUint();
 
@@ -129,6 +149,11 @@ class SynthNote
         const AbsTime    &time;
         WatchManager     *wm;
         smooth_float     filtercutoff_relfreq;
+
+        //Start offset and the samples carried over to the next buffer
+        int    start_offset;
+        float *offsetl, *offsetr;
+        bool   offsetflushed;
 };
 
 }
@@ -0,0 +1,554 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  UnisonKernel.cpp - Wavetable readers for sets of unison subvoices
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cmath>
+#include "../globals.h"
+#include "UnisonKernel.h"
+
+#ifdef ZYN_SIMD_SSE2
+#include <immintrin.h>
+#endif
+#ifdef ZYN_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace zyn {
+
+void unisonLinearScalar(const float *smps, int oscilsize,
+                        int *poshi_, float *poslo_,
+                        const int *freqhi_, const float *freqlo_,
+                        float *const *out, int voices, int buffersize)
+{
+    for(int k = 0; k < voices; ++k) {
+        int    poshi  = poshi_[k];
+        // convert floating point fractional part (sample interval phase)
+        // with range [0.0 ... 1.0] to fixed point with 1 digit is 2^-24
+        // by multiplying with precalculated 2^24 and casting to integer:
+        int    poslo  = (int)(poslo_[k] * 16777216.0f);
+        int    freqhi = freqhi_[k];
+        // same for phase increment:
+        int    freqlo = (int)(freqlo_[k] * 16777216.0f);
+        float *tw     = out[k];
+        for(int i = 0; i < buffersize; ++i) {
+            tw[i]  = (smps[poshi] * (0x01000000 - poslo) + smps[poshi + 1] * poslo)/(16777216.0f);
+            poslo += freqlo;                // increment fractional part (sample interval phase)
+            poshi += freqhi + (poslo>>24);  // add overflow over 24 bits in poslo to poshi
+            poslo &= 0xffffff;              // remove overflow from poslo
+            poshi &= oscilsize - 1;         // remove overflow
+        }
+        poshi_[k] = poshi;
+        poslo_[k] = poslo/(16777216.0f);
+    }
+}
+
+/*
+ * The vector kernels put one subvoice in each lane and compute four samples
+ * per lane before transposing them into the per subvoice output buffers.
+ * Each step performs the same integer and float operations as the scalar
+ * code, so the positions are identical and the samples agree within rounding
+ * (the compiler may contract or reorder the float ones, e.g. -ffast-math).
+ */
+
+#ifdef ZYN_SIMD_SSE2
+//Four subvoices starting at k
+static void unisonLinearSSE2Group(const float *smps, int oscilsize,
+                                  int *poshi_, float *poslo_,
+                                  const int *freqhi_, const float *freqlo_,
+                                  float *const *out, int buffersize)
+{
+    const __m128  scale  = _mm_set1_ps(16777216.0f);
+    const __m128  iscale = _mm_set1_ps(1.0f / 16777216.0f);
+    const __m128i one    = _mm_set1_epi32(0x01000000);
+    const __m128i lomask = _mm_set1_epi32(0xffffff);
+    const __m128i himask = _mm_set1_epi32(oscilsize - 1);
+
+    __m128i poshi  = _mm_loadu_si128((const __m128i*)poshi_);
+    __m128i poslo  = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(poslo_), scale));
+    __m128i freqhi = _mm_loadu_si128((const __m128i*)freqhi_);
+    __m128i freqlo = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(freqlo_), scale));
+
+    alignas(16) int   idx[4];
+    alignas(16) float tmp[4];
+    __m128 v[4];
+    int i = 0;
+    while(i < buffersize) {
+        const int n = buffersize - i < 4 ? buffersize - i : 4;
+        for(int s = 0; s < n; ++s) {
+            _mm_store_si128((__m128i*)idx, poshi);
+            const __m128 a = _mm_setr_ps(smps[idx[0]], smps[idx[1]],
+                                         smps[idx[2]], smps[idx[3]]);
+            const __m128 b = _mm_setr_ps(smps[idx[0] + 1], smps[idx[1] + 1],
+                                         smps[idx[2] + 1], smps[idx[3] + 1]);
+            const __m128 wa = _mm_cvtepi32_ps(_mm_sub_epi32(one, poslo));
+            const __m128 wb = _mm_cvtepi32_ps(poslo);
+            v[s] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(a, wa), _mm_mul_ps(b, wb)),
+                              iscale);
+
+            poslo = _mm_add_epi32(poslo, freqlo);
+            poshi = _mm_add_epi32(poshi,
+                    _mm_add_epi32(freqhi, _mm_srli_epi32(poslo, 24)));
+            poslo = _mm_and_si128(poslo, lomask);
+            poshi = _mm_and_si128(poshi, himask);
+        }
+
+        if(n == 4) {
+            _MM_TRANSPOSE4_PS(v[0], v[1], v[2], v[3]);
+            for(int j = 0; j < 4; ++j)
+                _mm_storeu_ps(out[j] + i, v[j]);
+        } else
+            for(int s = 0; s < n; ++s) {
+                _mm_store_ps(tmp, v[s]);
+                for(int j = 0; j < 4; ++j)
+                    out[j][i + s] = tmp[j];
+            }
+        i += n;
+    }
+
+    _mm_storeu_si128((__m128i*)poshi_, poshi);
+    _mm_storeu_ps(poslo_, _mm_mul_ps(_mm_cvtepi32_ps(poslo), iscale));
+}
+
+static void unisonLinearSSE2(const float *smps, int oscilsize,
+                             int *poshi, float *poslo,
+                             const int *freqhi, const float *freqlo,
+                             float *const *out, int voices, int buffersize)
+{
+    int k = 0;
+    for(; k + 4 <= voices; k += 4)
+        unisonLinearSSE2Group(smps, oscilsize, poshi + k, poslo + k,
+                              freqhi + k, freqlo + k, out + k, buffersize);
+    unisonLinearScalar(smps, oscilsize, poshi + k, poslo + k, freqhi + k,
+                       freqlo + k, out + k, voices - k, buffersize);
+}
+#endif
+
+#ifdef ZYN_SIMD_AVX2
+//Eight subvoices starting at k
+ZYN_TARGET_AVX2
+static void unisonLinearAVX2Group(const float *smps, int oscilsize,
+                                  int *poshi_, float *poslo_,
+                                  const int *freqhi_, const float *freqlo_,
+                                  float *const *out, int buffersize)
+{
+    const __m256  scale  = _mm256_set1_ps(16777216.0f);
+    const __m256  iscale = _mm256_set1_ps(1.0f / 16777216.0f);
+    const __m256i one    = _mm256_set1_epi32(0x01000000);
+    const __m256i lomask = _mm256_set1_epi32(0xffffff);
+    const __m256i himask = _mm256_set1_epi32(oscilsize - 1);
+
+    __m256i poshi  = _mm256_loadu_si256((const __m256i*)poshi_);
+    __m256i poslo  = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(poslo_), scale));
+    __m256i freqhi = _mm256_loadu_si256((const __m256i*)freqhi_);
+    __m256i freqlo = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(freqlo_), scale));
+
+    alignas(32) float tmp[8];
+    __m256 v[4];
+    int i = 0;
+    while(i < buffersize) {
+        const int n = buffersize - i < 4 ? buffersize - i : 4;
+        for(int s = 0; s < n; ++s) {
+            const __m256 a  = _mm256_i32gather_ps(smps, poshi, 4);
+            const __m256 b  = _mm256_i32gather_ps(smps + 1, poshi, 4);
+            const __m256 wa = _mm256_cvtepi32_ps(_mm256_sub_epi32(one, poslo));
+            const __m256 wb = _mm256_cvtepi32_ps(poslo);
+            v[s] = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(a, wa),
+                                               _mm256_mul_ps(b, wb)), iscale);
+
+            poslo = _mm256_add_epi32(poslo, freqlo);
+            poshi = _mm256_add_epi32(poshi,
+                    _mm256_add_epi32(freqhi, _mm256_srli_epi32(poslo, 24)));
+            poslo = _mm256_and_si256(poslo, lomask);
+            poshi = _mm256_and_si256(poshi, himask);
+        }
+
+        if(n == 4) {
+            //transpose each 128 bit half as its own 4x4 block
+            __m128 lo0 = _mm256_castps256_ps128(v[0]);
+            __m128 lo1 = _mm256_castps256_ps128(v[1]);
+            __m128 lo2 = _mm256_castps256_ps128(v[2]);
+            __m128 lo3 = _mm256_castps256_ps128(v[3]);
+            __m128 hi0 = _mm256_extractf128_ps(v[0], 1);
+            __m128 hi1 = _mm256_extractf128_ps(v[1], 1);
+            __m128 hi2 = _mm256_extractf128_ps(v[2], 1);
+            __m128 hi3 = _mm256_extractf128_ps(v[3], 1);
+            _MM_TRANSPOSE4_PS(lo0, lo1, lo2, lo3);
+            _MM_TRANSPOSE4_PS(hi0, hi1, hi2, hi3);
+            _mm_storeu_ps(out[0] + i, lo0);
+            _mm_storeu_ps(out[1] + i, lo1);
+            _mm_storeu_ps(out[2] + i, lo2);
+            _mm_storeu_ps(out[3] + i, lo3);
+            _mm_storeu_ps(out[4] + i, hi0);
+            _mm_storeu_ps(out[5] + i, hi1);
+            _mm_storeu_ps(out[6] + i, hi2);
+            _mm_storeu_ps(out[7] + i, hi3);
+        } else
+            for(int s = 0; s < n; ++s) {
+                _mm256_store_ps(tmp, v[s]);
+                for(int j = 0; j < 8; ++j)
+                    out[j][i + s] = tmp[j];
+            }
+        i += n;
+    }
+
+    _mm256_storeu_si256((__m256i*)poshi_, poshi);
+    _mm256_storeu_ps(poslo_, _mm256_mul_ps(_mm256_cvtepi32_ps(poslo), iscale));
+}
+
+ZYN_TARGET_AVX2
+static void unisonLinearAVX2(const float *smps, int oscilsize,
+                             int *poshi, float *poslo,
+                             const int *freqhi, const float *freqlo,
+                             float *const *out, int voices, int buffersize)
+{
+    int k = 0;
+    for(; k + 8 <= voices; k += 8)
+        unisonLinearAVX2Group(smps, oscilsize, poshi + k, poslo + k,
+                              freqhi + k, freqlo + k, out + k, buffersize);
+    unisonLinearSSE2(smps, oscilsize, poshi + k, poslo + k, freqhi + k,
+                     freqlo + k, out + k, voices - k, buffersize);
+}
+#endif
+
+#ifdef ZYN_SIMD_NEON
+//Four subvoices starting at k
+static void unisonLinearNEONGroup(const float *smps, int oscilsize,
+                                  int *poshi_, float *poslo_,
+                                  const int *freqhi_, const float *freqlo_,
+                                  float *const *out, int buffersize)
+{
+    const float32x4_t scale  = vdupq_n_f32(16777216.0f);
+    const float32x4_t iscale = vdupq_n_f32(1.0f / 16777216.0f);
+    const int32x4_t   one    = vdupq_n_s32(0x01000000);
+    const int32x4_t   lomask = vdupq_n_s32(0xffffff);
+    const int32x4_t   himask = vdupq_n_s32(oscilsize - 1);
+
+    int32x4_t poshi  = vld1q_s32(poshi_);
+    int32x4_t poslo  = vcvtq_s32_f32(vmulq_f32(vld1q_f32(poslo_), scale));
+    int32x4_t freqhi = vld1q_s32(freqhi_);
+    int32x4_t freqlo = vcvtq_s32_f32(vmulq_f32(vld1q_f32(freqlo_), scale));
+
+    int   idx[4];
+    float a[4], b[4], tmp[4];
+    float32x4_t v[4];
+    int i = 0;
+    while(i < buffersize) {
+        const int n = buffersize - i < 4 ? buffersize - i : 4;
+        for(int s = 0; s < n; ++s) {
+            vst1q_s32(idx, poshi);
+            for(int j = 0; j < 4; ++j) {
+                a[j] = smps[idx[j]];
+                b[j] = smps[idx[j] + 1];
+            }
+            const float32x4_t wa = vcvtq_f32_s32(vsubq_s32(one, poslo));
+            const float32x4_t wb = vcvtq_f32_s32(poslo);
+            v[s] = vmulq_f32(vaddq_f32(vmulq_f32(vld1q_f32(a), wa),
+                                       vmulq_f32(vld1q_f32(b), wb)), iscale);
+
+            poslo = vaddq_s32(poslo, freqlo);
+            poshi = vaddq_s32(poshi, vaddq_s32(freqhi, vshrq_n_s32(poslo, 24)));
+            poslo = vandq_s32(poslo, lomask);
+            poshi = vandq_s32(poshi, himask);
+        }
+
+        if(n == 4) {
+            const float32x4x2_t t01 = vtrnq_f32(v[0], v[1]);
+            const float32x4x2_t t23 = vtrnq_f32(v[2], v[3]);
+            vst1q_f32(out[0] + i, vcombine_f32(vget_low_f32(t01.val[0]),
+                                               vget_low_f32(t23.val[0])));
+            vst1q_f32(out[1] + i, vcombine_f32(vget_low_f32(t01.val[1]),
+                                               vget_low_f32(t23.val[1])));
+            vst1q_f32(out[2] + i, vcombine_f32(vget_high_f32(t01.val[0]),
+                                               vget_high_f32(t23.val[0])));
+            vst1q_f32(out[3] + i, vcombine_f32(vget_high_f32(t01.val[1]),
+                                               vget_high_f32(t23.val[1])));
+        } else
+            for(int s = 0; s < n; ++s) {
+                vst1q_f32(tmp, v[s]);
+                for(int j = 0; j < 4; ++j)
+                    out[j][i + s] = tmp[j];
+            }
+        i += n;
+    }
+
+    vst1q_s32(poshi_, poshi);
+    vst1q_f32(poslo_, vmulq_f32(vcvtq_f32_s32(poslo), iscale));
+}
+
+static void unisonLinearNEON(const float *smps, int oscilsize,
+                             int *poshi, float *poslo,
+                             const int *freqhi, const float *freqlo,
+                             float *const *out, int voices, int buffersize)
+{
+    int k = 0;
+    for(; k + 4 <= voices; k += 4)
+        unisonLinearNEONGroup(smps, oscilsize, poshi + k, poslo + k,
+                              freqhi + k, freqlo + k, out + k, buffersize);
+    unisonLinearScalar(smps, oscilsize, poshi + k, poslo + k, freqhi + k,
+                       freqlo + k, out + k, voices - k, buffersize);
+}
+#endif
+
+/*
+ * Polyphase interpolator
+ *
+ * Output sample at position p = poshi + frac is
+ *   sum_j smps[poshi - TAPS/2 + 1 + j] * h(j - TAPS/2 + 1 - frac)
+ * with h a sinc with cutoff at half the table rate, Kaiser windowed over
+ * TAPS samples. With 32 taps the transition band is 0.42..0.58 of the table
+ * rate; the beta is chosen so the response is within 0.001dB below it and
+ * at least 80dB down above it.
+ * Rows are normalized to unity gain at DC.
+ */
+#define POLYPHASE_PHASES 256
+#define POLYPHASE_BETA   8.0
+
+static double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for(int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum  += term;
+    }
+    return sum;
+}
+
+static struct PolyphaseBank {
+    alignas(32) float coef[POLYPHASE_PHASES][UNISON_POLYPHASE_TAPS];
+    alignas(32) float delta[POLYPHASE_PHASES][UNISON_POLYPHASE_TAPS];
+
+    PolyphaseBank() NONREALTIME {
+        double row[POLYPHASE_PHASES + 1][UNISON_POLYPHASE_TAPS];
+        const double half = UNISON_POLYPHASE_TAPS / 2;
+        for(int p = 0; p <= POLYPHASE_PHASES; ++p) {
+            double sum = 0.0;
+            for(int j = 0; j < UNISON_POLYPHASE_TAPS; ++j) {
+                const double x = j - half + 1 - p / (double)POLYPHASE_PHASES;
+                const double w = 1.0 - (x / half) * (x / half);
+                double h = 0.0;
+                if(w > 0.0) {
+                    h = besselI0(POLYPHASE_BETA * sqrt(w))
+                        / besselI0(POLYPHASE_BETA);
+                    if(x != 0.0)
+                        h *= sin(M_PI * x) / (M_PI * x);
+                }
+                row[p][j] = h;
+                sum      += h;
+            }
+            for(int j = 0; j < UNISON_POLYPHASE_TAPS; ++j)
+                row[p][j] /= sum;
+        }
+        for(int p = 0; p < POLYPHASE_PHASES; ++p)
+            for(int j = 0; j < UNISON_POLYPHASE_TAPS; ++j) {
+                coef[p][j]  = row[p][j];
+                delta[p][j] = row[p + 1][j] - row[p][j];
+            }
+    }
+} polyphase;
+
+//Phase of one subvoice in 24 bit fixed point (see unisonLinearScalar())
+struct FixedPhase {
+    int hi, lo, freqhi, freqlo;
+
+    FixedPhase(int poshi, float poslo, int freqhi_, float freqlo_)
+        :hi(poshi), lo((int)(poslo * 16777216.0f)),
+         freqhi(freqhi_), freqlo((int)(freqlo_ * 16777216.0f))
+    {}
+
+    void advance(int mask) {
+        lo += freqlo;
+        hi += freqhi + (lo >> 24);
+        lo &= 0xffffff;
+        hi &= mask;
+    }
+
+    //first table sample of the interpolator and coefficient row
+    const float *window(const float *smps, int mask) const {
+        return smps + ((hi - UNISON_POLYPHASE_TAPS / 2 + 1) & mask);
+    }
+    int   phase(void) const { return lo >> 16; }
+    float phasefrac(void) const { return (lo & 0xffff) * (1.0f / 65536.0f); }
+    float frac(void) const { return lo / 16777216.0f; }
+};
+
+void unisonPolyphaseScalar(const float *smps, int oscilsize,
+                           int *poshi, float *poslo,
+                           const int *freqhi, const float *freqlo,
+                           float *const *out, int voices, int buffersize)
+{
+    const int mask = oscilsize - 1;
+    for(int k = 0; k < voices; ++k) {
+        FixedPhase ph(poshi[k], poslo[k], freqhi[k], freqlo[k]);
+        float *tw = out[k];
+        for(int i = 0; i < buffersize; ++i) {
+            const float *x  = ph.window(smps, mask);
+            const float *h  = polyphase.coef[ph.phase()];
+            const float *dh = polyphase.delta[ph.phase()];
+            float a = 0.0f, b = 0.0f;
+            for(int j = 0; j < UNISON_POLYPHASE_TAPS; ++j) {
+                a += x[j] * h[j];
+                b += x[j] * dh[j];
+            }
+            tw[i] = a + ph.phasefrac() * b;
+            ph.advance(mask);
+        }
+        poshi[k] = ph.hi;
+        poslo[k] = ph.frac();
+    }
+}
+
+#ifdef ZYN_SIMD_SSE2
+static inline float hsum(__m128 v)
+{
+    const __m128 s = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+}
+
+static void unisonPolyphaseSSE2(const float *smps, int oscilsize,
+                                int *poshi, float *poslo,
+                                const int *freqhi, const float *freqlo,
+                                float *const *out, int voices, int buffersize)
+{
+    const int mask = oscilsize - 1;
+    for(int k = 0; k < voices; ++k) {
+        FixedPhase ph(poshi[k], poslo[k], freqhi[k], freqlo[k]);
+        float *tw = out[k];
+        for(int i = 0; i < buffersize; ++i) {
+            const float *x  = ph.window(smps, mask);
+            const float *h  = polyphase.coef[ph.phase()];
+            const float *dh = polyphase.delta[ph.phase()];
+            __m128 a = _mm_setzero_ps(), b = _mm_setzero_ps();
+            for(int j = 0; j < UNISON_POLYPHASE_TAPS; j += 4) {
+                const __m128 xv = _mm_loadu_ps(x + j);
+                a = _mm_add_ps(a, _mm_mul_ps(xv, _mm_load_ps(h + j)));
+                b = _mm_add_ps(b, _mm_mul_ps(xv, _mm_load_ps(dh + j)));
+            }
+            tw[i] = hsum(_mm_add_ps(a, _mm_mul_ps(_mm_set1_ps(ph.phasefrac()), b)));
+            ph.advance(mask);
+        }
+        poshi[k] = ph.hi;
+        poslo[k] = ph.frac();
+    }
+}
+#endif
+
+#ifdef ZYN_SIMD_AVX2
+ZYN_TARGET_AVX2
+static void unisonPolyphaseAVX2(const float *smps, int oscilsize,
+                                int *poshi, float *poslo,
+                                const int *freqhi, const float *freqlo,
+                                float *const *out, int voices, int buffersize)
+{
+    const int mask = oscilsize - 1;
+    for(int k = 0; k < voices; ++k) {
+        FixedPhase ph(poshi[k], poslo[k], freqhi[k], freqlo[k]);
+        float *tw = out[k];
+        for(int i = 0; i < buffersize; ++i) {
+            const float *x  = ph.window(smps, mask);
+            const float *h  = polyphase.coef[ph.phase()];
+            const float *dh = polyphase.delta[ph.phase()];
+            __m256 a = _mm256_setzero_ps(), b = _mm256_setzero_ps();
+            for(int j = 0; j < UNISON_POLYPHASE_TAPS; j += 8) {
+                const __m256 xv = _mm256_loadu_ps(x + j);
+                a = _mm256_add_ps(a, _mm256_mul_ps(xv, _mm256_load_ps(h + j)));
+                b = _mm256_add_ps(b, _mm256_mul_ps(xv, _mm256_load_ps(dh + j)));
+            }
+            const __m256 v = _mm256_add_ps(a,
+                    _mm256_mul_ps(_mm256_set1_ps(ph.phasefrac()), b));
+            tw[i] = hsum(_mm_add_ps(_mm256_castps256_ps128(v),
+                                    _mm256_extractf128_ps(v, 1)));
+            ph.advance(mask);
+        }
+        poshi[k] = ph.hi;
+        poslo[k] = ph.frac();
+    }
+}
+#endif
+
+#ifdef ZYN_SIMD_NEON
+static void unisonPolyphaseNEON(const float *smps, int oscilsize,
+                                int *poshi, float *poslo,
+                                const int *freqhi, const float *freqlo,
+                                float *const *out, int voices, int buffersize)
+{
+    const int mask = oscilsize - 1;
+    for(int k = 0; k < voices; ++k) {
+        FixedPhase ph(poshi[k], poslo[k], freqhi[k], freqlo[k]);
+        float *tw = out[k];
+        for(int i = 0; i < buffersize; ++i) {
+            const float *x  = ph.window(smps, mask);
+            const float *h  = polyphase.coef[ph.phase()];
+            const float *dh = polyphase.delta[ph.phase()];
+            float32x4_t a = vdupq_n_f32(0.0f), b = vdupq_n_f32(0.0f);
+            for(int j = 0; j < UNISON_POLYPHASE_TAPS; j += 4) {
+                const float32x4_t xv = vld1q_f32(x + j);
+                a = vaddq_f32(a, vmulq_f32(xv, vld1q_f32(h + j)));
+                b = vaddq_f32(b, vmulq_f32(xv, vld1q_f32(dh + j)));
+            }
+            const float32x4_t v = vaddq_f32(a,
+                    vmulq_f32(vdupq_n_f32(ph.phasefrac()), b));
+            float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+            tw[i] = vget_lane_f32(vpadd_f32(s, s), 0);
+            ph.advance(mask);
+        }
+        poshi[k] = ph.hi;
+        poslo[k] = ph.frac();
+    }
+}
+#endif
+
+UnisonKernel unisonPolyphaseKernel(SimdLevel level)
+{
+    if(!simdSupported(level))
+        return unisonPolyphaseScalar;
+    switch(level) {
+#ifdef ZYN_SIMD_SSE2
+        case SimdLevel::SSE2:
+            return unisonPolyphaseSSE2;
+#endif
+#ifdef ZYN_SIMD_AVX2
+        case SimdLevel::AVX2:
+            return unisonPolyphaseAVX2;
+#endif
+#ifdef ZYN_SIMD_NEON
+        case SimdLevel::NEON:
+            return unisonPolyphaseNEON;
+#endif
+        default:
+            return unisonPolyphaseScalar;
+    }
+}
+
+UnisonKernel unisonLinearKernel(SimdLevel level)
+{
+    if(!simdSupported(level))
+        return unisonLinearScalar;
+    switch(level) {
+#ifdef ZYN_SIMD_SSE2
+        case SimdLevel::SSE2:
+            return unisonLinearSSE2;
+#endif
+#ifdef ZYN_SIMD_AVX2
+        case SimdLevel::AVX2:
+            return unisonLinearAVX2;
+#endif
+#ifdef ZYN_SIMD_NEON
+        case SimdLevel::NEON:
+            return unisonLinearNEON;
+#endif
+        default:
+            return unisonLinearScalar;
+    }
+}
+
+const UnisonKernel unisonLinear    = unisonLinearKernel(simdLevel());
+const UnisonKernel unisonPolyphase = unisonPolyphaseKernel(simdLevel());
+
+}
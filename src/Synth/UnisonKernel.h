@@ -0,0 +1,71 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  UnisonKernel.h - Wavetable readers for sets of unison subvoices
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include "../DSP/SIMD.h"
+
+namespace zyn {
+
+/**
+ * Reads one buffer per unison subvoice from a wavetable with linear
+ * interpolation.
+ *
+ * The phases are kept as a structure of arrays (one array per field, one
+ * entry per subvoice), so vector kernels advance several subvoices per
+ * instruction: poshi is the integer part of the position, poslo the fraction
+ * in [0,1) and freqhi/freqlo the increment split the same way.
+ * The fractions are handled as 24 bit fixed point numbers within a buffer.
+ * smps must hold at least oscilsize+1 samples; oscilsize is a power of two.
+ */
+typedef void (*UnisonKernel)(const float *smps, int oscilsize,
+                                   int *poshi, float *poslo,
+                                   const int *freqhi, const float *freqlo,
+                                   float *const *out, int voices,
+                                   int buffersize);
+
+/**Reference implementation, all others must match it*/
+void unisonLinearScalar(const float *smps, int oscilsize,
+                        int *poshi, float *poslo,
+                        const int *freqhi, const float *freqlo,
+                        float *const *out, int voices, int buffersize);
+
+/**Kernel for the given instruction set (scalar one if unsupported)*/
+UnisonKernel unisonLinearKernel(SimdLevel level);
+
+/**Fastest kernel for the running CPU*/
+extern const UnisonKernel unisonLinear;
+
+/**Length of the polyphase interpolator, smps has to hold the beginning of
+ * the table repeated for UNISON_POLYPHASE_TAPS-1 samples after its end*/
+#define UNISON_POLYPHASE_TAPS 32
+
+/**
+ * Same as the linear kernels but reads the wavetable through a polyphase
+ * Kaiser windowed sinc interpolator with its cutoff at half the table rate.
+ * It passes up to 0.42 of the table rate and rejects the images from 0.58
+ * on by 80dB. The output is free of aliasing for any step as long as the
+ * table is band limited to the note (as OscilGen::get() does) and to the
+ * passband; the latter holds for steps of 1.2 table samples or more.
+ *
+ * The coefficients are precomputed for 256 fractional phases and linearly
+ * interpolated between them, which makes one output sample two dot products
+ * over UNISON_POLYPHASE_TAPS neighbouring table samples.
+ */
+void unisonPolyphaseScalar(const float *smps, int oscilsize,
+                           int *poshi, float *poslo,
+                           const int *freqhi, const float *freqlo,
+                           float *const *out, int voices, int buffersize);
+
+UnisonKernel unisonPolyphaseKernel(SimdLevel level);
+
+extern const UnisonKernel unisonPolyphase;
+
+}
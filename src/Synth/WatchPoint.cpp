@@ -158,6 +158,14 @@ bool WatchManager::active(const char *id) const
     return false;
 }
 
+bool WatchManager::any_active(void) const
+{
+    for(int i=0; i<MAX_WATCH; ++i)
+        if(active_list[i][0])
+            return true;
+    return false;
+}
+
 bool WatchManager::trigger_active(const char *id) const
 {
     for(int i=0; i<MAX_WATCH; ++i)
@@ -60,6 +60,7 @@ struct WatchManager
 
     //Watch Point Query API
     bool active(const char *) const;
+    bool any_active(void) const;
     int  samples(const char *) const;
 
     //Watch Point Response API
@@ -231,6 +231,85 @@ class AdNoteTest
 
         }
 
+        void testStartOffset() {
+            //a note started within a buffer is the same note, just delayed
+            const int offset = 100;
+            const int bs     = synth->buffersize;
+            SynthParams pars{memory, *controller, *synth, *time, 120, 0,
+                             test_freq_log2, false, 0x4321};
+            ADnote *ref     = new ADnote(defaultPreset, pars, w);
+            ADnote *shifted = new ADnote(defaultPreset, pars, w);
+            shifted->setStartOffset(offset);
+
+            float *refL = new float[2 * bs], *refR = new float[2 * bs];
+            float *shiftL = new float[2 * bs], *shiftR = new float[2 * bs];
+            for(int b = 0; b < 2; ++b) {
+                ref->noteout(refL + b * bs, refR + b * bs);
+                shifted->noteout(shiftL + b * bs, shiftR + b * bs);
+                shifted->applyStartOffset(shiftL + b * bs, shiftR + b * bs);
+            }
+
+            bool silent = true, same = true;
+            for(int i = 0; i < offset; ++i)
+                silent &= shiftL[i] == 0.0f && shiftR[i] == 0.0f;
+            for(int i = 0; i < 2 * bs - offset; ++i)
+                same &= shiftL[i + offset] == refL[i]
+                     && shiftR[i + offset] == refR[i];
+            TS_ASSERT(silent);
+            TS_ASSERT(same);
+
+            //the carried over samples still play after the note finished
+            ref->entomb();
+            shifted->entomb();
+            ref->noteout(refL, refR);
+            shifted->offsetnoteout(shiftL, shiftR);
+            TS_ASSERT(ref->finished());
+            TS_ASSERT(!shifted->offsetfinished());
+            shifted->offsetnoteout(shiftL + bs, shiftR + bs);
+            TS_ASSERT(shifted->offsetfinished());
+            same = true;
+            for(int i = 0; i < offset; ++i)
+                same &= shiftL[bs + i] == refL[bs - offset + i]
+                     && shiftR[bs + i] == refR[bs - offset + i];
+            TS_ASSERT(same);
+
+            delete ref;
+            delete shifted;
+            delete [] refL;
+            delete [] refR;
+            delete [] shiftL;
+            delete [] shiftR;
+        }
+
+        //the polyphase anti-aliasing renders the same notes faster than
+        //the windowed sinc one
+        void testAntiAliasingSpeed() {
+            const int notes[] = {36, 48, 60, 72, 84, 96};
+            const AATYPE types[] = {AATYPE::SINC, AATYPE::POLYPHASE};
+            clock_t elapsed[2] = {0, 0};
+            for(int t = 0; t < 2; ++t) {
+                for(int v = 0; v < NUM_VOICES; ++v) {
+                    defaultPreset->VoicePar[v].PAAEnabled = true;
+                    defaultPreset->VoicePar[v].PAAType    = types[t];
+                }
+                for(int n : notes) {
+                    const float freq_log2 = log2f(440.0f) + (n - 69.0f) / 12.0f;
+                    SynthParams pars{memory, *controller, *synth, *time, 120, 0,
+                                     freq_log2, false, 0x4321};
+                    ADnote *aanote = new ADnote(defaultPreset, pars);
+                    const clock_t t_on = clock();
+                    for(int i = 0; i < 200; ++i)
+                        aanote->noteout(outL, outR);
+                    elapsed[t] += clock() - t_on;
+                    delete aanote;
+                }
+            }
+            printf("AdNoteTest: sinc %f, polyphase %f seconds for %d notes\n",
+                   (float)elapsed[0] / CLOCKS_PER_SEC,
+                   (float)elapsed[1] / CLOCKS_PER_SEC, 6);
+            TS_ASSERT(elapsed[1] < elapsed[0]);
+        }
+
 #define OUTPUT_PROFILE
 #ifdef OUTPUT_PROFILE
         void testSpeed() {
@@ -253,6 +332,8 @@ int main()
     AdNoteTest test;
     test.setUp();
     test.testDefaults();
+    test.testStartOffset();
+    test.testAntiAliasingSpeed();
     test.tearDown();
     return test_summary();
 }
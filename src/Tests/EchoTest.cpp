@@ -113,6 +113,40 @@ class EchoTest
             TS_ASSERT(abs(outL[0] + outR[0]) / 2 <= amp);
         }
 
+        //Checks that an impulse comes back exactly once after the delay,
+        //also when the delay line wraps around in between
+        void testDelayTime() {
+            testFX->setpreset(3); //Simple Echo, no feedback or dampening
+            testFX->changepar(1, 64); //center
+            testFX->changepar(2, 10); //delay
+            testFX->changepar(3, 64); //no L/R delay
+            testFX->changepar(4, 0);  //no L/R crossover
+            const int delay = (int)(10 / 127.0f * 1.5f * 44100);
+
+            const int bufsize = synth->buffersize;
+            const int impulses[2] = {0, 510 * bufsize};
+            int found = 0;
+            for(int b = 0; b < 600; ++b) {
+                for(int i = 0; i < bufsize; ++i) {
+                    const int t = b * bufsize + i;
+                    input->l[i] = t == impulses[0] || t == impulses[1];
+                    input->r[i] = 0.0f;
+                }
+                testFX->out(*input);
+                for(int i = 0; i < bufsize; ++i) {
+                    const int t = b * bufsize + i;
+                    TS_ASSERT_DELTA(outR[i], 0.0f, 0.0001f);
+                    if(t == impulses[0] + delay || t == impulses[1] + delay) {
+                        TS_ASSERT(outL[i] > 0.1f);
+                        ++found;
+                    }
+                    else
+                        TS_ASSERT_DELTA(outL[i], 0.0f, 0.0001f);
+                }
+            }
+            TS_ASSERT_EQUAL_INT(found, 2);
+        }
+
 
     private:
         Stereo<float *> *input;
@@ -128,5 +162,6 @@ int main()
     RUN_TEST(testInit);
     RUN_TEST(testClear);
     RUN_TEST(testDecaywFb);
+    RUN_TEST(testDelayTime);
     return test_summary();
 }
@@ -10,13 +10,25 @@
   of the License, or (at your option) any later version.
 */
 #include "test-suite.h"
+#include "kernel-test.h"
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include "../Misc/Allocator.h"
 #include "../Misc/Stereo.h"
 #include "../Effects/EffectMgr.h"
 #include "../Effects/Reverb.h"
 #include "../Effects/Echo.h"
+#include "../Effects/Chorus.h"
+#include "../DSP/AnalogFilter.h"
+#include "../DSP/CombBank.h"
+#include "../DSP/DelayLine.h"
+#include "../DSP/FdnBank.h"
+#include "../DSP/Filter.h"
+#include "../DSP/FormantBank.h"
+#include "../DSP/PartitionedConvolver.h"
+#include "../DSP/SVFilter.h"
+#include "../Params/FilterParams.h"
 #include "../globals.h"
 using namespace zyn;
 
@@ -79,6 +91,472 @@ class EffectTest
             TS_NON_NULL(dynamic_cast<Echo*>(mgr->efx));
         }
 
+        //The stereo pass has to match two separate mono filters
+        void testStereoAnalogFilter() {
+            const int bufsize = synth->buffersize;
+            float l[bufsize], r[bufsize], sl[bufsize], sr[bufsize];
+            float maxerr = 0.0f;
+            prng_t rnd = 1;
+            for(int type = 0; type < 9; ++type)
+                for(int stages = 0; stages < MAX_FILTER_STAGES; ++stages) {
+                    AnalogFilter left(type, 1000.0f, 2.0f, stages,
+                                      synth->samplerate, bufsize);
+                    AnalogFilter right(type, 1000.0f, 2.0f, stages,
+                                       synth->samplerate, bufsize);
+                    AnalogFilter both(type, 1000.0f, 2.0f, stages,
+                                      synth->samplerate, bufsize);
+                    left.setgain(6.0f);
+                    right.setgain(6.0f);
+                    both.setgain(6.0f);
+                    for(int block = 0; block < 32; ++block) {
+                        //frequency jumps go through the smoothed path
+                        if(block % 8 == 4) {
+                            const float f = 100.0f + 600.0f * block;
+                            left.setfreq(f);
+                            right.setfreq(f);
+                            both.setfreq(f);
+                        }
+                        for(int i = 0; i < bufsize; ++i) {
+                            l[i] = sl[i] = rnd_r(rnd) - 0.5f;
+                            r[i] = sr[i] = rnd_r(rnd) - 0.5f;
+                        }
+                        left.filterout(l);
+                        right.filterout(r);
+                        both.filterout(sl, sr);
+                        for(int i = 0; i < bufsize; ++i) {
+                            maxerr = fmaxf(maxerr, fabsf(l[i] - sl[i]));
+                            maxerr = fmaxf(maxerr, fabsf(r[i] - sr[i]));
+                        }
+                    }
+                }
+            TS_ASSERT_DELTA(maxerr, 0.0f, 1e-6);
+        }
+
+        //The bank has to sound like separate band passes of FormantFilter
+        void testFormantBank() {
+            const int bufsize = synth->buffersize;
+            float in[bufsize], out[bufsize], ref[bufsize];
+            float tmp[bufsize], ampbuf[bufsize];
+            float freq[FF_MAX_FORMANTS], q[FF_MAX_FORMANTS];
+            float amp[FF_MAX_FORMANTS];
+            float maxerr = 0.0f;
+            prng_t rnd = 1;
+            for(int formants = 1; formants <= FF_MAX_FORMANTS; formants += 5)
+                for(int stages = 0; stages < 3; ++stages) {
+                    FormantBank bank(formants, stages, synth->samplerate,
+                                     bufsize);
+                    AnalogFilter *filter[FF_MAX_FORMANTS];
+                    Value_Smoothing_Filter smoothing[FF_MAX_FORMANTS];
+                    for(int n = 0; n < formants; ++n) {
+                        filter[n] = alloc->alloc<AnalogFilter>(4, 1000.0f,
+                                10.0f, stages, synth->samplerate, bufsize);
+                        smoothing[n].sample_rate(synth->samplerate);
+                        smoothing[n].reset(1.0f);
+                    }
+                    for(int block = 0; block < 32; ++block) {
+                        //new vowels make frequencies and amplitudes move
+                        if(block % 8 == 0)
+                            for(int n = 0; n < formants; ++n) {
+                                freq[n] = 200.0f + 4000.0f * rnd_r(rnd);
+                                q[n]    = 1.0f + 10.0f * rnd_r(rnd);
+                                amp[n]  = rnd_r(rnd);
+                                filter[n]->setfreq_and_q(freq[n], q[n]);
+                                bank.setfreq_and_q(n, freq[n], q[n]);
+                            }
+                        for(int i = 0; i < bufsize; ++i) {
+                            in[i]  = rnd_r(rnd) - 0.5f;
+                            ref[i] = 0.0f;
+                        }
+                        for(int n = 0; n < formants; ++n) {
+                            for(int i = 0; i < bufsize; ++i)
+                                tmp[i] = in[i];
+                            filter[n]->filterout(tmp);
+                            const bool smooth = smoothing[n].apply(ampbuf,
+                                    bufsize, amp[n]);
+                            for(int i = 0; i < bufsize; ++i)
+                                ref[i] += tmp[i] * (smooth ? ampbuf[i] : amp[n]);
+                        }
+                        bank.filterout(in, out, amp);
+                        for(int i = 0; i < bufsize; ++i)
+                            maxerr = fmaxf(maxerr, fabsf(out[i] - ref[i]));
+                    }
+                    for(int n = 0; n < formants; ++n)
+                        alloc->dealloc(filter[n]);
+                }
+            TS_ASSERT_DELTA(maxerr, 0.0f, 1e-5);
+        }
+
+        //FormantFilter comes from the Allocator, which only aligns to 8
+        //bytes, so its bank has to run at any such address
+        void testFormantFilterAllocated() {
+            const int bufsize = synth->buffersize;
+            float buf[bufsize];
+            FilterParams pars;
+            pars.Pcategory = 1;
+            prng_t rnd = 1;
+            for(int k = 0; k < 4; ++k) {
+                //moves the filter by 8 bytes each time
+                double *pad = alloc->valloc<double>(k + 1);
+                Filter *filter = Filter::generate(*alloc, &pars,
+                                                  synth->samplerate, bufsize);
+                for(int block = 0; block < 8; ++block) {
+                    for(int i = 0; i < bufsize; ++i)
+                        buf[i] = rnd_r(rnd) - 0.5f;
+                    filter->filterout(buf);
+                }
+                bool finite = true;
+                for(int i = 0; i < bufsize; ++i)
+                    finite &= std::isfinite(buf[i]);
+                TS_ASSERT(finite);
+                alloc->dealloc(filter);
+                alloc->devalloc(pad);
+            }
+        }
+
+        //Vector kernels of the bank have to match the scalar one
+        void testFormantBankKernels() {
+            const int n = 64, groups = FormantLanes::groups;
+            float in[n], ref[n], out[n];
+            FormantLanes state;
+            prng_t rnd = 1;
+            int order;
+            memset(&state, 0, sizeof(state));
+            for(int l = 0; l < FormantLanes::lanes; ++l) {
+                const AnalogFilter::Coeff c = AnalogFilter::computeCoeff(4,
+                        200.0f + 300.0f * l, 4.0f, 2, 1.0f,
+                        synth->samplerate_f, order);
+                state.c0[l] = c.c[0];
+                state.c1[l] = c.c[1];
+                state.c2[l] = c.c[2];
+                state.d1[l] = c.d[1];
+                state.d2[l] = c.d[2];
+                state.g1[l] = state.g2[l] = rnd_r(rnd);
+                state.amp[l]    = rnd_r(rnd);
+                state.smooth[l] = (l % 3) ? -1 : 0;
+            }
+            fillRandom(rnd, in, n);
+
+            const float error = kernelError([&](SimdLevel level) {
+                FormantLanes a = state, b = state;
+                float maxerr = 0.0f;
+                for(int block = 0; block < 4; ++block) {
+                    formantBankScalar(a, groups, 3, 0.004f, in, ref, n);
+                    formantBankKernel(level)(b, groups, 3, 0.004f, in, out, n);
+                    maxerr = maxError(maxerr, out, ref, n);
+                }
+                return maxError(maxerr, a.g2, b.g2, FormantLanes::lanes);
+            });
+            TS_ASSERT_DELTA(error, 0.0f, 1e-6);
+        }
+
+        //Vector kernels of Reverb's combs have to match the scalar one
+        void testCombBankKernels() {
+            const int n = COMB_BANK_BLOCK;
+            float in[n], refl[n], refr[n], outl[n], outr[n];
+            CombLaneBuffer delayed, ref, out;
+            CombLanes state;
+            prng_t rnd = 1;
+            for(int l = 0; l < COMB_BANK_LANES; ++l) {
+                state.fb[l] = -0.97f + 0.01f * l;
+                state.lp[l] = rnd_r(rnd) - 0.5f;
+            }
+            state.damp = 0.3f;
+
+            const float error = kernelError([&](SimdLevel level) {
+                CombLanes a = state, b = state;
+                float maxerr = 0.0f;
+                for(int block = 0; block < 4; ++block) {
+                    fillRandom(rnd, in, n);
+                    fillRandom(rnd, delayed[0], n * COMB_BANK_LANES);
+                    for(int i = 0; i < n; ++i)
+                        refl[i] = refr[i] = outl[i] = outr[i] = 0.0f;
+                    combBankScalar(a, in, delayed, ref, refl, refr, n);
+                    combBankKernel(level)(b, in, delayed, out, outl, outr, n);
+                    maxerr = maxError(maxerr, outl, refl, n);
+                    maxerr = maxError(maxerr, outr, refr, n);
+                    maxerr = maxError(maxerr, out[0], ref[0],
+                                      n * COMB_BANK_LANES);
+                }
+                return maxError(maxerr, a.lp, b.lp, COMB_BANK_LANES);
+            });
+            TS_ASSERT_DELTA(error, 0.0f, 1e-6);
+        }
+
+        //Vector kernels of the FDN reverb have to match the scalar one
+        void testFdnBankKernels() {
+            const int n = FDN_BLOCK;
+            float in[n], refl[n], refr[n], outl[n], outr[n];
+            FdnLaneBuffer delayed, ref, out;
+            FdnLanes state;
+            prng_t rnd = 1;
+            for(int l = 0; l < FDN_LINES; ++l) {
+                state.glow[l]  = 0.9f + 0.005f * l;
+                state.ghigh[l] = 0.7f + 0.01f * l;
+                state.lp[l]    = rnd_r(rnd) - 0.5f;
+                state.in[l]    = (l % 2) ? -1.0f : 1.0f;
+            }
+            state.cross = 0.3f;
+
+            const float error = kernelError([&](SimdLevel level) {
+                FdnLanes a = state, b = state;
+                float maxerr = 0.0f;
+                for(int block = 0; block < 4; ++block) {
+                    fillRandom(rnd, in, n);
+                    fillRandom(rnd, delayed[0], n * FDN_LINES);
+                    for(int i = 0; i < n; ++i)
+                        refl[i] = refr[i] = outl[i] = outr[i] = 0.0f;
+                    fdnBankScalar(a, in, delayed, ref, refl, refr, n);
+                    fdnBankKernel(level)(b, in, delayed, out, outl, outr, n);
+                    maxerr = maxError(maxerr, outl, refl, n);
+                    maxerr = maxError(maxerr, outr, refr, n);
+                    maxerr = maxError(maxerr, out[0], ref[0], n * FDN_LINES);
+                }
+                return maxError(maxerr, a.lp, b.lp, FDN_LINES);
+            });
+            TS_ASSERT_DELTA(error, 0.0f, 1e-6);
+        }
+
+        //The FDN type has to ring on both channels and die away
+        void testFdnReverb() {
+            const int bufsize = synth->buffersize;
+            float outl[bufsize], outr[bufsize], inl[bufsize], inr[bufsize];
+            EffectParams pars{*alloc, false, outl, outr, 13,
+                              synth->samplerate, bufsize, nullptr};
+            Reverb reverb(pars);
+            TS_ASSERT_EQUAL_INT(reverb.getpar(10), 3);
+
+            prng_t rnd = 1;
+            const int blocks = synth->samplerate / bufsize; //a second
+            float energy[2][4] = {{0}};
+            for(int block = 0; block < 4 * blocks; ++block) {
+                for(int i = 0; i < bufsize; ++i) {
+                    inl[i] = inr[i] = block < 4 ? rnd_r(rnd) - 0.5f : 0.0f;
+                    outl[i] = outr[i] = 0.0f;
+                }
+                reverb.out(Stereo<float *>(inl, inr));
+                for(int i = 0; i < bufsize; ++i) {
+                    energy[0][block / blocks] += outl[i] * outl[i];
+                    energy[1][block / blocks] += outr[i] * outr[i];
+                }
+            }
+            for(int ch = 0; ch < 2; ++ch) {
+                TS_ASSERT(energy[ch][0] > 0.0f);
+                for(int s = 1; s < 4; ++s)
+                    TS_ASSERT(energy[ch][s] < energy[ch][s - 1]);
+            }
+        }
+
+        //Random comb lengths come from the seed of the instance
+        void testReverbSeeds() {
+            const int bufsize = synth->buffersize;
+            float out[3][2][bufsize], in[bufsize];
+            const prng_t seeds[3] = {1, 1, 2};
+            Reverb *reverb[3];
+            for(int k = 0; k < 3; ++k) {
+                EffectParams pars{*alloc, false, out[k][0], out[k][1], 0,
+                                  synth->samplerate, bufsize, nullptr, false,
+                                  seeds[k]};
+                reverb[k] = new Reverb(pars);
+                reverb[k]->changepar(10, 0); //random type
+            }
+
+            prng_t rnd = 1;
+            int same = 0, different = 0;
+            for(int block = 0; block < 64; ++block) { //past the predelay
+                for(int i = 0; i < bufsize; ++i)
+                    in[i] = block < 4 ? rnd_r(rnd) - 0.5f : 0.0f;
+                for(int k = 0; k < 3; ++k) {
+                    memset(out[k], 0, sizeof(out[k]));
+                    reverb[k]->out(Stereo<float *>(in, in));
+                }
+                same      += memcmp(out[0], out[1], sizeof(out[0])) != 0;
+                different += memcmp(out[0], out[2], sizeof(out[0])) != 0;
+            }
+            TS_ASSERT_EQUAL_INT(same, 0);
+            TS_ASSERT(different > 0);
+            for(int k = 0; k < 3; ++k)
+                delete reverb[k];
+        }
+
+        void testDelayReadKernels() {
+            const int mask = 255;
+            float buf[mask + 1], ref[50], out[50];
+            prng_t rnd = 1;
+            fillRandom(rnd, buf, mask + 1);
+
+            TS_ASSERT_DELTA(kernelError([&](SimdLevel level) {
+                float err = 0.0f;
+                for(int t = 0; t < 100; ++t) {
+                    //crossing the end of the buffer and negative positions
+                    const int   n     = 1 + t % 50;
+                    const int   base  = 230 - t;
+                    const float x0    = -3.0f * rnd_r(rnd);
+                    const float step  = 0.5f + rnd_r(rnd);
+                    for(int i = 0; i < n; ++i)
+                        ref[i] = out[i] = 0.1f * i;
+                    delayReadScalar(buf, mask, base, x0, step, ref, n);
+                    delayReadKernel(level)(buf, mask, base, x0, step, out, n);
+                    err = maxError(err, out, ref, n);
+                }
+                return err;
+            }), 0.0f, 1e-6);
+        }
+
+        //Without modulation all voices of the ensemble are the same, so
+        //they add up to sqrt(voices) times a single one
+        void testChorusVoices() {
+            const int bufsize = synth->buffersize;
+            float outl[2][bufsize], outr[2][bufsize], inl[bufsize], inr[bufsize];
+            Chorus *chorus[2];
+            for(int c = 0; c < 2; ++c) {
+                EffectParams pars{*alloc, false, outl[c], outr[c], 10,
+                                  synth->samplerate, bufsize, nullptr};
+                chorus[c] = new Chorus(pars);
+                chorus[c]->changepar(6, 0);  //no depth
+                chorus[c]->changepar(8, 64); //no feedback
+            }
+            TS_ASSERT_EQUAL_INT(chorus[0]->getpar(12), 4);
+            chorus[1]->changepar(12, 1);
+
+            prng_t rnd = 1;
+            float maxerr = 0.0f, peak = 0.0f;
+            for(int block = 0; block < 50; ++block) {
+                for(int i = 0; i < bufsize; ++i)
+                    inl[i] = inr[i] = rnd_r(rnd) - 0.5f;
+                for(int c = 0; c < 2; ++c)
+                    chorus[c]->out(Stereo<float *>(inl, inr));
+                for(int i = 0; i < bufsize; ++i) {
+                    maxerr = fmaxf(maxerr, fabsf(outl[0][i] - 2.0f * outl[1][i]));
+                    maxerr = fmaxf(maxerr, fabsf(outr[0][i] - 2.0f * outr[1][i]));
+                    peak   = fmaxf(peak, fabsf(outl[1][i]));
+                }
+            }
+            TS_ASSERT(peak > 0.1f);
+            TS_ASSERT_DELTA(maxerr, 0.0f, 1e-5);
+            for(int c = 0; c < 2; ++c)
+                delete chorus[c];
+        }
+
+        //The partitioned convolution has to match the direct one, without
+        //any delay, through the head and many partitions of the tail
+        void testPartitionedConvolver() {
+            const int bufsize = 64;
+            const int irlen   = 2 * 1024 + 20 * 1024 + 37;
+            const int len     = (irlen / bufsize + 32) * bufsize;
+            float *ir  = new float[irlen];
+            float *in  = new float[len];
+            float *out = new float[len];
+            prng_t rnd = 1;
+            for(int i = 0; i < irlen; ++i)
+                ir[i] = (rnd_r(rnd) - 0.5f) * expf(-4.0f * i / irlen);
+            for(int i = 0; i < len; ++i)
+                in[i] = rnd_r(rnd) - 0.5f;
+
+            PartitionedConvolver conv(ir, irlen, bufsize);
+            for(int i = 0; i < len; i += bufsize) {
+                memcpy(out + i, in + i, bufsize * sizeof(float));
+                conv.process(out + i, out + i);
+            }
+
+            float maxerr = 0.0f;
+            for(int i = 0; i < len; ++i) {
+                double direct = 0.0;
+                for(int k = 0; k < irlen && k <= i; ++k)
+                    direct += in[i - k] * (double)ir[k];
+                maxerr = fmaxf(maxerr, fabsf(out[i] - direct));
+            }
+            TS_ASSERT_DELTA(maxerr, 0.0f, 1e-4);
+
+            //after a cleanup in the middle of a tail block nothing of the
+            //past input may be heard
+            for(int i = 0; i < 5 * bufsize; i += bufsize)
+                conv.process(in + i, out + i);
+            conv.cleanup();
+            float *again = new float[len];
+            for(int i = 0; i < len; i += bufsize)
+                conv.process(in + i, again + i);
+            PartitionedConvolver fresh(ir, irlen, bufsize);
+            for(int i = 0; i < len; i += bufsize)
+                fresh.process(in + i, out + i);
+            TS_ASSERT_DELTA(maxError(0.0f, out, again, len), 0.0f, 1e-6);
+
+            delete [] ir;
+            delete [] in;
+            delete [] out;
+            delete [] again;
+        }
+
+        //Skipping ahead 8 frames has to follow the per frame smoothing
+        void testSmoothingEvery8() {
+            const int bufsize = synth->buffersize;
+            float full[bufsize], every8[bufsize / 8];
+            Value_Smoothing_Filter a, b;
+            a.sample_rate(synth->samplerate);
+            b.sample_rate(synth->samplerate);
+            a.reset(0.05f);
+            b.reset(0.05f);
+            float maxerr = 0.0f;
+            for(int block = 0; block < 64; ++block) {
+                const float target = (block / 16) % 2 ? 0.9f : 0.01f;
+                const bool moving = a.apply(full, bufsize, target);
+                TS_ASSERT(moving == b.apply_every8(every8, bufsize, target));
+                if(!moving)
+                    continue;
+                for(int i = 0; i < bufsize; i += 8)
+                    maxerr = fmaxf(maxerr, fabsf(full[i] - every8[i / 8]));
+                //both end on the last frame
+                maxerr = fmaxf(maxerr, fabsf(a.value() - b.value()));
+            }
+            TS_ASSERT_DELTA(maxerr, 0.0f, 1e-5);
+        }
+
+        //Ramped state variable filters match the classic one at a fixed
+        //frequency and filter stereo pairs like two mono filters (exactly
+        //without -ffast-math)
+        void testRampedSVFilter() {
+            const int bufsize = synth->buffersize;
+            float x[bufsize], y[bufsize], l[bufsize], r[bufsize];
+            float maxerr = 0.0f;
+            for(int type = 0; type < 4; ++type) {
+                SVFilter classic(type, 1000.0f, 2.0f, 3, synth->samplerate,
+                                 bufsize, false);
+                SVFilter mono(type, 1000.0f, 2.0f, 3, synth->samplerate,
+                              bufsize, true);
+                SVFilter right(type, 1000.0f, 2.0f, 3, synth->samplerate,
+                               bufsize, true);
+                SVFilter both(type, 1000.0f, 2.0f, 3, synth->samplerate,
+                              bufsize, true);
+                prng_t rnd = 1;
+                for(int block = 0; block < 64; ++block) {
+                    if(block >= 32) {
+                        //fast LFO over three octaves each way
+                        const float f = 1000.0f * powf(2.0f, 3.0f * sinf(block * 0.1f));
+                        mono.setfreq(f);
+                        right.setfreq(f);
+                        both.setfreq(f);
+                    }
+                    for(int i = 0; i < bufsize; ++i) {
+                        y[i] = l[i] = rnd_r(rnd) - 0.5f;
+                        x[i] = r[i] = rnd_r(rnd) - 0.5f;
+                    }
+                    float c[bufsize];
+                    memcpy(c, y, sizeof(c));
+                    classic.filterout(c);
+                    mono.filterout(y);
+                    right.filterout(x);
+                    both.filterout(l, r);
+                    for(int i = 0; i < bufsize; ++i) {
+                        if(block < 32)
+                            maxerr = fmaxf(maxerr, fabsf(c[i] - y[i]));
+                        maxerr = fmaxf(maxerr, fabsf(y[i] - l[i]));
+                        maxerr = fmaxf(maxerr, fabsf(x[i] - r[i]));
+                    }
+                }
+            }
+            TS_ASSERT_DELTA(maxerr, 0.0f, 1e-6);
+        }
+
+
     private:
         EffectMgr *mgr;
         Allocator *alloc;
@@ -91,5 +569,18 @@ int main()
     RUN_TEST(testInit);
     RUN_TEST(testClear);
     RUN_TEST(testSwap);
+    RUN_TEST(testStereoAnalogFilter);
+    RUN_TEST(testFormantBank);
+    RUN_TEST(testFormantFilterAllocated);
+    RUN_TEST(testFormantBankKernels);
+    RUN_TEST(testCombBankKernels);
+    RUN_TEST(testFdnBankKernels);
+    RUN_TEST(testFdnReverb);
+    RUN_TEST(testReverbSeeds);
+    RUN_TEST(testDelayReadKernels);
+    RUN_TEST(testChorusVoices);
+    RUN_TEST(testPartitionedConvolver);
+    RUN_TEST(testSmoothingEvery8);
+    RUN_TEST(testRampedSVFilter);
     return test_summary();
 }
@@ -0,0 +1,158 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  FastMathTest.cpp - Accuracy and speed of the fast math tiers
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "test-suite.h"
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include "../DSP/FastMath.h"
+#include "../globals.h"
+
+using namespace zyn;
+
+//Largest error of f against ref over n points of [lo, hi], relative
+//errors are divided by max(|ref|, 1e-30)
+template<class F, class R>
+static double maxerror(F f, R ref, float lo, float hi, bool relative)
+{
+    const int n = 200000;
+    double err = 0.0;
+    for(int i = 0; i <= n; ++i) {
+        //volatile keeps a single float x with -ffast-math
+        volatile float vx = lo + (hi - lo) * i / n;
+        const float  x = vx;
+        const double r = ref((double)x);
+        double e = fabs(f(x) - r);
+        if(relative)
+            e /= fmax(fabs(r), 1e-30);
+        err = fmax(err, e);
+    }
+    return err;
+}
+
+class FastMathTest
+{
+    public:
+        void setUp() {}
+        void tearDown() {}
+
+        template<int tier>
+        void report(const char *name, const double bound[6]) {
+            using namespace fastmath;
+            const double err[6] = {
+                maxerror(exp2<tier>, [](double x){return ::exp2(x);},
+                         -60.0f, 60.0f, true),
+                maxerror(log2<tier>, [](double x){return ::log2(x);},
+                         1e-6f, 1e4f, false),
+                maxerror(sin<tier>, [](double x){return ::sin(x);},
+                         -100.0f, 100.0f, false),
+                maxerror(cos<tier>, [](double x){return ::cos(x);},
+                         -100.0f, 100.0f, false),
+                maxerror(tan<tier>, [](double x){return ::tan(x);},
+                         -1.4f, 1.4f, true),
+                maxerror(atan<tier>, [](double x){return ::atan(x);},
+                         -100.0f, 100.0f, false),
+            };
+            const char *fn[6] = {"exp2 (rel)", "log2", "sin", "cos",
+                                 "tan (rel)", "atan"};
+            for(int i = 0; i < 6; ++i) {
+                printf("FastMathTest: %-5s %-10s max error %.3g\n",
+                       name, fn[i], err[i]);
+                TS_ASSERT(err[i] <= bound[i]);
+            }
+        }
+
+        void testAccuracy() {
+            //high is as good as the C library (with -ffast-math)
+            const double highb[6]  = {5e-7, 2e-6, 5e-7, 5e-7, 5e-7, 5e-7};
+            const double fastb[6]  = {1e-4, 1e-4, 1e-4, 1e-4, 1e-4, 2e-5};
+            report<fastmath::exact>("exact", highb);
+            report<fastmath::high>("high", highb);
+            report<fastmath::fast>("fast", fastb);
+        }
+
+        //Special values the call sites rely on
+        void testEdges() {
+            using namespace fastmath;
+            TS_ASSERT_DELTA(exp2<high>(0.0f), 1.0f, 0.0f);
+            TS_ASSERT_DELTA(exp2<fast>(0.0f), 1.0f, 0.0f);
+            TS_ASSERT_DELTA(exp2<high>(10.0f), 1024.0f, 0.0f);
+            TS_ASSERT_DELTA(log2<high>(1.0f), 0.0f, 0.0f);
+            TS_ASSERT_DELTA(log2<fast>(8.0f), 3.0f, 0.0f);
+            TS_ASSERT_DELTA(sin<high>(0.0f), 0.0f, 0.0f);
+            TS_ASSERT_DELTA(atan<high>(0.0f), 0.0f, 0.0f);
+            //no infinities or NaN out of range
+            TS_ASSERT(exp2<high>(-1000.0f) >= 0.0f);
+            TS_ASSERT(std::isfinite(exp2<high>(1000.0f)));
+            TS_ASSERT(log2<high>(0.0f) <= -126.0f);
+            TS_ASSERT_DELTA(pow<high>(0.0f, 0.5f), 0.0f, 0.0f);
+            TS_ASSERT_DELTA(pow<fast>(-2.0f, 2.0f), 0.0f, 0.0f);
+            //conversions stay within int32_t
+            TS_ASSERT_EQUAL_INT(nearest(2.5f), 3);
+            TS_ASSERT_EQUAL_INT(nearest(-2.5f), -2);
+            TS_ASSERT_EQUAL_INT(nearest(1e10f), 2147483520);
+            TS_ASSERT_EQUAL_INT(nearest(-1e10f), INT32_MIN);
+            TS_ASSERT_DELTA(db2rap<high>(-6.0f), dB2rap(-6.0f), 1e-6);
+            TS_ASSERT_DELTA(db2rap<exact>(-6.0f), dB2rap(-6.0f), 0.0f);
+        }
+
+#define OUTPUT_PROFILE
+#ifdef OUTPUT_PROFILE
+        template<int tier>
+        void speed(const char *name) {
+            using namespace fastmath;
+            const int n = 4096, rounds = 500;
+            float in[n];
+            float sum = 0.0f;
+            for(int i = 0; i < n; ++i)
+                in[i] = 0.001f + 4.0f * i / n;
+
+            const char *fn[6] = {"exp2", "log2", "sin", "cos", "tan", "atan"};
+            for(int f = 0; f < 6; ++f) {
+                const clock_t t_on = clock();
+                for(int r = 0; r < rounds; ++r) {
+                    //a new input each round, so nothing can be hoisted
+                    const float d = r * 1e-6f;
+                    switch(f) {
+                        case 0: for(int i = 0; i < n; ++i) sum += exp2<tier>(in[i] + d); break;
+                        case 1: for(int i = 0; i < n; ++i) sum += log2<tier>(in[i] + d); break;
+                        case 2: for(int i = 0; i < n; ++i) sum += sin<tier>(in[i] + d); break;
+                        case 3: for(int i = 0; i < n; ++i) sum += cos<tier>(in[i] + d); break;
+                        case 4: for(int i = 0; i < n; ++i) sum += tan<tier>(in[i] + d); break;
+                        case 5: for(int i = 0; i < n; ++i) sum += atan<tier>(in[i] + d); break;
+                    }
+                }
+                const clock_t t_off = clock();
+                printf("FastMathTest: %-5s %-4s %.2f ns per value\n", name,
+                       fn[f], (t_off - t_on) * 1e9 / CLOCKS_PER_SEC / n / rounds);
+            }
+            //keep the results alive
+            TS_ASSERT(sum != 0.0f);
+        }
+
+        void testSpeed() {
+            speed<fastmath::exact>("exact");
+            speed<fastmath::high>("high");
+            speed<fastmath::fast>("fast");
+        }
+#endif
+};
+
+int main()
+{
+    FastMathTest test;
+    RUN_TEST(testAccuracy);
+    RUN_TEST(testEdges);
+#ifdef OUTPUT_PROFILE
+    RUN_TEST(testSpeed);
+#endif
+    return test_summary();
+}
@@ -105,6 +105,34 @@ class OscilGenTest
             TS_ASSERT_DELTA(outR[66], 0.001293f, 0.0001f);
         }
 
+        //band limited tables must match the direct rendering when no harmonic
+        //lies between the table limit and the note's band limit
+        void testTables(void)
+        {
+            oscil->Prand = 64;
+            //band limit of exactly 128 harmonics, which is one of the tables
+            const float tablefreq = 0.5f * synth->samplerate_f / 128.5f;
+
+            oscil->get(outR, tablefreq);
+            oscil->buildTables(*fft);
+            TS_ASSERT(oscil->tables != NULL);
+            oscil->get(outL, tablefreq);
+            for(int i = 0; i < synth->oscilsize; ++i)
+                TS_ASSERT_DELTA(outL[i], outR[i], 0.0001f);
+
+            //a band limit between two tables uses the lower one, so no
+            //harmonic goes beyond it
+            const OscilTables &t = *oscil->tables;
+            const int table = (t.get(129) - t.smps) / t.size;
+            TS_ASSERT(t.limit[table] <= 129);
+            TS_ASSERT(table + 1 < t.count && t.limit[table + 1] > 129);
+
+            //changing the oscillator outdates them
+            oscil->Pbasefuncpar = 10;
+            oscil->get(outL, tablefreq);
+            TS_ASSERT(oscil->tables->freqs == NULL);
+        }
+
         //performance testing
 #ifdef __linux__
         void testSpeed() {
@@ -135,6 +163,7 @@ int main()
     RUN_TEST(testInit);
     RUN_TEST(testOutput);
     RUN_TEST(testSpectrum);
+    RUN_TEST(testTables);
 #ifdef __linux__
     RUN_TEST(testSpeed);
 #endif
@@ -14,19 +14,26 @@
 
 //Based Upon AdNoteTest.h and SubNoteTest.h
 #include "test-suite.h"
+#include "kernel-test.h"
+#include <atomic>
 #include <complex>
 #include <ctime>
 #include <string>
+#include <chrono>
+#include <thread>
 #define private public
 #include "../Synth/PADnote.h"
 #undef private
 #include "../Misc/Master.h"
+#include "../Misc/Config.h"
 #include "../Misc/Util.h"
 #include "../Misc/Allocator.h"
 #include "../Misc/XMLwrapper.h"
 #include "../Synth/PADnote.h"
 #include "../Synth/OscilGen.h"
+#include "../Synth/PADInterpolation.h"
 #include "../Params/PADnoteParameters.h"
+#include "../Params/PADSampleStore.h"
 #include "../Params/Presets.h"
 #include "../DSP/FFTwrapper.h"
 #include "../globals.h"
@@ -52,6 +59,7 @@ class PadNoteTest
         float test_freq_log2;
         Alloc         memory;
         int           interpolation;
+        prng_t        phases; //generator state pars took its phases from
         rtosc::ThreadLink *tr;
         WatchManager *w;
 
@@ -98,7 +106,10 @@ class PadNoteTest
 
 
             //defaultPreset->defaults();
-            pars->applyparameters([]{return false;}, 1);
+            //the expected samples below have their phases drawn from the
+            //global generator
+            phases = prng_state;
+            pars->applyparameters([]{return false;}, 1, &prng_state);
 
             //verify xml was loaded
             ///TS_ASSERT(defaultPreset->VoicePar[1].Enabled);
@@ -273,6 +284,230 @@ class PadNoteTest
 
         }
 
+        //instruments with the same harmonic content share one sample table
+        void testSharedSamples() {
+            const int tables = PADSampleStore::tables();
+            TS_ASSERT_EQUAL_INT(tables, 1);
+
+            PADnoteParameters *copy = new PADnoteParameters(*synth, fft, time);
+            copy->paste(*pars);
+            prng_t rnd = phases;
+            copy->applyparameters([]{return false;}, 1, &rnd);
+            TS_ASSERT_EQUAL_INT(PADSampleStore::tables(), tables);
+            TS_ASSERT(copy->sample[0].smp == pars->sample[0].smp);
+
+            //other phases get their own table
+            copy->applyparameters([]{return false;}, 1);
+            TS_ASSERT_EQUAL_INT(PADSampleStore::tables(), tables + 1);
+            TS_ASSERT(copy->sample[0].smp != pars->sample[0].smp);
+
+            //a different spectrum gets its own table
+            copy->setPbandwidth(pars->Pbandwidth > 500 ? 100 : 900);
+            rnd = phases;
+            copy->applyparameters([]{return false;}, 1, &rnd);
+            TS_ASSERT_EQUAL_INT(PADSampleStore::tables(), tables + 1);
+            TS_ASSERT(copy->sample[0].smp != pars->sample[0].smp);
+            TS_NON_NULL(pars->sample[0].smp);
+
+            delete copy;
+            TS_ASSERT_EQUAL_INT(PADSampleStore::tables(), tables);
+        }
+
+        //a thread waiting for a table another one generates gives up as
+        //soon as it is told to, without waiting for the generation
+        void testAbortWait() {
+            const int tables = PADSampleStore::tables();
+            const uint64_t key = 0x5eed;
+            std::atomic<bool> finish(false), abort(false), returned(false);
+            PADSampleTable *first = NULL, *second = NULL;
+
+            std::thread generator([&] {
+                first = PADSampleStore::acquire(key,
+                        [&finish](PADSampleTable &) {
+                            while(!finish)
+                                std::this_thread::sleep_for(
+                                    std::chrono::milliseconds(1));
+                            return true;
+                        }, []{return false;});
+            });
+            while(PADSampleStore::tables() == tables)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            std::thread waiter([&] {
+                second = PADSampleStore::acquire(key,
+                        [](PADSampleTable &) {return true;},
+                        [&abort]{return (bool)abort;});
+                returned = true;
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            TS_ASSERT(!returned);
+
+            abort = true;
+            PADSampleStore::wakeWaiting();
+            waiter.join();
+            TS_ASSERT(second == NULL);
+            TS_ASSERT(!finish);
+
+            finish = true;
+            generator.join();
+            TS_NON_NULL(first);
+            PADSampleStore::release(first);
+            TS_ASSERT_EQUAL_INT(PADSampleStore::tables(), tables);
+        }
+
+        //the key only depends on the parameters, including the phase seed,
+        //so it is the same after a reload
+        void testSampleKeySeed() {
+            PADnoteParameters *a = new PADnoteParameters(*synth, fft, time);
+            PADnoteParameters *b = new PADnoteParameters(*synth, fft, time);
+            a->paste(*pars);
+            b->paste(*pars);
+            const uint64_t key = a->samplekey();
+            TS_ASSERT(key == b->samplekey());
+            TS_ASSERT(key == a->samplekey());
+            const prng_t rnd = a->phaseseed();
+            TS_ASSERT(key == a->samplekey(-1, &rnd));
+
+            b->Pphaseseed = a->Pphaseseed + 1;
+            TS_ASSERT(key != b->samplekey());
+            TS_ASSERT(a->phaseseed() != b->phaseseed());
+
+            delete a;
+            delete b;
+        }
+
+        //as many samples spread over other octaves are other samples
+        void testSampleKeyOctaves() {
+            PADnoteParameters *a = new PADnoteParameters(*synth, fft, time);
+            PADnoteParameters *b = new PADnoteParameters(*synth, fft, time);
+            a->paste(*pars);
+            b->paste(*pars);
+            a->Pquality.oct    = 1;
+            a->Pquality.smpoct = 2;
+            b->Pquality.oct    = 3;
+            b->Pquality.smpoct = 1;
+
+            float freqa[PAD_MAX_SAMPLES], freqb[PAD_MAX_SAMPLES];
+            TS_ASSERT_EQUAL_INT(a->samplefreqs(freqa), 4);
+            TS_ASSERT_EQUAL_INT(b->samplefreqs(freqb), 4);
+            TS_ASSERT(a->samplekey() != b->samplekey());
+
+            const int tables = PADSampleStore::tables();
+            a->applyparameters([]{return false;}, 1);
+            b->applyparameters([]{return false;}, 1);
+            TS_ASSERT_EQUAL_INT(PADSampleStore::tables(), tables + 2);
+            TS_ASSERT_DELTA(a->sample[3].basefreq, freqa[3], 0.001f);
+            TS_ASSERT_DELTA(b->sample[3].basefreq, freqb[3], 0.001f);
+
+            delete a;
+            delete b;
+            TS_ASSERT_EQUAL_INT(PADSampleStore::tables(), tables);
+        }
+
+        int generatedSamples(const PADnoteParameters *p) {
+            int n = 0;
+            for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
+                if(p->sample[i].smp)
+                    ++n;
+            return n;
+        }
+
+        void testLazySamples() {
+            Config config;
+            config.cfg.PADLazy = 1;
+            PADSampleStore::setConfig(&config);
+
+            PADnoteParameters *lazy = new PADnoteParameters(*synth, fft, time);
+            lazy->paste(*pars);
+            lazy->applyparameters([]{return false;}, 1);
+            TS_ASSERT_EQUAL_INT(generatedSamples(lazy), 1);
+
+            //a low note falls back to the only sample and requests its own
+            const float low_freq_log2 = log2f(440.0f) + (30.0f - 69.0f) / 12.0f;
+            SynthParams pars_{memory, *controller, *synth, *time, 120, 0,
+                              low_freq_log2, false, prng()};
+            PADnote *low = new PADnote(lazy, pars_, interpolation);
+            const int fallback = low->nsample;
+            float sum = 0.0f;
+            for(int i = 0; i < 10; ++i) {
+                low->noteout(outL, outR);
+                for(int j = 0; j < synth->buffersize; ++j)
+                    sum += fabsf(outL[j]);
+            }
+            TS_ASSERT(sum > 0.1f);
+            delete low;
+
+            //the worker adds it together with its neighbours
+            for(int i = 0; i < 1000 && generatedSamples(lazy) < 3; ++i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            TS_ASSERT(generatedSamples(lazy) >= 3);
+
+            low = new PADnote(lazy, pars_, interpolation);
+            TS_ASSERT(low->nsample < fallback);
+            TS_NON_NULL(lazy->sample[low->nsample].smp);
+
+            //a dropped sample does not end the note, which continues with
+            //the nearest sample left
+            const int played = low->nsample;
+            PADnoteParameters::Sample &entry =
+                const_cast<PADnoteParameters::Sample &>(lazy->sample[played]);
+            float *dropped = entry.smp.exchange(NULL);
+            sum = 0.0f;
+            for(int i = 0; i < 10; ++i) {
+                low->noteout(outL, outR);
+                for(int j = 0; j < synth->buffersize; ++j)
+                    sum += fabsf(outL[j]);
+            }
+            TS_ASSERT(!low->finished());
+            TS_ASSERT(low->nsample != played);
+            TS_ASSERT(sum > 0.1f);
+            delete low;
+            delete[] dropped;
+
+            delete lazy;
+            PADSampleStore::setConfig(NULL);
+        }
+
+        //All kernels have to match the scalar ones
+        void testInterpolationKernels() {
+            const float *smps = pars->sample[0].smp;
+            const int    size = pars->sample[0].size;
+            TS_NON_NULL(smps);
+            float refl[1000], refr[1000], outl[1000], outr[1000];
+
+            for(int cubic = 0; cubic < 2; ++cubic) {
+                PADInterpolationKernel ref = cubic ? padCubicScalar
+                                                   : padLinearScalar;
+                bool samepos = true;
+                const float error = kernelError([&](SimdLevel level) {
+                    PADInterpolationKernel kernel = cubic
+                        ? padCubicKernel(level) : padLinearKernel(level);
+                    sprng(7);
+                    float maxerr = 0.0f;
+                    for(int t = 0; t < 50; ++t) {
+                        int   l1 = prng() % size, r1 = prng() % size;
+                        float lo1 = RND * 0.999f;
+                        const int   freqhi = prng() % 4;
+                        const float freqlo = RND;
+                        const int   n = 1 + prng() % 1000;
+                        int   l2 = l1, r2 = r1;
+                        float lo2 = lo1;
+                        ref(smps, size, l1, r1, lo1, freqhi, freqlo,
+                            refl, refr, n);
+                        kernel(smps, size, l2, r2, lo2, freqhi, freqlo,
+                               outl, outr, n);
+                        samepos = samepos && l1 == l2 && r1 == r2
+                                  && lo1 == lo2;
+                        maxerr = maxError(maxerr, outl, refl, n);
+                        maxerr = maxError(maxerr, outr, refr, n);
+                    }
+                    return maxerr;
+                });
+                TS_ASSERT(samepos);
+                TS_ASSERT_DELTA(error, 0.0f, 1e-6);
+            }
+        }
+
 #define OUTPUT_PROFILE
 #ifdef OUTPUT_PROFILE
         void testSpeed() {
@@ -294,6 +529,12 @@ int main()
     PadNoteTest test;
     RUN_TEST(testDefaults);
     RUN_TEST(testInitialization);
+    RUN_TEST(testSharedSamples);
+    RUN_TEST(testAbortWait);
+    RUN_TEST(testSampleKeySeed);
+    RUN_TEST(testSampleKeyOctaves);
+    RUN_TEST(testLazySamples);
+    RUN_TEST(testInterpolationKernels);
     RUN_TEST(testSpeed);
     return test_summary();
 }
@@ -13,6 +13,7 @@
 #include "test-suite.h"
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -214,6 +215,48 @@ class PluginTest
             TS_ASSERT(0.1f < sum);
         }
 
+        //Renders a few blocks of notes on 8 parts
+        void renderParts(Master *m, float *l, float *r, int blocks)
+        {
+            for(int npart = 0; npart < 8; ++npart)
+                m->partonoff(npart, 1);
+            sprng(0x5eed);
+            for(int npart = 0; npart < 8; ++npart)
+                m->noteOn(npart, 48 + 3 * npart, 100);
+            for(int i = 0; i < blocks; ++i)
+                m->AudioOut(l + i * synth->buffersize,
+                            r + i * synth->buffersize);
+        }
+
+        //Parts rendered on the worker pool mix to the same output as serially
+        //rendered ones
+        void testParallelRender()
+        {
+            const int blocks = 16;
+            const int n = blocks * synth->buffersize;
+            Config threaded;
+            threaded.cfg.RenderThreads = 4;
+            Master *parallel = new Master(*synth, &threaded);
+
+            float *sl = new float[n], *sr = new float[n];
+            float *pl = new float[n], *pr = new float[n];
+            renderParts(master[1], sl, sr, blocks);
+            renderParts(parallel, pl, pr, blocks);
+
+            float sum = 0.0f;
+            for(int i = 0; i < n; ++i)
+                sum += fabsf(sl[i]);
+            TS_ASSERT(0.1f < sum);
+            TS_ASSERT(!memcmp(sl, pl, n * sizeof(float)));
+            TS_ASSERT(!memcmp(sr, pr, n * sizeof(float)));
+
+            delete parallel;
+            delete[] sl;
+            delete[] sr;
+            delete[] pl;
+            delete[] pr;
+        }
+
         string loadfile(string fname) const
         {
             std::ifstream t(fname.c_str());
@@ -248,5 +291,6 @@ int main()
     PluginTest test;
     RUN_TEST(testInit);
     RUN_TEST(testPanic);
+    RUN_TEST(testParallelRender);
     RUN_TEST(testLoadSave);
 }
@@ -22,5 +22,21 @@ int main()
     TS_ASSERT_DELTA(RND, 0.186133, 0.00001);
     TS_ASSERT_DELTA(RND, 0.286319, 0.00001);
     TS_ASSERT_DELTA(RND, 0.511766, 0.00001);
+
+    //reentrant generator follows the same sequence as the global one
+    prng_t state = 0x1234;
+    TS_ASSERT_DELTA(rnd_r(state), 0.607781, 0.00001);
+    TS_ASSERT_DELTA(rnd_r(state), 0.591761, 0.00001);
+
+    //jump ahead and bulk generation agree with repeated draws
+    prng_t a = 77, b = 77;
+    float buf[37];
+    rnd_fill(a, buf, 37);
+    bool same = true;
+    for(int i = 0; i < 37; ++i)
+        same &= buf[i] == rnd_r(b);
+    TS_ASSERT(same);
+    TS_ASSERT_EQUAL_INT(a, b);
+    TS_ASSERT_EQUAL_INT(prng_skip(77, 37), b);
     return test_summary();
 };
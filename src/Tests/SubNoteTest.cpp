@@ -13,6 +13,7 @@
 
 //Based Upon AdNoteTest.h
 #include "test-suite.h"
+#include "kernel-test.h"
 #include <iostream>
 #include <fstream>
 #include <ctime>
@@ -22,6 +23,8 @@
 #include "../Misc/Util.h"
 #include "../Misc/XMLwrapper.h"
 #include "../Synth/SUBnote.h"
+#include "../Synth/SubFilterBank.h"
+#include "../DSP/SIMD.h"
 #include "../Params/SUBnoteParameters.h"
 #include "../Params/Presets.h"
 #include "../globals.h"
@@ -182,11 +185,94 @@ class SubNoteTest
                    (static_cast<float>(t_off - t_on)) / CLOCKS_PER_SEC, samps);
         }
 #endif
+
+        //a sustained frequency envelope stops recomputing the filters
+        void testLazyCoefficients() {
+            //patches without a tolerance recompute on any change
+            TS_ASSERT_EQUAL_INT(pars->PCoefTolerance, 0);
+            pars->PCoefTolerance = 10; //1 cent
+            pars->PFreqEnvelopeEnabled = 1;
+            SynthParams sp{memory, *controller, *synth, *time, 120, 0,
+                           test_freq_log2, false, prng()};
+            SUBnote *envnote = new SUBnote(pars, sp, w);
+
+            //through the attack of the envelope
+            for(int i = 0; i < 100; ++i)
+                envnote->noteout(outL, outR);
+            const int updates = envnote->coefficientUpdates();
+            TS_ASSERT(updates > 0);
+            TS_ASSERT(updates < 100);
+
+            for(int i = 0; i < 100; ++i)
+                envnote->noteout(outL, outR);
+            TS_ASSERT_EQUAL_INT(envnote->coefficientUpdates(), updates);
+
+            delete envnote;
+        }
+
+        //fills a bank with stable band pass filters which are already ringing
+        void fillBank(float *bank, int numharmonics, int numstages) {
+            sprng(3);
+            for(int n = 0; n < numharmonics; ++n)
+                for(int nph = 0; nph < numstages; ++nph) {
+                    SubFilterLane lane(bank, numstages, n, nph);
+                    const float alpha = 0.001f + 0.01f * RND;
+                    const float cs    = cosf(PI * (n + 1) / (numharmonics + 2));
+                    lane[SUB_B0]  = alpha / (1.0f + alpha);
+                    lane[SUB_B2]  = -alpha / (1.0f + alpha);
+                    lane[SUB_NA1] = 2.0f * cs / (1.0f + alpha);
+                    lane[SUB_NA2] = -(1.0f - alpha) / (1.0f + alpha);
+                    lane[SUB_YN1] = 0.01f * RND;
+                    lane[SUB_YN2] = 0.01f * RND;
+                }
+        }
+
+        //every vector kernel has to match the scalar reference
+        void testFilterBank() {
+            const int numharmonics = 61; //leaves unused lanes
+            const int numstages    = 5;
+            const int buffersize   = 256;
+            const int banksize = subFilterBankSize(numharmonics, numstages);
+
+            float gain[MAX_SUB_HARMONICS] = {0};
+            for(int n = 0; n < numharmonics; ++n)
+                gain[n] = 1.0f / (n + 1);
+            float in[buffersize];
+            prng_t rnd = 1;
+            fillRandom(rnd, in, buffersize, 1.0f);
+
+            float *ref  = new float[banksize];
+            float *bank = new float[banksize];
+            float out[2][buffersize];
+
+            const float error = kernelError([&](SimdLevel level) {
+                SubFilterKernel kernel = subFilterBankKernel(level);
+                memset(ref, 0, banksize * sizeof(float));
+                fillBank(ref, numharmonics, numstages);
+                memcpy(bank, ref, banksize * sizeof(float));
+                float err = 0.0f;
+                for(int block = 0; block < 4; ++block) {
+                    memset(out, 0, sizeof(out));
+                    subFilterBankScalar(ref, numharmonics, numstages, gain, in,
+                                        out[0], buffersize);
+                    kernel(bank, numharmonics, numstages, gain, in, out[1],
+                           buffersize);
+                    err = maxError(err, out[0], out[1], buffersize);
+                }
+                return maxError(err, ref, bank, banksize);
+            });
+            TS_ASSERT_DELTA(error, 0.0f, 1e-6);
+
+            delete[] ref;
+            delete[] bank;
+        }
 };
 
 int main(void)
 {
     SubNoteTest test;
     RUN_TEST(testDefaults);
+    RUN_TEST(testLazyCoefficients);
+    RUN_TEST(testFilterBank);
     return test_summary();
 }
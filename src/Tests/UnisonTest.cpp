@@ -14,6 +14,7 @@
 
 
 #include "test-suite.h"
+#include "kernel-test.h"
 #include <iostream>
 #include <fstream>
 #include <ctime>
@@ -22,6 +23,7 @@
 #include "../Misc/Allocator.h"
 #include "../Synth/ADnote.h"
 #include "../Synth/OscilGen.h"
+#include "../Synth/UnisonKernel.h"
 #include "../Params/Presets.h"
 #include "../Params/FilterParams.h"
 #include "../DSP/FFTwrapper.h"
@@ -53,6 +55,7 @@ class UnisonTest
             synth->buffersize = BUF;
             synth->alias();
             time = new AbsTime(*synth);
+            note = NULL;
 
             memset(outL,0,sizeof(outL));
             memset(outR,0,sizeof(outR));
@@ -177,11 +180,172 @@ class UnisonTest
             TS_ASSERT_DELTA(outL[255], 0.149882f, 0.0001f);
 #endif
         }
+
+        //runs a vector kernel next to its scalar reference for a few blocks,
+        //returns the largest difference and counts the diverging positions
+        float compareKernels(UnisonKernel reference, UnisonKernel kernel,
+                             const float *smps, int size, int &phase_errors) {
+            const int voices = 13; //leaves a remainder for every lane count
+            const int bufs   = BUF - 3; //not a multiple of the vector width
+
+            int   poshi[2][voices], freqhi[voices];
+            float poslo[2][voices], freqlo[voices];
+            float out[2][voices][BUF];
+            float *outp[2][voices];
+            sprng(0x5eed);
+            for(int k = 0; k < voices; ++k) {
+                poshi[0][k] = poshi[1][k] = prng() % size;
+                poslo[0][k] = poslo[1][k] = RND;
+                freqhi[k]   = prng() % 8;
+                freqlo[k]   = RND * 0.999f;
+                outp[0][k]  = out[0][k];
+                outp[1][k]  = out[1][k];
+            }
+
+            float max_error = 0.0f;
+            for(int block = 0; block < 4; ++block) {
+                reference(smps, size, poshi[0], poslo[0], freqhi, freqlo,
+                          outp[0], voices, bufs);
+                kernel(smps, size, poshi[1], poslo[1], freqhi, freqlo,
+                       outp[1], voices, bufs);
+                max_error = maxError(max_error, poslo[0], poslo[1], voices);
+                for(int k = 0; k < voices; ++k) {
+                    phase_errors += poshi[0][k] != poshi[1][k];
+                    max_error = maxError(max_error, out[0][k], out[1][k],
+                                         bufs);
+                }
+            }
+            return max_error;
+        }
+
+        //every vector kernel has to match the scalar reference
+        void testKernels() {
+            const int size = 1024;
+            float smps[size + UNISON_POLYPHASE_TAPS];
+            for(int i = 0; i < size; ++i)
+                smps[i] = sinf(2 * PI * i / size) + 0.1f * (i % 7);
+            for(int i = 0; i < UNISON_POLYPHASE_TAPS; ++i)
+                smps[size + i] = smps[i];
+
+            int phase_errors = 0;
+            const float linear = kernelError([&](SimdLevel level) {
+                return compareKernels(unisonLinearScalar,
+                                      unisonLinearKernel(level), smps, size,
+                                      phase_errors);
+            });
+            const float polyphase = kernelError([&](SimdLevel level) {
+                return compareKernels(unisonPolyphaseScalar,
+                                      unisonPolyphaseKernel(level), smps, size,
+                                      phase_errors);
+            });
+            TS_ASSERT_EQUAL_INT(phase_errors, 0);
+            TS_ASSERT_DELTA(linear, 0.0f, 1e-6);
+            //only the summation order of the dot products differs
+            TS_ASSERT_DELTA(polyphase, 0.0f, 1e-5);
+
+            //the polyphase interpolator passes the table samples through
+            int   poshi  = size - 4, freqhi = 1;
+            float poslo  = 0.0f, freqlo = 0.0f;
+            float out[BUF];
+            float *outp  = out;
+            unisonPolyphase(smps, size, &poshi, &poslo, &freqhi, &freqlo,
+                            &outp, 1, BUF);
+            float max_error = 0.0f;
+            for(int i = 0; i < BUF; ++i)
+                max_error = max(max_error,
+                                fabsf(out[i] - smps[(size - 4 + i) % size]));
+            TS_ASSERT_DELTA(max_error, 0.0f, 1e-5);
+        }
+
+        //the polyphase interpolator passes tones up to 0.42 of the table rate
+        //and rejects their images, from 0.58 on, by 80dB
+        void testPolyphaseStopband() {
+            const int size = 1024, n = 4 * size;
+            float smps[size + UNISON_POLYPHASE_TAPS];
+            float *out  = new float[n];
+            float droop = 0.0f, image = 0.0f;
+            for(int cycles = 16; cycles <= 430; cycles += 13) {
+                for(int i = 0; i < size; ++i)
+                    smps[i] = sinf(2 * PI * cycles * i / size);
+                for(int i = 0; i < UNISON_POLYPHASE_TAPS; ++i)
+                    smps[size + i] = smps[i];
+
+                //four output samples per table sample, one table per n
+                int   poshi = 0, freqhi = 0;
+                float poslo = 0.0f, freqlo = 0.25f;
+                unisonPolyphaseScalar(smps, size, &poshi, &poslo, &freqhi,
+                                      &freqlo, &out, 1, n);
+
+                droop = max(droop, fabsf(1.0f - amplitude(out, n, cycles)));
+                image = max(image, amplitude(out, n, size - cycles));
+            }
+            TS_ASSERT(droop < 1e-3f);
+            TS_ASSERT(image < 1e-4f);
+            delete [] out;
+        }
+
+        //notes read the table at their own step; with the table band
+        //limited to the note the output is the ideal one within -80dB
+        void testPolyphaseNotes() {
+            const int size = 1024, n = 2048;
+            const float samplerate = 44100.0f;
+            float smps[size + UNISON_POLYPHASE_TAPS];
+            float *out = new float[n];
+            double worst = 0.0;
+            for(int midinote = 33; midinote <= 105; midinote += 8) {
+                //sawtooth with all harmonics below nyquist, like OscilGen
+                const float freq = 440.0f * powf(2.0f, (midinote - 69) / 12.0f);
+                const int harmonics = min(size / 2 - 1,
+                                          (int)(0.5f * samplerate / freq));
+                for(int i = 0; i < size; ++i) {
+                    double x = 0.0;
+                    for(int h = 1; h <= harmonics; ++h)
+                        x += sin(2 * M_PI * h * i / size) / h;
+                    smps[i] = x;
+                }
+                for(int i = 0; i < UNISON_POLYPHASE_TAPS; ++i)
+                    smps[size + i] = smps[i];
+
+                //the kernels step in 24 bit fixed point
+                const double step = floor(freq * size / samplerate * 16777216.0)
+                                    / 16777216.0;
+                int   poshi  = 0, freqhi = (int)step;
+                float poslo  = 0.0f, freqlo = step - freqhi;
+                unisonPolyphase(smps, size, &poshi, &poslo, &freqhi, &freqlo,
+                                &out, 1, n);
+
+                double err = 0.0, sig = 0.0;
+                for(int i = 0; i < n; ++i) {
+                    double x = 0.0;
+                    for(int h = 1; h <= harmonics; ++h)
+                        x += sin(2 * M_PI * h * step * i / size) / h;
+                    err += (out[i] - x) * (out[i] - x);
+                    sig += x * x;
+                }
+                worst = max(worst, err / sig);
+            }
+            TS_ASSERT(worst < 1e-8);
+            delete [] out;
+        }
+
+        //amplitude of the tone with the given number of cycles in smps
+        float amplitude(const float *smps, int n, int cycles) {
+            double re = 0.0, im = 0.0;
+            for(int i = 0; i < n; ++i) {
+                const double w = 2 * M_PI * cycles * i / n;
+                re += smps[i] * cos(w);
+                im += smps[i] * sin(w);
+            }
+            return 2.0 * sqrt(re * re + im * im) / n;
+        }
 };
 
 int main()
 {
     UnisonTest test;
     RUN_TEST(testUnison);
+    RUN_TEST(testKernels);
+    RUN_TEST(testPolyphaseStopband);
+    RUN_TEST(testPolyphaseNotes);
     return test_summary();
 }
@@ -0,0 +1,46 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  kernel-test.h - Checks of vector kernels against their scalar reference
+  Copyright (C) 2026 ZynAddSubFX contributors
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <cmath>
+#include "../DSP/SIMD.h"
+#include "../Misc/Util.h"
+
+//Fill buf with len random values in [-scale, scale)
+inline void fillRandom(zyn::prng_t &rnd, float *buf, int len,
+                       float scale = 0.5f)
+{
+    for(int i = 0; i < len; ++i)
+        buf[i] = scale * (2.0f * zyn::rnd_r(rnd) - 1.0f);
+}
+
+//Largest difference between a and b, or err if that is larger
+inline float maxError(float err, const float *a, const float *b, int len)
+{
+    for(int i = 0; i < len; ++i)
+        err = fmaxf(err, fabsf(a[i] - b[i]));
+    return err;
+}
+
+//Largest difference to the scalar reference, as returned by check(level),
+//of the vector kernels this machine can run (0 if there are none)
+template<class Check>
+float kernelError(Check check)
+{
+    const zyn::SimdLevel levels[] = {zyn::SimdLevel::SSE2,
+                                     zyn::SimdLevel::AVX2,
+                                     zyn::SimdLevel::NEON};
+    float err = 0.0f;
+    for(zyn::SimdLevel level : levels)
+        if(zyn::simdSupported(level))
+            err = fmaxf(err, check(level));
+    return err;
+}